@@ -8,25 +8,72 @@
 // Maximum number of points awarded by this program is determined by the
 // constants POINTS[1], POINTS[2]...
 
+#include <algorithm>   // provides sort.
 #include <iostream>    // provides cout.
+#include <cstdio>      // provides remove.
 #include <cstring>     // provides memcpy.
+#include <cmath>       // provides fabs, sqrt.
 #include <cstdlib>     // provides size_t.
+#include <string>
 #include "Sequence.h"  // provides the sequence class with double items.
+#include "SequenceCheckpoint.h"
+#include "SequenceExpr.h"
+#include "SequenceFrozen.h"
+#include "SequenceLog.h"
+#include "SequenceNumeric.h"
+#include "SequencePool.h"
+#include "SequenceProtocol.h"
+#include "SequenceQuantized.h"
+#include "SequenceRle.h"
+#include "SequenceShard.h"
+#include "SequenceShared.h"
+#include "SequenceSorted.h"
+#include "SequenceSparse.h"
+#include "SequenceStats.h"
+#include "SequenceTable.h"
+#include "SequenceView.h"
 using namespace std;
 using namespace CS3358_FA2017;
 
 // Descriptions and points for each of the tests:
-const size_t MANY_TESTS = 7;
+const size_t MANY_TESTS = 34;
 const int POINTS[MANY_TESTS+1] =
 {
-    21,  // Total points for all tests.
+    77,  // Total points for all tests.
      4,  // Test 1 points
      4,  // Test 2 points
      4,  // Test 3 points
      2,  // Test 4 points
      2,  // Test 5 points
      2,  // Test 6 points
-     3  // Test 7 points
+     3, // Test 7 points
+     2, // Test 8 points
+     3, // Test 9 points
+     2, // Test 10 points
+     2, // Test 11 points
+     2, // Test 12 points
+     2, // Test 13 points
+     2, // Test 14 points
+     2, // Test 15 points
+     2, // Test 16 points
+     2, // Test 17 points
+     2, // Test 18 points
+     3, // Test 19 points
+     2, // Test 20 points
+     2, // Test 21 points
+     2, // Test 22 points
+     2, // Test 23 points
+     2, // Test 24 points
+     2, // Test 25 points
+     2, // Test 26 points
+     2, // Test 27 points
+     2, // Test 28 points
+     2, // Test 29 points
+     2, // Test 30 points
+     2, // Test 31 points
+     2, // Test 32 points
+     2, // Test 33 points
+     2  // Test 34 points
 };
 const char DESCRIPTION[MANY_TESTS+1][256] =
 {
@@ -37,9 +84,46 @@ const char DESCRIPTION[MANY_TESTS+1][256] =
     "Testing the resize member function",
     "Testing the copy constructor",
     "Testing the assignment operator",
-    "Testing insert/attach when current DEFAULT_CAPACITY exceeded"
+    "Testing insert/attach when current DEFAULT_CAPACITY exceeded",
+    "Testing insert/attach into the last free spot of the array",
+    "Testing that an assignment keeps the target's own options",
+    "Testing the sequence_view adapters",
+    "Testing element-wise arithmetic with expression templates",
+    "Testing the vector kernels dot, axpy, scal, nrm2 and asum",
+    "Testing the inclusive and exclusive prefix-sum scans",
+    "Testing the rolling-window aggregates",
+    "Testing the histogram and t-digest quantile sketches",
+    "Testing the top_k, bottom_k and nth selection functions",
+    "Testing the k-way merge of sorted sequences",
+    "Testing the set operations on sorted sequences",
+    "Testing seek_to with a hash index kept up to date under edits",
+    "Testing contains with a Bloom filter",
+    "Testing frozen_sequence search in Eytzinger layout",
+    "Testing interpolation_seek and gallop_seek on sorted sequences",
+    "Testing quantized_sequence in its four storage modes",
+    "Testing rle_sequence under random edits",
+    "Testing sparse_sequence under random edits",
+    "Testing sequence_table rows",
+    "Testing sequence_pool and sequences using one",
+    "Testing lazy removal against an array",
+    "Testing item handles under random edits",
+    "Testing checkpoints saved during random edits",
+    "Testing recovery of a logged_sequence",
+    "Testing a shared_sequence writer and reader",
+    "Testing the command protocol against an array",
+    "Testing sharded_sequence against an array"
 };
 
+// The checkpoint keeps_options and test30 save (and then remove).
+const char CHECKPOINT_PATH[] = "a3a_test.ckpt";
+
+// The log and snapshots test31 writes (and then removes).
+const char LOG_PATH[] = "a3a_test_wal";
+
+// The shared memory test32 makes, and a name it never makes.
+const char SHARED_NAME[] = "/a3a_test_shm";
+const char MISSING_NAME[] = "/a3a_test_missing";
+
 
 // **************************************************************************
 // bool test_basic(const sequence& test, size_t s, bool has_cursor)
@@ -724,6 +808,2696 @@ int test7()
     return POINTS[7];
 }
 
+
+// **************************************************************************
+// int test8()
+//   Performs tests of insert and attach when the array has exactly one free
+//   spot left, which must not be written past.
+//   Returns POINTS[8] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test8()
+{
+    // The arrays of two sequences made from one pool lie side by side,
+    // so writing one spot past the end of either array changes the first
+    // item of the other.
+    sequence_pool pool;
+    sequence first(pool, 8), second(pool, 8);
+    double items1[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    double items2[8] = { 1, 1.5, 2, 3, 4, 5, 6, 7 };
+    size_t i;
+
+    cout << "Using attach to put 1 through 8 in two sequences of capacity 8,\n";
+    cout << "then removing the 8 from each, which leaves one free spot." << endl;
+    for (i = 1; i <= 8; i++)
+    {
+        first.attach(i);
+        second.attach(i);
+    }
+    first.remove_current();
+    second.remove_current();
+
+    cout << "Inserting 0 at the front of the first sequence, and attaching\n";
+    cout << "1.5 after the 1 of the second." << endl;
+    first.start();
+    first.insert(0);
+    second.start();
+    second.attach(1.5);
+    if (!correct(first, 8, 0, items1)) return 0;
+    if (!correct(second, 8, 1, items2)) return 0;
+
+    // All tests passed
+    cout << "All tests of this eighth function have been passed." << endl;
+    return POINTS[8];
+}
+
+
+// **************************************************************************
+// void remove_checkpoint()
+//   Removes the files of the checkpoint at CHECKPOINT_PATH, if any.
+// **************************************************************************
+void remove_checkpoint()
+{
+    string path = CHECKPOINT_PATH;
+
+    remove(path.c_str());
+    remove((path + ".0").c_str());
+    remove((path + ".1").c_str());
+    remove((path + ".tmp").c_str());
+}
+
+
+// **************************************************************************
+// bool keeps_options(sequence& test)
+//   Precondition: test has items, and has had enable_filter,
+//   enable_handles and enable_checkpoints called on it.
+//   Postcondition: A return value of true indicates that test still keeps
+//   a filter, handles and checkpoints. (A sequence that has lost them
+//   fails the assert in filter_false_positive_rate, current_handle or
+//   save_checkpoint instead.) The first item
+//   of test is its current item, and its checkpoints are started afresh.
+// **************************************************************************
+bool keeps_options(sequence& test)
+{
+    bool answer;
+    string path = CHECKPOINT_PATH;
+
+    cout << "Checking that it still keeps a filter, handles and checkpoints";
+    cout << " ... ";
+    cout.flush();
+    test.start();
+    sequence::item_handle handle = test.current_handle();
+    test.advance();
+    answer = test.seek_handle(handle) && test.save_checkpoint(path.c_str())
+        && test.filter_false_positive_rate() < 0.5;
+
+    // The files are removed, so the next save has to start afresh.
+    remove_checkpoint();
+    test.disable_checkpoints();
+    test.enable_checkpoints();
+    cout << (answer ? "Passed." : "Failed.") << endl;
+
+    return answer;
+}
+
+
+// **************************************************************************
+// int test9()
+//   Performs a test of assigning a plain sequence to one with a filter,
+//   handles and checkpoints, checking that it keeps them afterwards. (The
+//   functions that write their result into a sequence are checked the
+//   same way by the tests of those functions.)
+//   Returns POINTS[9] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test9()
+{
+    sequence test;
+    sequence other;
+    double items6[4] = { 1, 5, 6, 7 };
+    double items7[2] = { 1, 6 };
+    size_t i;
+
+    test.enable_filter();
+    test.enable_handles();
+    test.enable_checkpoints();
+
+    cout << "Putting 1, 5, 6, 7 in a sequence with a filter, handles and\n";
+    cout << "checkpoints." << endl;
+    for (i = 0; i < 4; i++)
+        test.attach(items6[i]);
+    test.start();
+    if (!correct(test, 4, 0, items6)) return 0;
+
+    cout << "Assigning it a sequence holding 1 and 6, which keeps none\n";
+    cout << "of these options." << endl;
+    other.attach(1);
+    other.attach(6);
+    other.start();
+    test = other;
+    if (!correct(test, 2, 0, items7)) return 0;
+    if (!keeps_options(test)) return 0;
+
+    // All tests passed
+    cout << "All tests of this ninth function have been passed." << endl;
+    return POINTS[9];
+}
+
+// **************************************************************************
+// bool check(const char message[], bool answer)
+//   Postcondition: message has been printed to cout, followed by whether
+//   answer is true. The return value is answer.
+// **************************************************************************
+bool check(const char message[], bool answer)
+{
+    cout << message << " ... ";
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    return answer;
+}
+
+
+// **************************************************************************
+// bool is_even(const double& entry), double square(const double& entry)
+//   A filter and a map for the view tests.
+// **************************************************************************
+bool is_even(const double& entry)
+{
+    return (long(entry) % 2 == 0);
+}
+
+double square(const double& entry)
+{
+    return entry * entry;
+}
+
+
+// **************************************************************************
+// int test10()
+//   Performs tests of the sequence_view adapters, comparing each view with
+//   the items a plain loop over the source picks out.
+//   Returns POINTS[10] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test10()
+{
+    sequence source;
+    sequence empty;
+    sequence dest;
+    sequence test;
+    double items[20];
+    double items1[4] = { 4, 3, 2, 1 };
+    double total;
+    size_t many;
+    size_t i;
+
+    cout << "Putting 1 through 20 in a sequence, and moving its cursor to\n";
+    cout << "the 5 (views don't use the source's cursor)." << endl;
+    for (i = 1; i <= 20; i++)
+        source.attach(i);
+    source.start();
+    for (i = 1; i < 5; i++)
+        source.advance();
+
+    cout << "A view of the whole sequence." << endl;
+    sequence_view whole(source);
+    for (i = 0, total = 0; i < 20; i++)
+    {
+        items[i] = i + 1;
+        total += i + 1;
+    }
+    if (!check("Testing span(), size() and sum()", whole.span() == 20
+               && whole.size() == 20 && whole.sum() == total)) return 0;
+    whole.materialize(dest);
+    if (!correct(dest, 20, 0, items)) return 0;
+
+    cout << "slice(3, 9): items [3] through [8]." << endl;
+    for (i = 3; i < 9; i++)
+        items[i-3] = i + 1;
+    whole.slice(3, 9).materialize(dest);
+    if (!correct(dest, 6, 0, items)) return 0;
+
+    cout << "stride(3): items [0], [3], [6], ..." << endl;
+    for (i = 0, many = 0; i < 20; i += 3)
+        items[many++] = i + 1;
+    whole.stride(3).materialize(dest);
+    if (!correct(dest, many, 0, items)) return 0;
+
+    cout << "reverse(): items [19] down to [0]." << endl;
+    for (i = 0; i < 20; i++)
+        items[i] = 20 - i;
+    whole.reverse().materialize(dest);
+    if (!correct(dest, 20, 0, items)) return 0;
+
+    cout << "slice(2, 12).stride(4).reverse(): items [10], [6] and [2].";
+    cout << endl;
+    for (i = 2, many = 0; i < 12; i += 4)
+        many++;
+    for (i = 2; i < 12; i += 4)
+        items[--many] = i + 1;
+    whole.slice(2, 12).stride(4).reverse().materialize(dest);
+    if (!correct(dest, 3, 0, items)) return 0;
+
+    cout << "filter(is_even).map(square): the squares of the even items.";
+    cout << endl;
+    for (i = 1, many = 0, total = 0; i <= 20; i++)
+        if (i % 2 == 0)
+        {
+            items[many++] = double(i) * i;
+            total += double(i) * i;
+        }
+    sequence_view squares = whole.filter(is_even).map(square);
+    if (!check("Testing span(), size() and sum()", squares.span() == 20
+               && squares.size() == many && squares.sum() == total))
+        return 0;
+    squares.materialize(dest);
+    if (!correct(dest, many, 0, items)) return 0;
+
+    cout << "Stepping through it with start(), advance() and current()";
+    cout << endl;
+    for (squares.start(), i = 0; squares.is_item() && i < many;
+         squares.advance(), i++)
+        if (squares.current() != items[i])
+            break;
+    if (!check("Testing that it visits the same items",
+               i == many && !squares.is_item())) return 0;
+
+    cout << "Edge cases: an empty slice, a stride longer than the view, and\n";
+    cout << "a view of an empty sequence." << endl;
+    sequence_view none(empty);
+    none.start();
+    if (!check("Testing the empty slice", whole.slice(5, 5).size() == 0
+               && whole.slice(5, 5).sum() == 0)) return 0;
+    if (!check("Testing the long stride", whole.stride(50).size() == 1
+               && whole.stride(50).sum() == 1)) return 0;
+    if (!check("Testing the empty view", none.size() == 0
+               && none.sum() == 0 && !none.is_item())) return 0;
+    none.materialize(dest);
+    if (!correct(dest, 0, 0, items)) return 0;
+    if (!check("Testing that the source's cursor didn't move",
+               source.is_item() && source.current() == 5)) return 0;
+
+    cout << "Putting 1, 2, 3, 4 in a sequence with a filter, handles and\n";
+    cout << "checkpoints, then writing a reversed view of it into itself.";
+    cout << endl;
+    test.enable_filter();
+    test.enable_handles();
+    test.enable_checkpoints();
+    for (i = 1; i <= 4; i++)
+        test.attach(i);
+    sequence_view(test).reverse().materialize(test);
+    if (!correct(test, 4, 0, items1)) return 0;
+    if (!keeps_options(test)) return 0;
+
+    // All tests passed
+    cout << "All tests of this tenth function have been passed." << endl;
+    return POINTS[10];
+}
+
+// **************************************************************************
+// int test11()
+//   Performs tests of the element-wise arithmetic of SequenceExpr.h,
+//   comparing each result with the same arithmetic done in a plain loop.
+//   Returns POINTS[11] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test11()
+{
+    const size_t MANY = 8;
+    sequence x, y, z;
+    sequence empty1, empty2;
+    double xs[MANY], ys[MANY];
+    double items[MANY];
+    double items2[4] = { 9, 7, 5, 3 };
+    size_t i;
+
+    cout << "Putting x[i] = i + 1 and y[i] = 10 - i / 2 in two sequences of\n";
+    cout << MANY << " items." << endl;
+    for (i = 0; i < MANY; i++)
+    {
+        xs[i] = i + 1;
+        ys[i] = 10 - i / 2.0;
+        x.attach(xs[i]);
+        y.attach(ys[i]);
+    }
+
+    cout << "z = x + y" << endl;
+    for (i = 0; i < MANY; i++)
+        items[i] = xs[i] + ys[i];
+    z = x + y;
+    if (!correct(z, MANY, 0, items)) return 0;
+
+    cout << "z = x - y" << endl;
+    for (i = 0; i < MANY; i++)
+        items[i] = xs[i] - ys[i];
+    z = x - y;
+    if (!correct(z, MANY, 0, items)) return 0;
+
+    cout << "z = x * y / 4" << endl;
+    for (i = 0; i < MANY; i++)
+        items[i] = xs[i] * ys[i] / 4;
+    z = x * y / 4.0;
+    if (!correct(z, MANY, 0, items)) return 0;
+
+    cout << "z = 3 - x / y" << endl;
+    for (i = 0; i < MANY; i++)
+        items[i] = 3 - xs[i] / ys[i];
+    z = 3.0 - x / y;
+    if (!correct(z, MANY, 0, items)) return 0;
+
+    cout << "z = -(2 * x + y * y) - 1" << endl;
+    for (i = 0; i < MANY; i++)
+        items[i] = -(2 * xs[i] + ys[i] * ys[i]) - 1;
+    z = -(2.0 * x + y * y) - 1.0;
+    if (!correct(z, MANY, 0, items)) return 0;
+
+    cout << "A new sequence constructed from x * 2 + y" << endl;
+    for (i = 0; i < MANY; i++)
+        items[i] = xs[i] * 2 + ys[i];
+    sequence made(x * 2.0 + y);
+    if (!correct(made, MANY, 0, items)) return 0;
+
+    cout << "x = x * x, which reads and writes x in the same loop" << endl;
+    for (i = 0; i < MANY; i++)
+        items[i] = xs[i] * xs[i];
+    x = x * x;
+    if (!correct(x, MANY, 0, items)) return 0;
+
+    cout << "z = empty1 + empty2, which has no items" << endl;
+    z = empty1 + empty2;
+    if (!correct(z, 0, 0, items)) return 0;
+
+    cout << "Putting 4, 3, 2, 1 in a sequence with a filter, handles and\n";
+    cout << "checkpoints, and assigning it the expression 2 * itself + 1.";
+    cout << endl;
+    z.enable_filter();
+    z.enable_handles();
+    z.enable_checkpoints();
+    for (i = 4; i >= 1; i--)
+        z.attach(i);
+    z = 2.0 * z + 1.0;
+    if (!correct(z, 4, 0, items2)) return 0;
+    if (!keeps_options(z)) return 0;
+
+    // All tests passed
+    cout << "All tests of this eleventh function have been passed." << endl;
+    return POINTS[11];
+}
+
+// **************************************************************************
+// int test12()
+//   Performs tests of the vector kernels dot, axpy, scal, nrm2 and asum,
+//   comparing each with a plain loop over the items.
+//   Returns POINTS[12] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test12()
+{
+    const size_t MANY = 7;  // not a multiple of the kernels' unrolling
+    sequence x, y, empty, big, tiny;
+    double xs[MANY], ys[MANY];
+    double items[MANY];
+    double expected;
+    size_t i;
+
+    cout << "Putting x[i] = i + 1 and y[i] = (i % 3) - 1 in two sequences of\n";
+    cout << MANY << " items, with the current item of y at y[2]." << endl;
+    for (i = 0; i < MANY; i++)
+    {
+        xs[i] = i + 1;
+        ys[i] = double(i % 3) - 1;
+        x.attach(xs[i]);
+        y.attach(ys[i]);
+    }
+    y.start();
+    y.advance();
+    y.advance();
+
+    for (i = 0, expected = 0; i < MANY; i++)
+        expected += xs[i] * ys[i];
+    if (!check("Testing dot(x, y)", dot(x, y) == expected)) return 0;
+    for (i = 0, expected = 0; i < MANY; i++)
+        expected += xs[i] * xs[i];
+    if (!check("Testing nrm2(x)", nrm2(x) == sqrt(expected))) return 0;
+    for (i = 0, expected = 0; i < MANY; i++)
+        expected += fabs(ys[i]);
+    if (!check("Testing asum(y)", asum(y) == expected)) return 0;
+
+    cout << "axpy(3, x, y): y[i] becomes 3 * x[i] + y[i]." << endl;
+    for (i = 0; i < MANY; i++)
+        items[i] = ys[i] = 3 * xs[i] + ys[i];
+    axpy(3, x, y);
+    if (!correct(y, MANY, 2, items)) return 0;
+
+    cout << "scal(-2, y): y[i] becomes -2 * y[i]." << endl;
+    for (i = 0; i < MANY; i++)
+        items[i] = ys[i] = -2 * ys[i];
+    y.start();
+    scal(-2, y);
+    if (!correct(y, MANY, 0, items)) return 0;
+
+    cout << "axpy(1, y, y): y and x may be the same sequence." << endl;
+    for (i = 0; i < MANY; i++)
+        items[i] = 2 * ys[i];
+    y.start();
+    axpy(1, y, y);
+    if (!correct(y, MANY, 0, items)) return 0;
+
+    cout << "Edge cases: empty sequences, and nrm2 of items whose squares\n";
+    cout << "overflow or underflow." << endl;
+    big.attach(3e200);
+    big.attach(-4e200);
+    tiny.attach(3e-200);
+    tiny.attach(4e-200);
+    if (!check("Testing the empty sequences", dot(empty, empty) == 0
+               && nrm2(empty) == 0 && asum(empty) == 0)) return 0;
+    if (!check("Testing nrm2 of 3e200, -4e200",
+               fabs(nrm2(big) - 5e200) <= 1e-12 * 5e200)) return 0;
+    if (!check("Testing nrm2 of 3e-200, 4e-200",
+               fabs(nrm2(tiny) - 5e-200) <= 1e-12 * 5e-200)) return 0;
+
+    // All tests passed
+    cout << "All tests of this twelfth function have been passed." << endl;
+    return POINTS[12];
+}
+
+// **************************************************************************
+// int test13()
+//   Performs tests of inclusive_scan and exclusive_scan, comparing each
+//   with running sums kept in a plain loop.
+//   Returns POINTS[13] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test13()
+{
+    const size_t MANY = 50;
+    sequence source, dest, empty;
+    double items[MANY], sources[MANY];
+    double total;
+    size_t i;
+
+    cout << "Putting " << MANY << " items, (i * 7) % 11 - 5, in a sequence.";
+    cout << endl;
+    for (i = 0; i < MANY; i++)
+    {
+        sources[i] = double((i * 7) % 11) - 5;
+        source.attach(sources[i]);
+    }
+
+    cout << "inclusive_scan into another sequence." << endl;
+    for (i = 0, total = 0; i < MANY; i++)
+    {
+        total += sources[i];
+        items[i] = total;
+    }
+    inclusive_scan(source, dest);
+    if (!correct(dest, MANY, 0, items)) return 0;
+
+    cout << "exclusive_scan, starting from 100, into a sequence that was\n";
+    cout << "resized beforehand." << endl;
+    for (i = 0, total = 100; i < MANY; i++)
+    {
+        items[i] = total;
+        total += sources[i];
+    }
+    dest = empty;
+    dest.resize(MANY);
+    exclusive_scan(source, dest, 100);
+    if (!correct(dest, MANY, 0, items)) return 0;
+
+    cout << "inclusive_scan of a sequence with a filter, handles and\n";
+    cout << "checkpoints into itself." << endl;
+    source.enable_filter();
+    source.enable_handles();
+    source.enable_checkpoints();
+    for (i = 0, total = 0; i < MANY; i++)
+    {
+        total += sources[i];
+        items[i] = total;
+    }
+    inclusive_scan(source, source);
+    if (!correct(source, MANY, 0, items)) return 0;
+    if (!keeps_options(source)) return 0;
+
+    cout << "Edge cases: scans of an empty sequence, and of one item." << endl;
+    inclusive_scan(empty, dest);
+    if (!correct(dest, 0, 0, items)) return 0;
+    exclusive_scan(empty, dest, 5);
+    if (!correct(dest, 0, 0, items)) return 0;
+    dest.attach(8);
+    exclusive_scan(dest, dest, 5);
+    items[0] = 5;
+    if (!correct(dest, 1, 0, items)) return 0;
+
+    // All tests passed
+    cout << "All tests of this thirteenth function have been passed." << endl;
+    return POINTS[13];
+}
+
+// **************************************************************************
+// bool near(sequence test, size_t s, double items[])
+//   Postcondition: A return value of true indicates that test has s items,
+//   each within a relative error of 1e-9 of the matching item of items
+//   (for results that a plain loop rounds differently). A description of
+//   the test result is printed to cout.
+// **************************************************************************
+bool near(sequence test, size_t s, double items[])
+{
+    size_t i;
+    bool answer = (test.size() == s);
+
+    cout << "Testing that it has " << s << " items, each close to the ";
+    cout << "expected one ... ";
+    for (test.start(), i = 0; answer && i < s; test.advance(), i++)
+        answer = fabs(test.current() - items[i]) <= 1e-9 * (1 + fabs(items[i]));
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    return answer;
+}
+
+
+// **************************************************************************
+// int test14()
+//   Performs tests of the rolling-window aggregates, comparing each window
+//   with its mean, minimum, maximum or standard deviation found by a plain
+//   loop over the window.
+//   Returns POINTS[14] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test14()
+{
+    const size_t MANY = 30;
+    const size_t WINDOWS[4] = { 2, 4, 7, MANY };
+    sequence source, dest;
+    double sources[MANY];
+    double means[MANY], mins[MANY], maxes[MANY], stddevs[MANY];
+    double items3[2] = { 7, 5 };
+    size_t w, i, j, window, many;
+
+    cout << "Putting " << MANY << " items, (i * 13) % 17 + i / 4, in a ";
+    cout << "sequence." << endl;
+    for (i = 0; i < MANY; i++)
+    {
+        sources[i] = double((i * 13) % 17) + i / 4.0;
+        source.attach(sources[i]);
+    }
+
+    for (w = 0; w < 4; w++)
+    {
+        window = WINDOWS[w];
+        many = MANY - window + 1;
+        for (i = 0; i < many; i++)
+        {
+            double sum = 0, squares = 0;
+            mins[i] = maxes[i] = sources[i];
+            for (j = i; j < i + window; j++)
+            {
+                sum += sources[j];
+                if (sources[j] < mins[i]) mins[i] = sources[j];
+                if (sources[j] > maxes[i]) maxes[i] = sources[j];
+            }
+            means[i] = sum / window;
+            for (j = i; j < i + window; j++)
+                squares += (sources[j] - means[i]) * (sources[j] - means[i]);
+            stddevs[i] = sqrt(squares / (window - 1));
+        }
+
+        cout << "Rolling aggregates over windows of " << window << " items.";
+        cout << endl;
+        rolling_mean(source, window, dest);
+        if (!near(dest, many, means)) return 0;
+        rolling_min(source, window, dest);
+        if (!correct(dest, many, 0, mins)) return 0;
+        rolling_max(source, window, dest);
+        if (!correct(dest, many, 0, maxes)) return 0;
+        rolling_stddev(source, window, dest);
+        if (!near(dest, many, stddevs)) return 0;
+    }
+
+    cout << "A window of 1 item leaves the items as they are." << endl;
+    rolling_min(source, 1, dest);
+    if (!correct(dest, MANY, 0, sources)) return 0;
+
+    cout << "Windows longer than the sequence (even far longer) give no\n";
+    cout << "items." << endl;
+    rolling_mean(source, MANY + 1, dest);
+    if (!correct(dest, 0, 0, sources)) return 0;
+    rolling_min(source, size_t(-1) / 2, dest);
+    if (!correct(dest, 0, 0, sources)) return 0;
+    rolling_max(source, size_t(-1) / 2, dest);
+    if (!correct(dest, 0, 0, sources)) return 0;
+    rolling_stddev(source, size_t(-1) / 2, dest);
+    if (!correct(dest, 0, 0, sources)) return 0;
+
+    cout << "Putting 9, 7, 5, 3 in a sequence with a filter, handles and\n";
+    cout << "checkpoints, and writing its rolling mean over 3 items into\n";
+    cout << "itself." << endl;
+    dest = sequence();
+    dest.enable_filter();
+    dest.enable_handles();
+    dest.enable_checkpoints();
+    for (i = 0; i < 4; i++)
+        dest.attach(9 - 2.0 * i);
+    rolling_mean(dest, 3, dest);
+    if (!correct(dest, 2, 0, items3)) return 0;
+    if (!keeps_options(dest)) return 0;
+
+    // All tests passed
+    cout << "All tests of this fourteenth function have been passed." << endl;
+    return POINTS[14];
+}
+
+// **************************************************************************
+// int test15()
+//   Performs tests of the histogram and tdigest sketches and of
+//   exact_quantile, comparing counts and quantiles with those found from
+//   the items by plain loops.
+//   Returns POINTS[15] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test15()
+{
+    const size_t MANY = 2000;
+    const double QS[7] = { 0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999 };
+    sequence source, first_half, second_half;
+    double sorted[MANY];
+    size_t counts[16];
+    size_t over;
+    double exact, position;
+    size_t i, k;
+    bool answer;
+
+    cout << "Putting " << MANY << " items, the numbers 0, 0.05, 0.1, ... ";
+    cout << "99.95 in a\nscrambled order, in a sequence." << endl;
+    for (i = 0; i < MANY; i++)
+    {
+        double entry = ((i * 7919) % MANY) / 20.0;
+        source.attach(entry);
+        if (i < MANY / 2)
+            first_half.attach(entry);
+        else
+            second_half.attach(entry);
+        sorted[i] = entry;
+    }
+    sort(sorted, sorted + MANY);
+
+    cout << "exact_quantile, against interpolating in the sorted items.";
+    cout << endl;
+    for (k = 0, answer = true; k < 7; k++)
+    {
+        position = QS[k] * (MANY - 1);
+        i = size_t(position);
+        exact = sorted[i] + (position - i) * (sorted[i+1] - sorted[i]);
+        answer = answer && fabs(exact_quantile(source, QS[k]) - exact) < 1e-9;
+    }
+    if (!check("Testing seven quantiles", answer
+               && exact_quantile(source, 0) == sorted[0]
+               && exact_quantile(source, 1) == sorted[MANY-1])) return 0;
+
+    cout << "A histogram of 16 buckets over [0, 80), made from the two\n";
+    cout << "halves of the sequence and merged, plus a NaN." << endl;
+    histogram whole(0, 80, 16);
+    histogram part(0, 80, 16);
+    whole.add(first_half);
+    part.add(second_half);
+    part.add(sqrt(-1.0));
+    whole.merge(part);
+    for (k = 0; k < 16; k++)
+        counts[k] = 0;
+    for (i = 0, over = 0; i < MANY; i++)
+        if (sorted[i] >= 80)
+            over++;
+        else
+            counts[size_t(sorted[i] / 5)]++;
+    answer = (whole.count() == MANY && whole.bucket_count() == 16
+              && whole.underflow() == 0 && whole.overflow() == over);
+    for (k = 0; k < 16; k++)
+        answer = answer && whole.bucket(k) == counts[k];
+    if (!check("Testing count(), the buckets, underflow() and overflow()",
+               answer)) return 0;
+    for (k = 0, answer = true; k < 7; k++)
+    {
+        exact = exact_quantile(source, QS[k]);
+        if (exact < 80)
+            answer = answer && fabs(whole.quantile(QS[k]) - exact) <= 5;
+    }
+    if (!check("Testing that quantiles in range are within a bucket width",
+               answer)) return 0;
+
+    cout << "A histogram over [-50, 50), whose lowest five buckets are\n";
+    cout << "empty." << endl;
+    histogram wide(-50, 50, 10);
+    wide.add(source);
+    if (!check("Testing that quantile(0) is within a bucket of the smallest",
+               fabs(wide.quantile(0) - sorted[0]) <= 10)) return 0;
+
+    cout << "A t-digest made from the two halves of the sequence and\n";
+    cout << "merged, plus a NaN." << endl;
+    tdigest digest;
+    tdigest other;
+    digest.add(first_half);
+    other.add(second_half);
+    other.add(sqrt(-1.0));
+    digest.merge(other);
+    if (!check("Testing count() and centroid_count()",
+               digest.count() == MANY && digest.centroid_count() <= 100))
+        return 0;
+    if (!check("Testing that quantile(0) and quantile(1) are exact",
+               digest.quantile(0) == sorted[0]
+               && digest.quantile(1) == sorted[MANY-1])) return 0;
+    for (k = 0, answer = true; k < 7; k++)
+    {
+        exact = exact_quantile(source, QS[k]);
+        answer = answer && fabs(digest.quantile(QS[k]) - exact) <= 0.5;
+    }
+    if (!check("Testing that quantiles are within 0.5 of exact", answer))
+        return 0;
+
+    cout << "Edge cases: t-digests of 1 through 6 items, with the fewest\n";
+    cout << "centroids allowed." << endl;
+    for (k = 1, answer = true; k <= 6; k++)
+    {
+        tdigest small(10);
+        for (i = 1; i <= k; i++)
+            small.add(i);
+        answer = answer && small.quantile(0) == 1 && small.quantile(1) == k
+            && small.quantile(0.5) >= 1 && small.quantile(0.5) <= k;
+    }
+    if (!check("Testing that quantile(0) and quantile(1) are exact", answer))
+        return 0;
+
+    // All tests passed
+    cout << "All tests of this fifteenth function have been passed." << endl;
+    return POINTS[15];
+}
+
+// **************************************************************************
+// int test16()
+//   Performs tests of top_k, bottom_k and nth, comparing each with the
+//   items sorted by sort.
+//   Returns POINTS[16] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test16()
+{
+    const size_t MANY = 100;
+    const size_t KS[5] = { 0, 1, 10, 60, MANY };
+    sequence source, dest;
+    double sources[MANY], sorted[MANY];
+    double items[MANY];
+    double items3[2] = { 7, 5 };
+    double items4[2] = { 5, 7 };
+    size_t i, k;
+    bool answer;
+
+    cout << "Putting " << MANY << " items, (i * 37) % 50 (so each one twice),";
+    cout << " in a\nsequence." << endl;
+    for (i = 0; i < MANY; i++)
+    {
+        sources[i] = sorted[i] = double((i * 37) % 50);
+        source.attach(sources[i]);
+    }
+    sort(sorted, sorted + MANY);
+
+    for (k = 0; k < 5; k++)
+    {
+        cout << "top_k and bottom_k with k = " << KS[k] << "." << endl;
+        for (i = 0; i < KS[k]; i++)
+            items[i] = sorted[MANY-1-i];
+        top_k(source, KS[k], dest);
+        if (!correct(dest, KS[k], 0, items)) return 0;
+        bottom_k(source, KS[k], dest);
+        if (!correct(dest, KS[k], 0, sorted)) return 0;
+    }
+
+    cout << "k larger than the sequence gives all of its items." << endl;
+    bottom_k(source, 1000, dest);
+    if (!correct(dest, MANY, 0, sorted)) return 0;
+
+    for (i = 0, answer = true; i < MANY; i++)
+        answer = answer && nth(source, i) == sorted[i];
+    if (!check("Testing nth for every position", answer)) return 0;
+    if (!correct(source, MANY, MANY-1, sources)) return 0;
+
+    cout << "Putting 7, 5 in a sequence with a filter, handles and\n";
+    cout << "checkpoints, and writing its bottom 1000 items (that is, all\n";
+    cout << "of them, in increasing order) into itself." << endl;
+    dest = sequence();
+    dest.enable_filter();
+    dest.enable_handles();
+    dest.enable_checkpoints();
+    for (i = 0; i < 2; i++)
+        dest.attach(items3[i]);
+    bottom_k(dest, 1000, dest);
+    if (!correct(dest, 2, 0, items4)) return 0;
+    if (!keeps_options(dest)) return 0;
+
+    // All tests passed
+    cout << "All tests of this sixteenth function have been passed." << endl;
+    return POINTS[16];
+}
+
+// **************************************************************************
+// int test17()
+//   Performs tests of merge_sorted, comparing each merge with all of the
+//   inputs' items put together and sorted by sort.
+//   Returns POINTS[17] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test17()
+{
+    const size_t INPUTS = 5;
+    const size_t MANY = 1 + 2 + 40 + 7 + 0;
+    sequence lists[INPUTS];
+    const sequence* inputs[INPUTS];
+    sequence dest, empty, test, other;
+    double items[MANY];
+    double items4[2] = { 5, 7 };
+    double items5[3] = { 5, 6, 7 };
+    size_t sizes[INPUTS] = { 1, 2, 40, 7, 0 };
+    size_t i, j, many;
+
+    cout << "Putting sorted runs of 1, 2, 40, 7 and 0 items, with items\n";
+    cout << "repeated within and between runs, in five sequences." << endl;
+    for (i = 0, many = 0; i < INPUTS; i++)
+    {
+        inputs[i] = &lists[i];
+        for (j = 0; j < sizes[i]; j++)
+        {
+            items[many] = double((j * (i + 2)) / 3);
+            lists[i].attach(items[many++]);
+        }
+    }
+    sort(items, items + MANY);
+
+    cout << "Merging all five." << endl;
+    merge_sorted(inputs, INPUTS, dest);
+    if (!correct(dest, MANY, 0, items)) return 0;
+
+    cout << "Merging only the third (a merge of one input is a copy)." << endl;
+    for (j = 0; j < 40; j++)
+        items[j] = double((j * 4) / 3);
+    merge_sorted(inputs + 2, 1, dest);
+    if (!correct(dest, 40, 0, items)) return 0;
+
+    cout << "Merging the last (empty) input with an empty sequence." << endl;
+    inputs[0] = &empty;
+    merge_sorted(inputs + 4, 1, dest);
+    if (!correct(dest, 0, 0, items)) return 0;
+    merge_sorted(inputs, 1, dest);
+    if (!correct(dest, 0, 0, items)) return 0;
+
+    cout << "Putting 5, 7 in a sequence with a filter, handles and\n";
+    cout << "checkpoints, and merging it with a sequence holding 6 into\n";
+    cout << "itself." << endl;
+    test.enable_filter();
+    test.enable_handles();
+    test.enable_checkpoints();
+    for (i = 0; i < 2; i++)
+        test.attach(items4[i]);
+    other.attach(6);
+    inputs[0] = &test;
+    inputs[1] = &other;
+    merge_sorted(inputs, 2, test);
+    if (!correct(test, 3, 0, items5)) return 0;
+    if (!keeps_options(test)) return 0;
+
+    // All tests passed
+    cout << "All tests of this seventeenth function have been passed." << endl;
+    return POINTS[17];
+}
+
+// **************************************************************************
+// size_t counted(const double items[], size_t s, double value)
+//   Postcondition: The return value is how many of items[0] through
+//   items[s-1] are equal to value.
+// **************************************************************************
+size_t counted(const double items[], size_t s, double value)
+{
+    size_t i, answer = 0;
+
+    for (i = 0; i < s; i++)
+        if (items[i] == value)
+            answer++;
+    return answer;
+}
+
+
+// **************************************************************************
+// bool set_operations(const double as[], size_t a_size, const double bs[],
+//                     size_t b_size)
+//   Precondition: as[0] ... as[a_size-1] and bs[0] ... bs[b_size-1] are
+//   sorted, and every item is a whole number from 0 to 99.
+//   Postcondition: A return value of true indicates that the union,
+//   intersection, difference and symmetric difference of sequences of
+//   these items hold, for each value, max(m, n), min(m, n), max(m - n, 0)
+//   and |m - n| copies of it, where it occurs m times in as and n in bs.
+// **************************************************************************
+bool set_operations(const double as[], size_t a_size, const double bs[],
+                    size_t b_size)
+{
+    sequence a, b, dest;
+    double items[4][2000];
+    size_t many[4] = { 0, 0, 0, 0 };
+    size_t i, m, n;
+
+    for (i = 0; i < a_size; i++)
+        a.attach(as[i]);
+    for (i = 0; i < b_size; i++)
+        b.attach(bs[i]);
+    for (double value = 0; value < 100; value++)
+    {
+        m = counted(as, a_size, value);
+        n = counted(bs, b_size, value);
+        for (i = 0; i < (m > n ? m : n); i++)
+            items[0][many[0]++] = value;
+        for (i = 0; i < (m < n ? m : n); i++)
+            items[1][many[1]++] = value;
+        for (i = 0; i + n < m; i++)
+            items[2][many[2]++] = value;
+        for (i = 0; i < (m > n ? m - n : n - m); i++)
+            items[3][many[3]++] = value;
+    }
+
+    sorted_union(a, b, dest);
+    if (!correct(dest, many[0], 0, items[0])) return false;
+    sorted_intersection(a, b, dest);
+    if (!correct(dest, many[1], 0, items[1])) return false;
+    sorted_difference(a, b, dest);
+    if (!correct(dest, many[2], 0, items[2])) return false;
+    sorted_symmetric_difference(a, b, dest);
+    return correct(dest, many[3], 0, items[3]);
+}
+
+
+// **************************************************************************
+// int test18()
+//   Performs tests of the set operations on sorted sequences, comparing
+//   each result with how often each item occurs in the operands.
+//   Returns POINTS[18] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test18()
+{
+    double as[1000], bs[30];
+    double items[3] = { 7, 50, 50 };
+    double items5[3] = { 5, 6, 7 };
+    double items6[4] = { 1, 5, 6, 7 };
+    sequence test, other;
+    size_t i;
+
+    cout << "Sorted sequences of 30 items each, (i * 3) / 4 and i / 2, which\n";
+    cout << "share some items and repeat others." << endl;
+    for (i = 0; i < 30; i++)
+    {
+        as[i] = double((i * 3) / 4);
+        bs[i] = double(i / 2);
+    }
+    if (!set_operations(as, 30, bs, 30)) return 0;
+    if (!set_operations(bs, 30, as, 30)) return 0;
+
+    cout << "A sorted sequence of 1000 items, i / 10, and one of 3 items,\n";
+    cout << "7, 50, 50 (so runs of the larger one are galloped over)." << endl;
+    for (i = 0; i < 1000; i++)
+        as[i] = double(i / 10);
+    if (!set_operations(as, 1000, items, 3)) return 0;
+    if (!set_operations(items, 3, as, 1000)) return 0;
+
+    cout << "Edge cases: one or both sequences empty." << endl;
+    if (!set_operations(as, 0, items, 3)) return 0;
+    if (!set_operations(items, 3, as, 0)) return 0;
+    if (!set_operations(as, 0, bs, 0)) return 0;
+
+    cout << "Putting 5, 6, 7 in a sequence with a filter, handles and\n";
+    cout << "checkpoints, and writing its union with a sequence holding 1\n";
+    cout << "and 6 into itself." << endl;
+    test.enable_filter();
+    test.enable_handles();
+    test.enable_checkpoints();
+    for (i = 0; i < 3; i++)
+        test.attach(items5[i]);
+    other.attach(1);
+    other.attach(6);
+    sorted_union(test, other, test);
+    if (!correct(test, 4, 0, items6)) return 0;
+    if (!keeps_options(test)) return 0;
+
+    // All tests passed
+    cout << "All tests of this eighteenth function have been passed." << endl;
+    return POINTS[18];
+}
+
+// **************************************************************************
+// size_t position(sequence test)
+//   Postcondition: The return value is the position of test's current item
+//   (counting the first item as 0), or test.size() if there is none.
+// **************************************************************************
+size_t position(sequence test)
+{
+    size_t after = 0;
+
+    for ( ; test.is_item(); test.advance())
+        after++;
+    return test.size() - after;
+}
+
+
+// **************************************************************************
+// int test19()
+//   Performs tests of seek_to on a sequence that keeps a hash index, under
+//   a long run of inserts, attaches and removals, comparing each seek with
+//   a plain search of a copy of the items kept in an array.
+//   Returns POINTS[19] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test19()
+{
+    const size_t STEPS = 2000;
+    const size_t ROOM = STEPS + 1;
+    sequence test, other;
+    double items[ROOM];
+    size_t used = 0, cursor = 0;
+    size_t step, i;
+    unsigned long random = 1;
+    double value;
+    bool found;
+
+    cout << "Making " << STEPS << " random inserts, attaches, removals and ";
+    cout << "cursor moves\non a sequence with an index, with items from 0 ";
+    cout << "to 9, and after each\none calling seek_to for one of 0 to 10";
+    cout << " ... ";
+    cout.flush();
+    test.enable_index();
+    for (step = 0; step < STEPS; step++)
+    {
+        random = (random * 1103515245 + 12345) % 2147483648UL;
+        value = double((random >> 8) % 10);
+        switch ((random >> 16) % 6)
+        {
+        case 0:   // insert
+            if (cursor == used)
+                cursor = 0;
+            for (i = used; i > cursor; i--)
+                items[i] = items[i-1];
+            items[cursor] = value;
+            used++;
+            test.insert(value);
+            break;
+        case 1:   // attach
+            cursor = (cursor == used) ? used : cursor + 1;
+            for (i = used; i > cursor; i--)
+                items[i] = items[i-1];
+            items[cursor] = value;
+            used++;
+            test.attach(value);
+            break;
+        case 2:   // remove_current
+        case 3:
+            if (cursor == used)
+                break;
+            for (i = cursor; i + 1 < used; i++)
+                items[i] = items[i+1];
+            used--;
+            test.remove_current();
+            break;
+        case 4:
+            cursor = 0;
+            test.start();
+            break;
+        default:
+            if (cursor < used)
+            {
+                cursor++;
+                test.advance();
+            }
+            break;
+        }
+
+        value = double(step % 11);
+        for (i = 0; i < used && items[i] != value; i++)
+            ;
+        if (i < used)
+            cursor = i;
+        found = test.seek_to(value);
+        if (found != (i < used) || position(test) != cursor
+            || test.size() != used)
+            break;
+    }
+    cout << (step == STEPS ? "Passed." : "Failed.") << endl;
+    if (step != STEPS)
+    {
+        cout << "    seek_to(" << value << ") went wrong at step " << step;
+        cout << "." << endl;
+        return 0;
+    }
+    test.start();
+    if (!correct(test, used, 0, items)) return 0;
+
+    cout << "Doubling every item with scal (a change in bulk), then seeking";
+    cout << " ... ";
+    cout.flush();
+    scal(2, test);
+    for (step = 0, found = true; step < 20; step++)
+    {
+        for (i = 0; i < used && 2 * items[i] != step; i++)
+            ;
+        found = found && test.seek_to(step) == (i < used)
+            && (i == used || position(test) == i);
+    }
+    cout << (found ? "Passed." : "Failed.") << endl;
+    if (!found) return 0;
+
+    cout << "Assigning it a sequence holding 4, 3, 4, then seeking 4 and 3";
+    cout << " ... ";
+    cout.flush();
+    other.attach(4);
+    other.attach(3);
+    other.attach(4);
+    test = other;
+    found = test.seek_to(4) && position(test) == 0
+        && test.seek_to(3) && position(test) == 1 && !test.seek_to(5);
+    cout << (found ? "Passed." : "Failed.") << endl;
+    if (!found) return 0;
+
+    // All tests passed
+    cout << "All tests of this nineteenth function have been passed." << endl;
+    return POINTS[19];
+}
+
+// **************************************************************************
+// int test20()
+//   Performs tests of contains on a sequence that keeps a Bloom filter,
+//   comparing each answer with a plain search of the items, as the filter
+//   grows, loses items, and is rebuilt.
+//   Returns POINTS[20] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test20()
+{
+    const size_t MANY = 1000;
+    sequence test, other;
+    size_t i, value;
+    bool answer;
+
+    test.enable_filter();
+    if (!check("Testing contains on an empty sequence with a filter",
+               !test.contains(0) && !test.contains(1))) return 0;
+
+    cout << "Attaching 0, 3, 6, ... " << 3 * (MANY - 1) << " (more than the";
+    cout << " filter was first sized for)." << endl;
+    for (i = 0; i < MANY; i++)
+        test.attach(3.0 * i);
+    for (value = 0, answer = true; value < 3 * MANY + 10; value++)
+        answer = answer && test.contains(value)
+            == (value % 3 == 0 && value < 3 * MANY);
+    if (!check("Testing contains for 0 through 3009", answer)) return 0;
+    if (!check("Testing that the false positive rate is below 5%",
+               test.filter_false_positive_rate() < 0.05)) return 0;
+    if (!check("Testing that NaN isn't contained",
+               !test.contains(sqrt(-1.0)))) return 0;
+
+    cout << "Removing every item but the multiples of 9 (so the filter is\n";
+    cout << "rebuilt)." << endl;
+    for (test.start(); test.is_item(); )
+        if (long(test.current()) % 9 == 0)
+            test.advance();
+        else
+            test.remove_current();
+    for (value = 0, answer = true; value < 3 * MANY + 10; value++)
+        answer = answer && test.contains(value)
+            == (value % 9 == 0 && value < 3 * MANY);
+    if (!check("Testing contains for 0 through 3009", answer)) return 0;
+
+    cout << "Adding 1 to every item with a change in bulk." << endl;
+    other.attach(1);
+    for (i = 1; i < test.size(); i++)
+        other.attach(1);
+    axpy(1, other, test);
+    for (value = 0, answer = true; value < 3 * MANY + 10; value++)
+        answer = answer && test.contains(value)
+            == (value % 9 == 1 && value < 3 * MANY);
+    if (!check("Testing contains for 0 through 3009", answer)) return 0;
+
+    cout << "Assigning it a sequence holding 2 and 5." << endl;
+    other = sequence();
+    other.attach(2);
+    other.attach(5);
+    test = other;
+    answer = test.contains(2) && test.contains(5) && !test.contains(1)
+        && !test.contains(9) && test.filter_false_positive_rate() < 0.05;
+    if (!check("Testing contains, and that it still keeps a filter", answer))
+        return 0;
+
+    // All tests passed
+    cout << "All tests of this twentieth function have been passed." << endl;
+    return POINTS[20];
+}
+
+// **************************************************************************
+// int test21()
+//   Performs tests of frozen_sequence, comparing its order, seek and
+//   contains with a plain search of the sorted items, for trees of many
+//   shapes (full, and with a partly filled last level).
+//   Returns POINTS[21] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test21()
+{
+    const size_t SIZES[9] = { 0, 1, 2, 3, 7, 8, 9, 100, 1000 };
+    sequence source, dest;
+    double items[1000];
+    size_t k, i, n, below;
+    double target;
+    bool answer;
+
+    for (k = 0; k < 9; k++)
+    {
+        n = SIZES[k];
+        cout << "Freezing a sorted sequence of " << n << " items, 2 * (i / 2)";
+        cout << " (each twice)." << endl;
+        source = sequence();
+        for (i = 0; i < n; i++)
+        {
+            items[i] = 2.0 * (i / 2);
+            source.attach(items[i]);
+        }
+        frozen_sequence frozen(source);
+        if (!check("Testing size()", frozen.size() == n)) return 0;
+        frozen.thaw(dest);
+        if (!correct(dest, n, 0, items)) return 0;
+        for (frozen.start(), i = 0; frozen.is_item() && i < n;
+             frozen.advance(), i++)
+            if (frozen.current() != items[i])
+                break;
+        if (!check("Testing that start and advance visit the items in order",
+                   i == n && !frozen.is_item())) return 0;
+
+        for (target = -1, answer = true; target <= n + 1; target += 0.5)
+        {
+            for (below = 0; below < n && items[below] < target; below++)
+                ;
+            bool equal = (below < n && items[below] == target);
+            answer = answer && frozen.seek(target) == equal
+                && frozen.is_item() == (below < n)
+                && (below == n || frozen.current() == items[below])
+                && frozen.contains(target) == equal;
+        }
+        if (!check("Testing seek and contains from -1 to n + 1 in steps of "
+                   "0.5", answer)) return 0;
+    }
+
+    // All tests passed
+    cout << "All tests of this twenty-first function have been passed.";
+    cout << endl;
+    return POINTS[21];
+}
+
+// **************************************************************************
+// int test22()
+//   Performs tests of interpolation_seek and gallop_seek on sorted
+//   sequences, evenly spread and not, comparing each seek with a plain
+//   search for the first item not less than the target.
+//   Returns POINTS[22] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test22()
+{
+    const size_t MANY = 500;
+    sequence even, skewed, empty, single;
+    double evens[MANY], skews[MANY];
+    size_t i, below, start;
+    double target;
+    bool answer, equal;
+
+    cout << "Putting " << MANY << " evenly spread items, 3 * (i / 2), and ";
+    cout << MANY << " skewed\nones, i * i * i / 1000, in two sorted ";
+    cout << "sequences." << endl;
+    for (i = 0; i < MANY; i++)
+    {
+        evens[i] = 3.0 * (i / 2);
+        skews[i] = double(i) * i * i / 1000;
+        even.attach(evens[i]);
+        skewed.attach(skews[i]);
+    }
+
+    cout << "interpolation_seek, then gallop_seek from the item it found,";
+    cout << " for targets\nfrom -1 up past the largest item ... ";
+    cout.flush();
+    for (target = -1, answer = true; target < 3 * MANY / 2 + 2; target += 0.5)
+    {
+        for (below = 0; below < MANY && evens[below] < target; below++)
+            ;
+        equal = (below < MANY && evens[below] == target);
+        answer = answer && even.interpolation_seek(target) == equal
+            && position(even) == below;
+        for ( ; below < MANY && evens[below] < target + 1.5; below++)
+            ;
+        equal = (below < MANY && evens[below] == target + 1.5);
+        answer = answer && even.gallop_seek(target + 1.5) == equal
+            && position(even) == below;
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    cout << "The same on the skewed items, with gallop_seek starting from";
+    cout << " each item\nand from no current item ... ";
+    cout.flush();
+    for (start = 0, answer = true; start <= MANY; start += 7)
+    {
+        target = skews[(start * 31) % MANY] + 0.25 * (start % 3);
+        for (below = 0; below < MANY && skews[below] < target; below++)
+            ;
+        equal = (below < MANY && skews[below] == target);
+        answer = answer && skewed.interpolation_seek(target) == equal
+            && position(skewed) == below;
+        skewed.start();
+        for (i = 0; i < start && skewed.is_item(); i++)
+            skewed.advance();
+        answer = answer && skewed.gallop_seek(target) == equal
+            && position(skewed) == below;
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    cout << "Edge cases: an empty sequence, and a single item." << endl;
+    single.attach(5);
+    if (!check("Testing the empty sequence", !empty.interpolation_seek(1)
+               && !empty.gallop_seek(1) && !empty.is_item())) return 0;
+    answer = single.interpolation_seek(5) && single.current() == 5
+        && !single.gallop_seek(6) && !single.is_item()
+        && !single.interpolation_seek(4) && single.current() == 5
+        && single.gallop_seek(5) && single.current() == 5;
+    if (!check("Testing the single item", answer)) return 0;
+
+    // All tests passed
+    cout << "All tests of this twenty-second function have been passed.";
+    cout << endl;
+    return POINTS[22];
+}
+
+// **************************************************************************
+// int test23()
+//   Performs tests of quantized_sequence in each storage mode, checking
+//   every stored item against the error bound of its mode, worked out from
+//   the original items by a plain loop.
+//   Returns POINTS[23] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test23()
+{
+    const size_t MANY = 600;  // two whole blocks and part of a third
+    const size_t BLOCK = quantized_sequence::BLOCK_SIZE;
+    const char* NAMES[4] = { "FLOAT16", "BFLOAT16", "INT16", "INT8" };
+    sequence source, dest, empty, huge;
+    double sources[MANY], largest[3];
+    double bound, error, worst, total;
+    size_t mode, i;
+    bool answer;
+
+    cout << "Putting " << MANY << " items, ((i % 97) - 48) * 1.37 times 1, ";
+    cout << "10 or 0.01\n(a different magnitude in each block), in a ";
+    cout << "sequence." << endl;
+    largest[0] = largest[1] = largest[2] = 0;
+    for (i = 0; i < MANY; i++)
+    {
+        sources[i] = ((i % 97) - 48.0) * 1.37 * (i < BLOCK ? 1
+                     : i < 2 * BLOCK ? 10 : 0.01);
+        source.attach(sources[i]);
+        if (fabs(sources[i]) > largest[i / BLOCK])
+            largest[i / BLOCK] = fabs(sources[i]);
+    }
+
+    for (mode = 0; mode < 4; mode++)
+    {
+        quantized_sequence::storage_mode storage =
+            quantized_sequence::storage_mode(mode);
+        cout << "Storing them as " << NAMES[mode] << " ... ";
+        cout.flush();
+        quantized_sequence stored(source, storage);
+        stored.decode(dest);
+        answer = (stored.mode() == storage && stored.size() == MANY
+                  && dest.size() == MANY);
+        worst = 0;
+        total = 0;
+        for (stored.start(), dest.start(), i = 0; answer && i < MANY;
+             stored.advance(), dest.advance(), i++)
+        {
+            if (storage == quantized_sequence::FLOAT16)
+                bound = fabs(sources[i]) / 2048;
+            else if (storage == quantized_sequence::BFLOAT16)
+                bound = fabs(sources[i]) / 256;
+            else if (storage == quantized_sequence::INT16)
+                bound = largest[i / BLOCK] / 65534 * (1 + 1e-12);
+            else
+                bound = largest[i / BLOCK] / 254 * (1 + 1e-12);
+            error = fabs(stored.current() - sources[i]);
+            answer = stored.current() == dest.current() && error <= bound;
+            if (error > worst)
+                worst = error;
+            total += stored.current();
+        }
+        answer = answer && !stored.is_item() && stored.max_error() == worst
+            && fabs(stored.sum() - total) <= 1e-9 * MANY * largest[1];
+        cout << (answer ? "Passed." : "Failed.") << endl;
+        if (!answer) return 0;
+    }
+
+    cout << "Edge cases: an empty sequence, and an item too large for ";
+    cout << "FLOAT16." << endl;
+    quantized_sequence none(empty, quantized_sequence::INT8);
+    none.start();
+    none.decode(dest);
+    if (!check("Testing the empty sequence", none.size() == 0
+               && !none.is_item() && none.max_error() == 0 && none.sum() == 0
+               && dest.size() == 0)) return 0;
+    huge.attach(1);
+    huge.attach(1e6);
+    quantized_sequence overflowed(huge, quantized_sequence::FLOAT16);
+    overflowed.start();
+    answer = overflowed.current() == 1;
+    overflowed.advance();
+    answer = answer && overflowed.current() > 1e300
+        && overflowed.max_error() > 1e300;
+    if (!check("Testing that 1 is exact and 1e6 is stored as infinity",
+               answer)) return 0;
+
+    // All tests passed
+    cout << "All tests of this twenty-third function have been passed.";
+    cout << endl;
+    return POINTS[23];
+}
+
+// **************************************************************************
+// template <class Edited>
+// void edit_alike(Edited& test, double items[], size_t& used,
+//                 size_t& cursor, unsigned long& random,
+//                 const double values[], size_t many)
+//   Makes one random insert, attach, removal or cursor move, the same on
+//   test and on the first used items of the array items with its cursor at
+//   cursor (cursor == used for no current item). The item put in is one
+//   of the many values. random is the state of the random number sequence.
+//
+// template <class Edited>
+// bool same_items(Edited test, const double items[], size_t used,
+//                 size_t cursor)
+//   Returns true if test (a copy) holds the used items of the array, in
+//   order, with its current item at cursor.
+// **************************************************************************
+template <class Edited>
+void edit_alike(Edited& test, double items[], size_t& used, size_t& cursor,
+                unsigned long& random, const double values[], size_t many)
+{
+    double value;
+    size_t i;
+
+    random = (random * 1103515245 + 12345) % 2147483648UL;
+    value = values[(random >> 8) % many];
+    switch ((random >> 16) % 6)
+    {
+    case 0:   // insert
+        if (cursor == used)
+            cursor = 0;
+        for (i = used; i > cursor; i--)
+            items[i] = items[i-1];
+        items[cursor] = value;
+        used++;
+        test.insert(value);
+        break;
+    case 1:   // attach
+        cursor = (cursor == used) ? used : cursor + 1;
+        for (i = used; i > cursor; i--)
+            items[i] = items[i-1];
+        items[cursor] = value;
+        used++;
+        test.attach(value);
+        break;
+    case 2:   // remove_current
+        if (cursor == used)
+            break;
+        for (i = cursor; i + 1 < used; i++)
+            items[i] = items[i+1];
+        used--;
+        test.remove_current();
+        break;
+    case 3:
+        cursor = 0;
+        test.start();
+        break;
+    default:
+        if (cursor < used)
+        {
+            cursor++;
+            test.advance();
+        }
+        break;
+    }
+}
+
+template <class Edited>
+bool same_items(Edited test, const double items[], size_t used,
+                size_t cursor)
+{
+    size_t i;
+
+    if (test.size() != used || test.is_item() != (cursor < used))
+        return false;
+    for (i = cursor; i < used; i++, test.advance())
+        if (!test.is_item() || test.current() != items[i])
+            return false;
+    if (test.is_item())
+        return false;
+    for (test.start(), i = 0; i < used; i++, test.advance())
+        if (!test.is_item() || test.current() != items[i])
+            return false;
+    return true;
+}
+
+
+// **************************************************************************
+// int test24()
+//   Performs tests of rle_sequence under a long run of random edits with
+//   few distinct values, checking the items, runs, sums and counts against
+//   a copy of the items kept in an array after every edit.
+//   Returns POINTS[24] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test24()
+{
+    const size_t STEPS = 2000;
+    const double VALUES[3] = { 0, 1, 2.5 };
+    double items[STEPS + 1];
+    size_t used = 0, cursor = 0;
+    size_t step, i, runs, ones;
+    unsigned long random = 7;
+    double total, zero = 0;
+    rle_sequence test, other;
+    sequence source, dest;
+    bool answer = true;
+
+    cout << "Making " << STEPS << " random inserts, attaches, removals and ";
+    cout << "cursor moves\non an rle_sequence, with items 0, 1 and 2.5, and ";
+    cout << "after each one checking\nthe items, run_count, sum and count(1) ";
+    cout << "... ";
+    cout.flush();
+    for (step = 0; answer && step < STEPS; step++)
+    {
+        edit_alike(test, items, used, cursor, random, VALUES, 3);
+        runs = ones = 0;
+        total = 0;
+        for (i = 0; i < used; i++)
+        {
+            if (i == 0 || items[i] != items[i-1])
+                runs++;
+            total += items[i];
+            if (items[i] == 1)
+                ones++;
+        }
+        answer = same_items(test, items, used, cursor)
+            && test.run_count() == runs && test.sum() == total
+            && test.count(1) == ones;
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    other = test;
+    test.start();
+    other.insert(3);
+    if (!check("Testing that the original is unchanged by edits of a copy",
+               same_items(test, items, used, 0)
+               && other.size() == used + 1)) return 0;
+    test.decode(dest);
+    if (!check("Testing that decode gives the items, with the first current",
+               dest.size() == used && dest.is_item()
+               && dest.current() == items[0] && position(dest) == 0))
+        return 0;
+
+    cout << "Edge cases: an empty sequence, and NaN items." << endl;
+    rle_sequence none(source);
+    if (!check("Testing an rle_sequence of an empty sequence",
+               none.size() == 0 && !none.is_item() && none.run_count() == 0
+               && none.sum() == 0 && none.count(0) == 0)) return 0;
+    source.attach(1);
+    source.attach(zero / zero);
+    source.attach(source.current());
+    source.attach(1);
+    rle_sequence nans(source);
+    if (!check("Testing that each NaN is a run of its own",
+               nans.size() == 4 && nans.run_count() == 4
+               && nans.count(1) == 2)) return 0;
+
+    // All tests passed
+    cout << "All tests of this twenty-fourth function have been passed.";
+    cout << endl;
+    return POINTS[24];
+}
+
+// **************************************************************************
+// int test25()
+//   Performs tests of sparse_sequence under a long run of random edits
+//   with mostly zero items, checking the items, nonzero count, sum and dot
+//   products against a copy of the items kept in an array after every edit.
+//   Returns POINTS[25] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test25()
+{
+    const size_t STEPS = 2000;
+    const double VALUES[5] = { 0, 0, 0, -0.0, 1.5 };
+    double items[STEPS + 1];
+    size_t used = 0, cursor = 0;
+    size_t step, i, nonzero;
+    unsigned long random = 11;
+    double total, product;
+    sparse_sequence test, other;
+    sequence dense, dest;
+    bool answer = true;
+
+    cout << "Making " << STEPS << " random inserts, attaches, removals and ";
+    cout << "cursor moves\non a sparse_sequence, mostly of zeros, and after ";
+    cout << "each one checking\nthe items, nonzero_count, sum and dot with ";
+    cout << "itself ... ";
+    cout.flush();
+    for (step = 0; answer && step < STEPS; step++)
+    {
+        edit_alike(test, items, used, cursor, random, VALUES, 5);
+        nonzero = 0;
+        total = product = 0;
+        for (i = 0; i < used; i++)
+        {
+            if (items[i] != 0)
+                nonzero++;
+            total += items[i];
+            product += items[i] * items[i];
+        }
+        answer = same_items(test, items, used, cursor)
+            && test.nonzero_count() == nonzero && test.sum() == total
+            && test.dot(test) == product;
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    test.densify(dense);
+    if (!check("Testing densify and the dot product with a sequence",
+               dense.size() == used && position(dense) == 0
+               && test.dot(dense) == product)) return 0;
+    other = test;
+    other.start();
+    other.insert(2);
+    if (!check("Testing that the original is unchanged by edits of a copy",
+               same_items(test, items, used, cursor)
+               && other.size() == used + 1)) return 0;
+    other.sparsify(dense);
+    if (!check("Testing sparsify back from the densified items",
+               same_items(other, items, used, used))) return 0;
+
+    cout << "Edge cases: an empty sequence, all zeros, and -0.0." << endl;
+    sparse_sequence none(dest);
+    if (!check("Testing a sparse_sequence of an empty sequence",
+               none.size() == 0 && !none.is_item()
+               && none.nonzero_count() == 0 && none.sum() == 0)) return 0;
+    dest.attach(0);
+    dest.attach(-0.0);
+    dest.attach(0);
+    sparse_sequence zeros(dest);
+    zeros.start();
+    zeros.advance();
+    if (!check("Testing that -0.0 and 0 are not stored, and read back as 0",
+               zeros.size() == 3 && zeros.nonzero_count() == 0
+               && zeros.current() == 0 && 1 / zeros.current() > 0))
+        return 0;
+
+    // All tests passed
+    cout << "All tests of this twenty-fifth function have been passed.";
+    cout << endl;
+    return POINTS[25];
+}
+
+// **************************************************************************
+// int test26()
+//   Performs tests of sequence_table, building many rows of varied sizes
+//   (empty ones too) and checking row_size, item and row_view against the
+//   item values the rows were built from.
+//   Returns POINTS[26] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test26()
+{
+    const size_t ROWS = 500;
+    sequence_table test, other;
+    sequence source;
+    size_t row, i, total = 0;
+    bool answer;
+
+    cout << "Testing an empty table ... ";
+    answer = (test.row_count() == 0 && test.size() == 0);
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    cout << "Building " << ROWS << " rows, row r with (r * 7) % 13 items of ";
+    cout << "value r * 100 + i,\nhalf by append and half by copying a ";
+    cout << "sequence, and checking\nrow_size, item and row_view of each ... ";
+    cout.flush();
+    for (row = 0; row < ROWS; row++)
+    {
+        if (row % 2 == 0)
+        {
+            test.append_row();
+            for (i = 0; i < (row * 7) % 13; i++)
+                test.append(row * 100.0 + i);
+        }
+        else
+        {
+            while (source.size() > 0)
+            {
+                source.start();
+                source.remove_current();
+            }
+            for (i = 0; i < (row * 7) % 13; i++)
+                source.attach(row * 100.0 + i);
+            test.append_row(source);
+        }
+        total += (row * 7) % 13;
+    }
+    answer = (test.row_count() == ROWS && test.size() == total);
+    for (row = 0; answer && row < ROWS; row++)
+    {
+        sequence_view view = test.row_view(row);
+        answer = (test.row_size(row) == (row * 7) % 13
+                  && view.size() == test.row_size(row) && !view.is_item());
+        for (view.start(), i = 0; answer && i < test.row_size(row);
+             view.advance(), i++)
+            answer = (test.item(row, i) == row * 100.0 + i
+                      && view.is_item() && view.current() == row * 100.0 + i);
+        answer = answer && !view.is_item();
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    source.start();
+    if (!check("Testing that append_row left its source unchanged",
+               source.size() == ((ROWS - 1) * 7) % 13 && source.is_item()
+               && source.current() == (ROWS - 1) * 100.0)) return 0;
+
+    other = test;
+    other.append(-1);
+    other.append_row();
+    other.append(-2);
+    if (!check("Testing that appending to a copy leaves the original alone",
+               test.row_count() == ROWS && test.size() == total
+               && test.row_size(ROWS - 1) == ((ROWS - 1) * 7) % 13
+               && other.row_count() == ROWS + 1
+               && other.item(ROWS - 1, other.row_size(ROWS - 1) - 1) == -1
+               && other.item(ROWS, 0) == -2)) return 0;
+
+    sequence_table reserved;
+    reserved.reserve(3, 10);
+    reserved.append_row();
+    reserved.append_row();
+    reserved.append(4);
+    reserved.append_row();
+    if (!check("Testing reserve, and an empty row last",
+               reserved.row_count() == 3 && reserved.size() == 1
+               && reserved.row_size(0) == 0 && reserved.row_size(2) == 0
+               && reserved.item(1, 0) == 4
+               && reserved.row_view(2).size() == 0)) return 0;
+
+    // All tests passed
+    cout << "All tests of this twenty-sixth function have been passed.";
+    cout << endl;
+    return POINTS[26];
+}
+
+// **************************************************************************
+// int test27()
+//   Performs tests of sequence_pool: the rounding of acquire to size
+//   classes, the reuse of released arrays, and sequences using a pool
+//   under a long run of random edits, compared with a copy of the items
+//   kept in an array, after which all of their memory must be back.
+//   Returns POINTS[27] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test27()
+{
+    const size_t STEPS = 3000;
+    const double VALUES[4] = { 1, 2, 3, 4 };
+    const size_t BYTES = sizeof(double);
+    sequence_pool pool;
+    double items[STEPS + 1];
+    double* array;
+    double* again;
+    size_t used = 0, cursor = 0;
+    size_t step, count, spare;
+    unsigned long random = 13;
+    bool answer = true;
+
+    if (!check("Testing a new pool", pool.bytes_reserved() == 0
+               && pool.bytes_in_use() == 0 && pool.free_arrays() == 0
+               && pool.fragmentation() == 0)) return 0;
+
+    count = 1;
+    array = pool.acquire(count);
+    answer = (count == 8 && pool.bytes_in_use() == 8 * BYTES);
+    count = 9;
+    again = pool.acquire(count);
+    answer = answer && count == 16 && pool.bytes_in_use() == 24 * BYTES;
+    spare = pool.free_arrays();
+    pool.release(again, 16);
+    answer = answer && pool.free_arrays() == spare + 1;
+    count = 16;
+    answer = answer && pool.acquire(count) == again
+        && pool.free_arrays() == spare;
+    pool.release(again, 16);
+    pool.release(array, 8);
+    count = 5;
+    answer = answer && pool.acquire(count) == array && count == 8
+        && pool.bytes_in_use() == 8 * BYTES;
+    pool.release(array, 8);
+    count = sequence_pool::SLAB_ITEMS + 1;
+    array = pool.acquire(count);
+    answer = answer && count == 2 * sequence_pool::SLAB_ITEMS;
+    pool.release(array, count);
+    if (!check("Testing that acquire rounds up to a class and reuses "
+               "arrays", answer && pool.bytes_in_use() == 0
+               && pool.fragmentation() == 1)) return 0;
+
+    cout << "Making " << STEPS << " random inserts, attaches, removals and ";
+    cout << "cursor moves\non a sequence with a pool, starting at capacity 1,";
+    cout << " with a copy made\nand dropped every 100 steps ... ";
+    cout.flush();
+    {
+        sequence test(pool, 1);
+        for (step = 0; answer && step < STEPS; step++)
+        {
+            edit_alike(test, items, used, cursor, random, VALUES, 4);
+            answer = same_items(test, items, used, cursor);
+            if (step % 100 == 0)
+            {
+                sequence other(test);
+                other.attach(5);
+                answer = answer && same_items(test, items, used, cursor)
+                    && other.size() == used + 1;
+            }
+        }
+        answer = answer && pool.bytes_in_use() > 0;
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+    if (!check("Testing that every array is back in the pool",
+               pool.bytes_in_use() == 0 && pool.free_arrays() > 0
+               && pool.fragmentation() == 1)) return 0;
+
+    // All tests passed
+    cout << "All tests of this twenty-seventh function have been passed.";
+    cout << endl;
+    return POINTS[27];
+}
+
+// **************************************************************************
+// int test28()
+//   Performs tests of lazy removal: runs of removals, random edits with
+//   functions that read the array directly called in between, copies and
+//   assignments both ways, and removing every item, all compared with a
+//   copy of the items kept in an array.
+//   Returns POINTS[28] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test28()
+{
+    const size_t MANY = 400;
+    const size_t STEPS = 3000;
+    const double VALUES[5] = { -2, -1, 0, 1, 2 };
+    double items[STEPS + MANY + 1];
+    size_t used = 0, cursor = 0;
+    size_t step, i, kept;
+    unsigned long random = 17;
+    double total;
+    sequence test, plain, other;
+    bool answer = true;
+
+    test.enable_lazy_remove();
+    for (i = 0; i < MANY; i++)
+    {
+        test.attach(i);
+        items[i] = i;
+    }
+    cout << "Removing every item of 0 to " << MANY - 1 << " that is 1 more ";
+    cout << "than a multiple of 3\nfrom a sequence with lazy removal ... ";
+    for (test.start(), i = 0, kept = 0; i < MANY; i++)
+    {
+        if (i % 3 == 1)
+            test.remove_current();
+        else
+        {
+            items[kept++] = i;
+            test.advance();
+        }
+    }
+    used = cursor = kept;
+    answer = same_items(test, items, used, cursor);
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    test.start();
+    for (i = 0, total = 0; i < used; i++)
+        total += items[i];
+    if (!check("Testing asum, nth and seek_to over the dead slots",
+               asum(test) == total && nth(test, used / 2) == items[used / 2]
+               && test.seek_to(items[used - 1]) && !test.seek_to(1)
+               && position(test) == used - 1)) return 0;
+    cursor = used - 1;
+
+    cout << "Making " << STEPS << " random inserts, attaches, removals and ";
+    cout << "cursor moves,\nchecking asum every 37 steps and a copy and an ";
+    cout << "assignment to and from\na sequence without lazy removal every ";
+    cout << "100 ... ";
+    cout.flush();
+    for (step = 0; answer && step < STEPS; step++)
+    {
+        edit_alike(test, items, used, cursor, random, VALUES, 5);
+        answer = same_items(test, items, used, cursor);
+        if (step % 37 == 0)
+        {
+            for (i = 0, total = 0; i < used; i++)
+                total += fabs(items[i]);
+            answer = answer && asum(test) == total;
+        }
+        if (step % 100 == 0)
+        {
+            sequence copy(test);
+            plain = test;
+            other.enable_lazy_remove();
+            other = plain;
+            answer = answer && same_items(copy, items, used, cursor)
+                && same_items(plain, items, used, cursor)
+                && same_items(other, items, used, cursor);
+            if (answer && cursor < used)
+            {
+                other.remove_current();
+                copy.remove_current();
+                answer = other.size() == used - 1 && copy.size() == used - 1
+                    && same_items(test, items, used, cursor);
+            }
+        }
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    test.start();
+    for (i = 0; i + 1 < used; i++)
+        test.advance();
+    test.remove_current();
+    used--;
+    if (!check("Testing that removing the last item leaves no current item",
+               same_items(test, items, used, used))) return 0;
+    test.disable_lazy_remove();
+    if (!check("Testing that disabling lazy removal keeps the items",
+               same_items(test, items, used, used))) return 0;
+    test.enable_lazy_remove();
+    for (test.start(); test.size() > 0; )
+        test.remove_current();
+    test.insert(5);
+    items[0] = 5;
+    if (!check("Testing removing every item, then inserting one",
+               same_items(test, items, 1, 0))) return 0;
+
+    // All tests passed
+    cout << "All tests of this twenty-eighth function have been passed.";
+    cout << endl;
+    return POINTS[28];
+}
+
+// **************************************************************************
+// int test29()
+//   Performs tests of item handles under a long run of random edits, with
+//   and without lazy removal, checking each handle held against a plain
+//   search of a copy of the items (all different) kept in an array.
+//   Returns POINTS[29] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test29()
+{
+    const size_t STEPS = 3000;
+    const size_t HELD = 16;
+    sequence::item_handle handles[HELD];
+    double targets[HELD];
+    double items[STEPS + 1];
+    size_t used, cursor, held;
+    size_t pass, step, h, i;
+    unsigned long random = 19;
+    double value;
+    bool found, answer = true;
+
+    for (pass = 0; answer && pass < 2; pass++)
+    {
+        sequence test;
+        test.enable_handles();
+        if (pass == 1)
+            test.enable_lazy_remove();
+        used = cursor = held = 0;
+        cout << "Making " << STEPS << " random edits" << (pass == 1 ?
+            " with lazy removal" : "") << ", taking a handle to the\n";
+        cout << "current item every 10 steps (keeping the last " << HELD;
+        cout << "), and checking every\nhandle held after each edit ... ";
+        cout.flush();
+        for (step = 0; answer && step < STEPS; step++)
+        {
+            value = step + 0.5;
+            edit_alike(test, items, used, cursor, random, &value, 1);
+            if (step % 10 == 0 && cursor < used)
+            {
+                handles[held % HELD] = test.current_handle();
+                targets[held % HELD] = items[cursor];
+                held++;
+            }
+            for (h = 0; answer && h < HELD && h < held; h++)
+            {
+                for (i = 0; i < used && items[i] != targets[h]; i++)
+                    ;
+                found = test.seek_handle(handles[h]);
+                if (found)
+                    cursor = i;
+                answer = found == (i < used)
+                    && same_items(test, items, used, cursor);
+            }
+        }
+        cout << (answer ? "Passed." : "Failed.") << endl;
+        if (!answer) return 0;
+
+        sequence other(test);
+        test = other;
+        for (h = 0; answer && h < HELD && h < held; h++)
+            answer = !test.seek_handle(handles[h]);
+        if (!check("Testing that an assignment makes every handle invalid",
+                   answer && same_items(test, items, used, cursor)))
+            return 0;
+        test.start();
+        handles[0] = test.current_handle();
+        test.remove_current();
+        test.insert(items[0]);
+        if (!check("Testing that an equal item put back in its place doesn't "
+                   "match", !test.seek_handle(handles[0]))) return 0;
+    }
+
+    // All tests passed
+    cout << "All tests of this twenty-ninth function have been passed.";
+    cout << endl;
+    return POINTS[29];
+}
+
+// **************************************************************************
+// long data_bytes()
+//   Returns the number of bytes in the two data files of the checkpoint at
+//   CHECKPOINT_PATH together (a missing file counts as 0).
+// **************************************************************************
+long data_bytes()
+{
+    string path = CHECKPOINT_PATH;
+    long total = 0;
+    char which;
+    FILE* file;
+
+    for (which = '0'; which <= '1'; which++)
+    {
+        file = fopen((path + "." + which).c_str(), "rb");
+        if (file == NULL)
+            continue;
+        fseek(file, 0, SEEK_END);
+        total += ftell(file);
+        fclose(file);
+    }
+    return total;
+}
+
+
+// **************************************************************************
+// int test30()
+//   Performs tests of checkpoints: saves during a long run of random edits,
+//   each loaded back into another sequence and compared with a copy of the
+//   items kept in an array; the number of bytes each save writes; and
+//   loads that must fail.
+//   Returns POINTS[30] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test30()
+{
+    const size_t STEPS = 3000;
+    const size_t MANY = 10 * checkpoint_file::BLOCK_ITEMS;
+    const long BLOCK_BYTES = checkpoint_file::BLOCK_ITEMS * sizeof(double);
+    const double VALUES[3] = { 1, 2, 3 };
+    double items[STEPS + MANY + 1];
+    size_t used = 0, cursor = 0;
+    size_t step, i;
+    unsigned long random = 23;
+    long before;
+    sequence test, loaded;
+    bool answer = true;
+    FILE* file;
+
+    remove_checkpoint();
+    test.enable_checkpoints();
+    loaded.enable_checkpoints();
+    loaded.attach(9);
+    if (!check("Testing that loading a missing checkpoint fails and leaves "
+               "the items", !loaded.load_checkpoint(CHECKPOINT_PATH)
+               && loaded.size() == 1 && loaded.current() == 9)) return 0;
+    if (!check("Testing saving and loading an empty sequence",
+               test.save_checkpoint(CHECKPOINT_PATH)
+               && loaded.load_checkpoint(CHECKPOINT_PATH)
+               && loaded.size() == 0 && !loaded.is_item())) return 0;
+
+    cout << "Making " << STEPS << " random inserts, attaches, removals and ";
+    cout << "cursor moves,\nsaving a checkpoint every 100 steps and loading ";
+    cout << "it into another sequence ... ";
+    cout.flush();
+    for (step = 0; answer && step < STEPS; step++)
+    {
+        edit_alike(test, items, used, cursor, random, VALUES, 3);
+        if (step % 100 == 99)
+            answer = test.save_checkpoint(CHECKPOINT_PATH)
+                && loaded.load_checkpoint(CHECKPOINT_PATH)
+                && same_items(loaded, items, used, 0)
+                && same_items(test, items, used, cursor);
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    while (test.is_item())
+        test.advance();
+    for (i = used; i < MANY; i++)
+    {
+        test.attach(i);
+        items[i] = i;
+    }
+    used = MANY;
+    answer = test.save_checkpoint(CHECKPOINT_PATH);
+    before = data_bytes();
+    test.attach(MANY);
+    items[used++] = MANY;
+    answer = answer && test.save_checkpoint(CHECKPOINT_PATH)
+        && data_bytes() - before <= BLOCK_BYTES;
+    test.start();
+    test.remove_current();
+    for (i = 0, used--; i < used; i++)
+        items[i] = items[i + 1];
+    answer = answer && test.save_checkpoint(CHECKPOINT_PATH);
+    before = data_bytes();
+    for (i = 0; i < 8 * checkpoint_file::BLOCK_ITEMS; i++)
+        test.advance();
+    test.remove_current();
+    for (used--; i < used; i++)
+        items[i] = items[i + 1];
+    answer = answer && test.save_checkpoint(CHECKPOINT_PATH)
+        && data_bytes() - before <= 3 * BLOCK_BYTES
+        && loaded.load_checkpoint(CHECKPOINT_PATH)
+        && same_items(loaded, items, used, 0);
+    if (!check("Testing that a save writes only the blocks from the first "
+               "one changed", answer)) return 0;
+
+    file = fopen(CHECKPOINT_PATH, "wb");
+    answer = (file != NULL && fwrite("SEQ", 1, 3, file) == 3);
+    if (file != NULL)
+        fclose(file);
+    loaded.start();
+    answer = answer && !loaded.load_checkpoint(CHECKPOINT_PATH)
+        && same_items(loaded, items, used, 0);
+    remove_checkpoint();
+    if (!check("Testing that a cut-short checkpoint doesn't load", answer))
+        return 0;
+
+    // All tests passed
+    cout << "All tests of this thirtieth function have been passed.";
+    cout << endl;
+    return POINTS[30];
+}
+
+// **************************************************************************
+// void remove_log()
+//   Removes the log at LOG_PATH and its snapshots, if any.
+// **************************************************************************
+void remove_log()
+{
+    const char* FILES[10] = { ".log", ".log.tmp", ".snap0", ".snap0.0",
+        ".snap0.1", ".snap0.tmp", ".snap1", ".snap1.0", ".snap1.1",
+        ".snap1.tmp" };
+    string path = LOG_PATH;
+    size_t i;
+
+    for (i = 0; i < 10; i++)
+        remove((path + FILES[i]).c_str());
+}
+
+
+// **************************************************************************
+// bool append_to_log(const void* bytes, size_t count)
+//   Appends count bytes to the log at LOG_PATH, as a crash part way through
+//   a commit, or a damaged disk, might leave them. Returns true if it could.
+// **************************************************************************
+bool append_to_log(const void* bytes, size_t count)
+{
+    string path = LOG_PATH;
+    FILE* file = fopen((path + ".log").c_str(), "ab");
+    bool answer;
+
+    if (file == NULL)
+        return false;
+    answer = (fwrite(bytes, 1, count, file) == count);
+    return (fclose(file) == 0) && answer;
+}
+
+
+// **************************************************************************
+// int test31()
+//   Performs tests of logged_sequence: recovery after a long run of random
+//   edits with commits and checkpoints along the way, compared with a copy
+//   of the items kept in an array, and recovery from a log whose last
+//   group was cut short or has a damaged length.
+//   Returns POINTS[31] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test31()
+{
+    const size_t STEPS = 1000;
+    const double VALUES[4] = { 1.5, 2.5, -3, 1e300 };
+    const unsigned char TORN[5] = { 7, 0, 0, 0, 'A' };
+    const unsigned long BOGUS[3] = { ~0UL >> 16, 0, 0 };
+    double items[STEPS + 1];
+    size_t used = 0, cursor = 0;
+    size_t step;
+    unsigned long random = 29;
+    bool answer = true;
+
+    remove_log();
+    {
+        logged_sequence test(LOG_PATH, 4);
+        answer = test.good() && test.size() == 0 && !test.is_item();
+    }
+    {
+        logged_sequence test(LOG_PATH, 4);
+        answer = answer && test.good() && test.size() == 0;
+    }
+    if (!check("Testing a new log, and opening it again", answer)) return 0;
+
+    cout << "Making " << STEPS << " random inserts, attaches, removals and ";
+    cout << "cursor moves\non a logged sequence with groups of 4, committing ";
+    cout << "every 50 steps and\nmaking a checkpoint every 300, then opening ";
+    cout << "the log again ... ";
+    cout.flush();
+    {
+        logged_sequence test(LOG_PATH, 4);
+        for (step = 0; answer && step < STEPS; step++)
+        {
+            edit_alike(test, items, used, cursor, random, VALUES, 4);
+            answer = test.pending() < 4
+                && same_items(test.contents(), items, used, cursor);
+            if (step % 50 == 49)
+                answer = answer && test.commit() && test.pending() == 0;
+            if (step % 300 == 299)
+                answer = answer && test.checkpoint();
+        }
+    }
+    {
+        logged_sequence test(LOG_PATH, 16);
+        answer = answer && test.good()
+            && same_items(test.contents(), items, used, cursor);
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    answer = append_to_log(TORN, sizeof(TORN));
+    {
+        logged_sequence test(LOG_PATH);
+        answer = answer && test.good()
+            && same_items(test.contents(), items, used, cursor);
+        test.start();
+        test.insert(4);
+    }
+    for (step = used; step > 0; step--)
+        items[step] = items[step - 1];
+    items[0] = 4;
+    used++;
+    cursor = 0;
+    {
+        logged_sequence test(LOG_PATH);
+        answer = answer && test.good()
+            && same_items(test.contents(), items, used, cursor);
+    }
+    if (!check("Testing recovery from a group cut short, and logging after "
+               "it", answer)) return 0;
+
+    answer = append_to_log(BOGUS, sizeof(BOGUS));
+    {
+        logged_sequence test(LOG_PATH);
+        answer = answer && test.good()
+            && same_items(test.contents(), items, used, cursor);
+    }
+    remove_log();
+    if (!check("Testing recovery from a group with a huge length", answer))
+        return 0;
+
+    // All tests passed
+    cout << "All tests of this thirty-first function have been passed.";
+    cout << endl;
+    return POINTS[31];
+}
+
+// **************************************************************************
+// bool shared_alike(const shared_sequence& writer,
+//                   const shared_sequence& reader, const double items[],
+//                   size_t used, size_t cursor)
+//   Returns true if writer holds the used items of the array, with its
+//   current item at cursor, and reader gets the same items by position.
+// **************************************************************************
+bool shared_alike(const shared_sequence& writer,
+                  const shared_sequence& reader, const double items[],
+                  size_t used, size_t cursor)
+{
+    double item = -1;
+    size_t i;
+
+    if (writer.size() != used || reader.size() != used
+        || writer.is_item() != (cursor < used)
+        || (cursor < used && writer.current() != items[cursor]))
+        return false;
+    for (i = 0; i < used; i++)
+        if (!reader.get(i, item) || item != items[i])
+            return false;
+    return !reader.get(used, item) && item == (used > 0 ? items[used-1] : -1);
+}
+
+
+// **************************************************************************
+// int test32()
+//   Performs tests of shared_sequence: a writer making a long run of
+//   random edits, read by position and by snapshot through a reader and
+//   compared with a copy of the items kept in an array, and shared
+//   sequences that can't be made or opened.
+//   Returns POINTS[32] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test32()
+{
+    const size_t STEPS = 1000;
+    const size_t ROOM = STEPS + 1;
+    const double VALUES[3] = { -1, 0.25, 8 };
+    double items[ROOM];
+    size_t used = 0, cursor = 0;
+    size_t step;
+    unsigned long random = 31, version;
+    sequence copy;
+    bool answer = true;
+
+    shared_sequence writer(SHARED_NAME, ROOM);
+    shared_sequence reader(SHARED_NAME);
+    if (!check("Testing a new shared sequence, and a reader of it",
+               writer.good() && writer.is_writer() && reader.good()
+               && !reader.is_writer() && reader.capacity() == ROOM
+               && shared_alike(writer, reader, items, 0, 0)
+               && reader.snapshot(copy) % 2 == 0 && copy.size() == 0))
+        return 0;
+
+    cout << "Making " << STEPS << " random inserts, attaches, removals and ";
+    cout << "cursor moves\nwith the writer, after each one reading every ";
+    cout << "item with the reader,\nand taking a snapshot every 50 ... ";
+    cout.flush();
+    version = reader.version();
+    for (step = 0; answer && step < STEPS; step++)
+    {
+        edit_alike(writer, items, used, cursor, random, VALUES, 3);
+        answer = shared_alike(writer, reader, items, used, cursor)
+            && reader.version() % 2 == 0 && reader.version() >= version;
+        version = reader.version();
+        if (step % 50 == 0)
+            answer = answer && reader.snapshot(copy) == version
+                && same_items(copy, items, used, 0);
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    reader.snapshot(copy);
+    copy.remove_current();
+    writer.assign(copy);
+    for (step = 0; step + 1 < used; step++)
+        items[step] = items[step + 1];
+    used--;
+    if (!check("Testing assign, which leaves the writer no current item",
+               used > 0 && shared_alike(writer, reader, items, used, used)
+               && reader.version() == version + 2)) return 0;
+
+    cout << "Edge cases: a reader of a missing name, and a writer with a ";
+    cout << "capacity too large\nto map, under the name in use." << endl;
+    shared_sequence missing(MISSING_NAME);
+    shared_sequence huge(SHARED_NAME, size_t(-1) / sizeof(double));
+    shared_sequence after(SHARED_NAME);
+    if (!check("Testing that neither can be used, and the first shared "
+               "sequence is still there", !missing.good() && !huge.good()
+               && after.good() && after.size() == used)) return 0;
+
+    // All tests passed
+    cout << "All tests of this thirty-second function have been passed.";
+    cout << endl;
+    return POINTS[32];
+}
+
+// **************************************************************************
+// int test33()
+//   Performs tests of the command protocol: batches of random commands run
+//   by run_commands, fed to it a few bytes at a time and with a limit on
+//   the replies, then read back by get_reply and compared with the same
+//   commands carried out on a copy of the items kept in an array.
+//   Returns POINTS[33] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test33()
+{
+    const size_t BATCHES = 60;
+    const size_t BATCH = 50;
+    const size_t ROOM = BATCHES * BATCH + 1;
+    const char LETTERS[] = "!+?CSIARJTZ";
+    const size_t LIMIT = 16;
+    double items[ROOM], printed[ROOM];
+    char ops[BATCH];
+    bool oks[BATCH];
+    double values[BATCH];
+    size_t counts[BATCH];
+    size_t used = 0, cursor = 0, shown = 0;
+    size_t batch, k, i, next, took;
+    unsigned long random = 37;
+    double value;
+    string commands, input, replies, part;
+    command_reply reply, unread;
+    sequence target;
+    bool answer = true;
+
+    cout << "Running " << BATCHES << " batches of " << BATCH << " random ";
+    cout << "commands, each fed to run_commands\nup to 40 bytes at a time, ";
+    cout << "every other time with a limit of " << LIMIT << " bytes of\n";
+    cout << "replies, and checking each reply ... ";
+    cout.flush();
+    for (batch = 0; answer && batch < BATCHES; batch++)
+    {
+        commands.erase();
+        for (k = 0; k < BATCH; k++)
+        {
+            random = (random * 1103515245 + 12345) % 2147483648UL;
+            ops[k] = (k == BATCH / 2) ? 'P' : LETTERS[(random >> 16) % 11];
+            value = double((random >> 8) % 7);
+            if (ops[k] == 'J')
+                value = double((random >> 8) % (used + 2));
+            put_command(commands, ops[k], value);
+
+            // What the command should do, and reply.
+            oks[k] = true;
+            switch (ops[k])
+            {
+            case '!':
+                cursor = 0;
+                break;
+            case '+':
+                oks[k] = (cursor < used);
+                if (oks[k])
+                    cursor++;
+                break;
+            case '?':
+                oks[k] = (cursor < used);
+                break;
+            case 'C':
+                oks[k] = (cursor < used);
+                if (oks[k])
+                    values[k] = items[cursor];
+                break;
+            case 'I':
+            case 'A':
+                if (ops[k] == 'I' && cursor == used)
+                    cursor = 0;
+                if (ops[k] == 'A')
+                    cursor = (cursor == used) ? used : cursor + 1;
+                for (i = used; i > cursor; i--)
+                    items[i] = items[i-1];
+                items[cursor] = value;
+                used++;
+                break;
+            case 'R':
+                oks[k] = (cursor < used);
+                if (!oks[k])
+                    break;
+                for (i = cursor; i + 1 < used; i++)
+                    items[i] = items[i+1];
+                used--;
+                break;
+            case 'J':
+                cursor = (size_t(value) < used) ? size_t(value) : used;
+                oks[k] = (cursor < used);
+                break;
+            case 'T':
+                for (i = 0, values[k] = 0; i < used; i++)
+                    values[k] += items[i];
+                break;
+            case 'S':
+                counts[k] = used;
+                break;
+            case 'P':
+                counts[k] = shown = used;
+                for (i = 0; i < used; i++)
+                    printed[i] = items[i];
+                break;
+            default:
+                oks[k] = false;
+                break;
+            }
+        }
+
+        // Feed the commands a few bytes at a time.
+        replies.erase();
+        input.erase();
+        for (next = 0; answer && next < commands.size(); next += took)
+        {
+            random = (random * 1103515245 + 12345) % 2147483648UL;
+            took = 1 + (random >> 16) % 40;
+            input.append(commands, next, took);
+            part.erase();
+            if (batch % 2 == 0)
+                i = run_commands(target, input.data(), input.size(), part);
+            else
+                i = run_commands(target, input.data(), input.size(), part,
+                                 LIMIT);
+            input.erase(0, i);
+            replies += part;
+        }
+        while (answer && !input.empty())
+        {
+            part.erase();
+            i = run_commands(target, input.data(), input.size(), part,
+                             LIMIT);
+            input.erase(0, i);
+            replies += part;
+            answer = (i > 0);
+        }
+
+        // Read the replies back.
+        for (k = 0, next = 0; answer && k < BATCH; k++, next += took)
+        {
+            took = get_reply(ops[k], replies.data() + next,
+                             replies.size() - next, reply);
+            answer = took > 0 && reply.ok == oks[k]
+                && get_reply(ops[k], replies.data() + next, took - 1,
+                             unread) == 0;
+            if (answer && oks[k] && (ops[k] == 'C' || ops[k] == 'T'))
+                answer = (reply.value == values[k]);
+            if (answer && (ops[k] == 'S' || ops[k] == 'P'))
+                answer = (reply.count == counts[k]);
+            if (answer && ops[k] == 'P')
+                // The items are attached, so the last one is current.
+                answer = same_items(reply.items, printed, shown,
+                                    (shown > 0) ? shown - 1 : 0);
+        }
+        answer = answer && next == replies.size()
+            && same_items(target, items, used, cursor);
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    cout << "Edge cases: no input, a limit of 0, and a limit already ";
+    cout << "reached." << endl;
+    commands.erase();
+    put_command(commands, 'S');
+    put_command(commands, 'P');
+    part = "x";
+    if (!check("Testing that none of them runs a command",
+               run_commands(target, commands.data(), 0, part) == 0
+               && run_commands(target, commands.data(), commands.size(),
+                               part, 0) == 0
+               && run_commands(target, commands.data(), commands.size(),
+                               part, 1) == 0
+               && part == "x")) return 0;
+    if (!check("Testing that a limit of 2 runs just the first command",
+               run_commands(target, commands.data(), commands.size(),
+                            part, 2) == 1
+               && part.size() == 2 + sizeof(unsigned long)))
+        return 0;
+
+    // All tests passed
+    cout << "All tests of this thirty-third function have been passed.";
+    cout << endl;
+    return POINTS[33];
+}
+
+// **************************************************************************
+// int test34()
+//   Performs tests of sharded_sequence: a long run of random edits over
+//   three shards, with sums, gathers, a rebalance and a scan, compared
+//   with a copy of the items kept in an array; and answers to commands
+//   queued just as the number of unread replies reaches its limit.
+//   Returns POINTS[34] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test34()
+{
+    const size_t STEPS = 2000;
+    const double VALUES[4] = { 1, 2, 4, -8 };
+    double items[STEPS + 1];
+    size_t used = 0, cursor = 0;
+    size_t step, i, many, total;
+    unsigned long random = 41;
+    double sum;
+    sequence dest, source;
+    bool answer = true;
+
+    cout << "Making " << STEPS << " random inserts, attaches, removals and ";
+    cout << "cursor moves\nover 3 shards, checking the current item after ";
+    cout << "each one, the sum every 50,\nand gathering every 200 ... ";
+    cout.flush();
+    {
+        sharded_sequence test(3);
+        answer = test.good() && test.shards() == 3 && test.size() == 0
+            && test.sum() == 0;
+        for (step = 0; answer && step < STEPS; step++)
+        {
+            edit_alike(test, items, used, cursor, random, VALUES, 4);
+            answer = test.size() == used && test.is_item() == (cursor < used)
+                && (cursor == used || test.current() == items[cursor]);
+            if (step % 50 == 0)
+            {
+                for (i = 0, sum = 0; i < used; i++)
+                    sum += items[i];
+                answer = answer && test.sum() == sum;
+            }
+            if (step % 200 == 0)
+            {
+                test.gather(dest);
+                answer = answer && same_items(dest, items, used, 0);
+            }
+        }
+        answer = answer && test.good();
+        cout << (answer ? "Passed." : "Failed.") << endl;
+        if (!answer) return 0;
+
+        test.rebalance();
+        for (i = 0, total = 0; i < 3; i++)
+        {
+            total += test.shard_size(i);
+            answer = answer && test.shard_size(i) >= used / 3
+                && test.shard_size(i) <= used / 3 + 1;
+        }
+        test.gather(dest);
+        if (!check("Testing rebalance", answer && total == used
+                   && !test.is_item() && same_items(dest, items, used, 0)))
+            return 0;
+
+        test.exclusive_scan(0.5);
+        for (i = 0, sum = 0.5; i < used; i++)
+        {
+            sum += items[i];
+            items[i] = sum - items[i];
+        }
+        test.gather(dest);
+        if (!check("Testing exclusive_scan from 0.5", test.good()
+                   && same_items(dest, items, used, 0)
+                   && test.is_item() && test.current() == 0.5)) return 0;
+
+        test.assign(source);
+        test.exclusive_scan();
+        if (!check("Testing an empty sequence assigned and scanned",
+                   test.good() && test.size() == 0 && !test.is_item()
+                   && test.sum() == 0)) return 0;
+    }
+
+    cout << "Queueing 4090 to 4099 inserts (on 2 shards) or starts (on 1) ";
+    cout << "before asking\nfor the sum, current item or scan, so that the ";
+    cout << "question is queued just\nas the unread replies reach their ";
+    cout << "limit ... ";
+    cout.flush();
+    for (many = 4090; answer && many < 4100; many++)
+    {
+        sharded_sequence two(2), one(1);
+        for (i = 0; i < many; i++)
+            two.insert(1);
+        one.attach(7);
+        for (i = 0; i < many; i++)
+            one.start();
+        answer = two.sum() == many && one.current() == 7;
+        one.exclusive_scan(3);
+        answer = answer && one.current() == 3 && two.good() && one.good();
+    }
+    cout << (answer ? "Passed." : "Failed.") << endl;
+    if (!answer) return 0;
+
+    // All tests passed
+    cout << "All tests of this thirty-fourth function have been passed.";
+    cout << endl;
+    return POINTS[34];
+}
+
 int run_a_test(int number, const char message[], int test_function(), int max)
 {
     int result;
@@ -763,6 +3537,33 @@ int main()
     sum += run_a_test(5, DESCRIPTION[5], test5, POINTS[5]);
     sum += run_a_test(6, DESCRIPTION[6], test6, POINTS[6]);
     sum += run_a_test(7, DESCRIPTION[7], test7, POINTS[7]);
+    sum += run_a_test(8, DESCRIPTION[8], test8, POINTS[8]);
+    sum += run_a_test(9, DESCRIPTION[9], test9, POINTS[9]);
+    sum += run_a_test(10, DESCRIPTION[10], test10, POINTS[10]);
+    sum += run_a_test(11, DESCRIPTION[11], test11, POINTS[11]);
+    sum += run_a_test(12, DESCRIPTION[12], test12, POINTS[12]);
+    sum += run_a_test(13, DESCRIPTION[13], test13, POINTS[13]);
+    sum += run_a_test(14, DESCRIPTION[14], test14, POINTS[14]);
+    sum += run_a_test(15, DESCRIPTION[15], test15, POINTS[15]);
+    sum += run_a_test(16, DESCRIPTION[16], test16, POINTS[16]);
+    sum += run_a_test(17, DESCRIPTION[17], test17, POINTS[17]);
+    sum += run_a_test(18, DESCRIPTION[18], test18, POINTS[18]);
+    sum += run_a_test(19, DESCRIPTION[19], test19, POINTS[19]);
+    sum += run_a_test(20, DESCRIPTION[20], test20, POINTS[20]);
+    sum += run_a_test(21, DESCRIPTION[21], test21, POINTS[21]);
+    sum += run_a_test(22, DESCRIPTION[22], test22, POINTS[22]);
+    sum += run_a_test(23, DESCRIPTION[23], test23, POINTS[23]);
+    sum += run_a_test(24, DESCRIPTION[24], test24, POINTS[24]);
+    sum += run_a_test(25, DESCRIPTION[25], test25, POINTS[25]);
+    sum += run_a_test(26, DESCRIPTION[26], test26, POINTS[26]);
+    sum += run_a_test(27, DESCRIPTION[27], test27, POINTS[27]);
+    sum += run_a_test(28, DESCRIPTION[28], test28, POINTS[28]);
+    sum += run_a_test(29, DESCRIPTION[29], test29, POINTS[29]);
+    sum += run_a_test(30, DESCRIPTION[30], test30, POINTS[30]);
+    sum += run_a_test(31, DESCRIPTION[31], test31, POINTS[31]);
+    sum += run_a_test(32, DESCRIPTION[32], test32, POINTS[32]);
+    sum += run_a_test(33, DESCRIPTION[33], test33, POINTS[33]);
+    sum += run_a_test(34, DESCRIPTION[34], test34, POINTS[34]);
 
     cout << "Your sequence implementation has scored\n";
     cout << sum << " points out of the " << POINTS[0];
@@ -37,17 +37,58 @@
 //                postcondition for the function for both of the two
 //                possible scenarios (current item is and is not the
 //                last item in the sequence).
+//   5. If the sequence keeps a value index (see enable_index), the
+//      member variable position_index points to it; otherwise it is
+//      NULL. Every change to the items is reported to the index:
+//      insert, attach and remove_current report the position they
+//      changed, and anything else that writes to data calls
+//      items_changed.
+//   6. Likewise, membership points to the sequence's membership filter
+//      (see enable_filter) or is NULL, and is told of every change to
+//      the items in the same way.
+//   7. If the sequence was made with a pool, pool points to it and data
+//      was acquired from it (with exactly capacity items); otherwise
+//      pool is NULL and data came from new.
+//   8. In lazy removal mode (lazy_remove is true) some of data[0]
+//      through data[used-1] may be dead: removed, but not yet squeezed
+//      out. dead_count is the number of dead slots, so the sequence has
+//      used - dead_count items. When it's 0, dead_slots is NULL;
+//      otherwise dead_slots is a bitmap in which bit i (of word i /
+//      WORD_BITS) is set if data[i] is dead. current_index is never a
+//      dead slot, so the rules of invariant #4 still hold.
+//   9. If the sequence keeps handles (see enable_handles), handles is a
+//      handle_table that is told of every insert, remove and move of an
+//      item in data, and of every replacement of all of them; otherwise
+//      handles is NULL.
+//  10. If the sequence keeps track of changed blocks (see
+//      enable_checkpoints), checkpoints is a checkpoint_file that is
+//      told the first position of every change to the items in data;
+//      otherwise checkpoints is NULL.
 
 #include <cassert>
+#include <climits>     // provides CHAR_BIT
 #include "Sequence.h"
+#include "SequenceIndex.h"
+#include "SequenceFilter.h"
+#include "SequencePool.h"
+#include "SequenceHandle.h"
+#include "SequenceCheckpoint.h"
 
 using namespace std;
 
 namespace CS3358_FA2017
 {
+   namespace
+   {
+      const sequence::size_type WORD_BITS = CHAR_BIT * sizeof(unsigned long);
+   }
+
    // CONSTRUCTORS and DESTRUCTOR
    sequence::sequence(size_type initial_capacity) : used(0), current_index(0)
-           , capacity(initial_capacity)
+           , capacity(initial_capacity), position_index(NULL)
+           , membership(NULL), pool(NULL), handles(NULL)
+           , checkpoints(NULL), lazy_remove(false), dead_slots(NULL)
+           , dead_count(0)
    {
        // Check initial_capacity validity per pre-condition
        // requirements for function stub listed in Sequence.h
@@ -57,24 +98,60 @@ namespace CS3358_FA2017
        data = new value_type[capacity];
    }
 
+   sequence::sequence(sequence_pool& pool, size_type initial_capacity) :
+           used(0), current_index(0), capacity(initial_capacity),
+           position_index(NULL), membership(NULL), pool(&pool),
+           handles(NULL), checkpoints(NULL), lazy_remove(false),
+           dead_slots(NULL), dead_count(0)
+   {
+       if(initial_capacity < 1){capacity = 1;}
+
+       // The pool may round capacity up to one of its size classes.
+       data = allocate_items(capacity);
+   }
+
    sequence::sequence(const sequence& source) :
-           used(source.used), current_index(source.current_index),
-           capacity(source.capacity)
+           used(0), current_index(0), capacity(source.capacity),
+           position_index(NULL), membership(NULL), pool(source.pool),
+           handles(NULL), checkpoints(NULL), lazy_remove(source.lazy_remove),
+           dead_slots(NULL), dead_count(0)
    {
+       // Squeeze any dead slots out of source, so only its items are
+       // copied.
+       source.pack();
+       used = source.used;
+       current_index = source.current_index;
+
        // Create new dynamic array for this data pointer.
-       data = new value_type[capacity];
+       data = allocate_items(capacity);
 
        // Copy data from source to this data.
        for (size_type index = 0; index < used; ++index) {
            data[index] = source.data[index];
        }
 
+       // A copy gets an index and filter of its own, built on its first
+       // lookup, and a table of handles with none handed out yet.
+       if(source.position_index != NULL){enable_index();}
+       if(source.membership != NULL){enable_filter();}
+       if(source.handles != NULL){enable_handles();}
+       if(source.checkpoints != NULL){enable_checkpoints();}
    }
    sequence::~sequence()
    {
        // Free up dynamic memory and point to 0.
-       delete [] data;
+       release_items(data, capacity);
        data = NULL;
+       delete position_index;
+       position_index = NULL;
+       delete membership;
+       membership = NULL;
+       delete [] dead_slots;
+       dead_slots = NULL;
+       delete handles;
+       handles = NULL;
+       delete checkpoints;
+       checkpoints = NULL;
    }
 
    // MODIFICATION MEMBER FUNCTIONS
@@ -83,11 +160,10 @@ namespace CS3358_FA2017
        // Check validity of new_capacity to ensure it's inline
        // with class invariant.
        if(new_capacity < 1){new_capacity = 1;}
-       if(new_capacity < used) {capacity = used;}
-       else {capacity = new_capacity;}
+       if(new_capacity < used) {new_capacity = used;}
 
        // Create new dynamic array based on adjusted capacity.
-       value_type *temp_data = new value_type[capacity];
+       value_type *temp_data = allocate_items(new_capacity);
 
        // Copy contents of dynamic array to new location.
        for (size_type index = 0; index < used; ++index) {
@@ -95,7 +171,8 @@ namespace CS3358_FA2017
        }
 
        // Deallocate the space used by previous data array.
-       delete [] data;
+       release_items(data, capacity);
+       capacity = new_capacity;
 
        // Move new dynamic array back to private member data.
        data = temp_data;
@@ -107,8 +184,9 @@ namespace CS3358_FA2017
        // has items then current_index is the first item in sequence data[0]
        // or current_index == 0 otherwise there's no current item. According
        // to invariant #4 if there's no current item then current_index == used
+       // In lazy removal mode the first item is the first live slot.
 
-       current_index = 0;
+       current_index = next_live(0);
 
    }
 
@@ -120,12 +198,15 @@ namespace CS3358_FA2017
 
        // According to invariant #4 if there's no current item then
        // current_index == used. Otherwise the current item is the item
-       // after current_index.
-       current_index = current_index+1;
+       // after current_index, skipping any dead slots (invariant #8).
+       current_index = next_live(current_index+1);
    }
 
    void sequence::insert(const value_type& entry)
    {
+       // Shifting items past dead slots would move them too.
+       pack();
+
        // Check to see if we need to resize the dynamic array. If
        // we do the multiple current capacity by 1.25 and add +1 to
        // satisfy the resize rule.
@@ -134,11 +215,11 @@ namespace CS3358_FA2017
        if(!is_item()) {
 
            // There's NO current item. Insert entry at the beginning of the
-           // sequence or current_index == 0. Starting from used + 1 shift
+           // sequence or current_index == 0. Starting from used shift
            // item's towards used to accommodate inserting entry at beginning
            // of sequence.
            current_index = 0;
-           for(size_type index = used + 1; index > current_index; --index){
+           for(size_type index = used; index > current_index; --index){
                data[index] = data[index-1];
            }
            data[current_index] = entry;
@@ -147,19 +228,29 @@ namespace CS3358_FA2017
        } else {
 
            // There IS a current item. Insert entry prior to the current item
-           // or current_index - 1. Starting from used + 1 shift item's towards
+           // or current_index - 1. Starting from used shift item's towards
            // used to accommodate inserting entry prior to current item.
-           for(size_type index = used + 1; index > current_index; --index){
+           for(size_type index = used; index > current_index; --index){
                data[index] = data[index-1];
            }
            data[current_index] = entry;
            ++used;
        }
 
+       // Let the index, filter, handles and checkpoints know of the new
+       // item (invariants #5, #6, #9 and #10).
+       if(position_index != NULL) {
+           position_index->note_insert(data, used, current_index);
+       }
+       if(membership != NULL){membership->note_insert(entry);}
+       if(handles != NULL){handles->note_insert(used, current_index);}
+       if(checkpoints != NULL){checkpoints->note_change(current_index);}
    }
 
    void sequence::attach(const value_type& entry)
    {
+       pack();
+
        // Check to see if we need to resize the dynamic array. If
        // we do the multiple current capacity by 1.25 and add +1 to
        // satisfy the resize rule.
@@ -182,12 +273,21 @@ namespace CS3358_FA2017
            // after original current_index.
            current_index = current_index+1;
 
-           for (size_type index = used + 1; index > current_index; --index) {
+           for (size_type index = used; index > current_index; --index) {
                data[index] = data[index-1];
            }
            data[current_index] = entry; // current_index + 1 = entry
            ++used;
        }
+
+       // Let the index, filter, handles and checkpoints know of the new
+       // item (invariants #5, #6, #9 and #10).
+       if(position_index != NULL) {
+           position_index->note_insert(data, used, current_index);
+       }
+       if(membership != NULL){membership->note_insert(entry);}
+       if(handles != NULL){handles->note_insert(used, current_index);}
+       if(checkpoints != NULL){checkpoints->note_change(current_index);}
    }
 
    void sequence::remove_current()
@@ -202,14 +302,226 @@ namespace CS3358_FA2017
        // to invariant #4 if there's no current item then current_index == used.
        //current_index == used-1
 
+       if(lazy_remove) {
+
+           // Mark the slot dead instead of shifting (invariant #8), and
+           // squeeze the dead slots out once they're more than half.
+           if(dead_slots == NULL) {
+               size_type words = (used + WORD_BITS - 1) / WORD_BITS;
+               dead_slots = new unsigned long[words];
+               for (size_type word = 0; word < words; ++word) {
+                   dead_slots[word] = 0;
+               }
+           }
+           dead_slots[current_index / WORD_BITS] |=
+                   1UL << (current_index % WORD_BITS);
+           ++dead_count;
+           if(membership != NULL){membership->note_remove();}
+           if(handles != NULL){handles->note_kill(current_index);}
+           current_index = next_live(current_index+1);
+           if(2 * dead_count > used){pack();}
+           return;
+       }
 
        // Valid current item. Remove current and shift items to the left.
+       value_type removed = data[current_index];
        for (size_type index = current_index; index < used-1; ++index) {
            data[index] = data[index + 1];
        }
        // Update used after removing item.
        --used;
+       if(position_index != NULL) {
+           position_index->note_remove(data, used, current_index, removed);
+       }
+       if(membership != NULL){membership->note_remove();}
+       if(handles != NULL){handles->note_remove(used, current_index);}
+       if(checkpoints != NULL){checkpoints->note_change(current_index);}
+   }
+
+   void sequence::enable_lazy_remove()
+   {
+       lazy_remove = true;
+   }
+
+   void sequence::disable_lazy_remove()
+   {
+       pack();
+       lazy_remove = false;
+   }
+
+   void sequence::compact()
+   {
+       pack();
+   }
+
+   void sequence::enable_index()
+   {
+       // The new index starts out with nothing trusted, so it's built
+       // from scratch by the first seek_to.
+       if(position_index == NULL){position_index = new value_index;}
+   }
+
+   void sequence::disable_index()
+   {
+       delete position_index;
+       position_index = NULL;
+   }
 
+   bool sequence::seek_to(const value_type& target)
+   {
+       size_type position;
+
+       pack();
+
+       if(position_index != NULL) {
+           if(!position_index->find(data, used, target, position)) {
+               return false;
+           }
+           current_index = position;
+           return true;
+       }
+
+       // No index: scan from the front for the first occurrence.
+       for (position = 0; position < used; ++position) {
+           if(data[position] == target) {
+               current_index = position;
+               return true;
+           }
+       }
+       return false;
+   }
+
+   bool sequence::interpolation_seek(const value_type& target)
+   {
+       // The first item not less than target is in data[low..high]
+       // (high meaning there is none).
+       pack();
+       size_type low = 0;
+       size_type high = used;
+       bool interpolate = true;
+       while (high - low > 8) {
+           const value_type& first = data[low];
+           const value_type& last = data[high - 1];
+           if(!(first < target)){high = low; break;}
+           if(last < target){low = high; break;}
+
+           // Guess by interpolating between first and last, unless the
+           // last guess left more than half of the range it started with.
+           // fraction is NaN or out of range if the items are infinite.
+           size_type span = high - low;
+           size_type guess = low + span / 2;
+           double fraction = (target - first) / (last - first);
+           if(interpolate && fraction >= 0 && fraction <= 1) {
+               guess = low + size_type(fraction * (span - 1));
+           }
+
+           if(data[guess] < target){low = guess + 1;}
+           else {high = guess;}
+           interpolate = (2 * (high - low) <= span);
+       }
+       return seek_in(low, high, target);
+   }
+
+   bool sequence::gallop_seek(const value_type& target)
+   {
+       pack();
+       size_type low, high;
+       size_type step = 1;
+       if(current_index < used && data[current_index] < target) {
+
+           // The answer is after the current item. Step forward until an
+           // item isn't less than target.
+           low = current_index + 1;
+           high = low;
+           while (high < used && data[high] < target) {
+               low = high + 1;
+               high = (used - high > step) ? high + step : used;
+               step *= 2;
+           }
+
+       } else {
+
+           // The answer is the current item or before it. Step back
+           // until an item is less than target.
+           high = current_index;
+           low = high;
+           while (low > 0 && !(data[low - 1] < target)) {
+               high = low - 1;
+               low = (high > step) ? high - step : 0;
+               step *= 2;
+           }
+       }
+       return seek_in(low, high, target);
+   }
+
+   void sequence::enable_filter()
+   {
+       // Like the index, the new filter is built by the first lookup.
+       if(membership == NULL){membership = new membership_filter;}
+   }
+
+   void sequence::disable_filter()
+   {
+       delete membership;
+       membership = NULL;
+   }
+
+   void sequence::enable_handles()
+   {
+       if(handles == NULL){handles = new handle_table(used);}
+   }
+
+   void sequence::disable_handles()
+   {
+       delete handles;
+       handles = NULL;
+   }
+
+   bool sequence::seek_handle(const item_handle& handle)
+   {
+       // Protect pre-condition.
+       assert(handles != NULL);
+
+       // A handle's item is never a dead slot (remove_current drops its
+       // handle when it marks the slot), so there's no need to pack.
+       size_type position;
+       if(!handles->find(handle, used, position)){return false;}
+       current_index = position;
+       return true;
+   }
+
+   void sequence::enable_checkpoints()
+   {
+       if(checkpoints == NULL){checkpoints = new checkpoint_file;}
+   }
+
+   void sequence::disable_checkpoints()
+   {
+       delete checkpoints;
+       checkpoints = NULL;
+   }
+
+   bool sequence::load_checkpoint(const char* path)
+   {
+       // Protect pre-condition.
+       assert(checkpoints != NULL);
+
+       // Read into a separate array, so a failed load leaves the
+       // sequence as it was.
+       value_type* items;
+       size_type count;
+       if(!checkpoints->load(path, items, count)){return false;}
+
+       value_type* target = begin_bulk_write(count);
+       for (size_type index = 0; index < count; ++index) {
+           target[index] = items[index];
+       }
+       delete [] items;
+       end_bulk_write(count);
+
+       // Every block is as it is on disk, whatever end_bulk_write says.
+       checkpoints->note_clean(used);
+       return true;
    }
 
    sequence& sequence::operator=(const sequence& source)
@@ -219,9 +531,13 @@ namespace CS3358_FA2017
        if (this == &source)
            return *this;
 
+       // Copy only the items of source, not its dead slots.
+       source.pack();
+
        // Create temporary dynamic array to safely assign contents
        // of array.
-       value_type *temp_data = new value_type[source.capacity];
+       size_type new_capacity = source.capacity;
+       value_type *temp_data = allocate_items(new_capacity);
 
        // Moved contents of rhs array to temp
        for (size_type index = 0; index < source.used; ++index) {
@@ -229,13 +545,26 @@ namespace CS3358_FA2017
        }
 
        // Deallocate old dynamic array.
-       delete [] data;
+       release_items(data, capacity);
+
+       // None of the old items is left, so none of their handles works.
+       if(handles != NULL){handles->note_replace(used, source.used);}
 
-       // Start assigning member variables from rhs.
+       // Start assigning member variables from rhs. This sequence keeps
+       // its own pool (if any), and its own removal mode.
        data = temp_data;
-       capacity = source.capacity;
+       capacity = new_capacity;
        used = source.used;
        current_index = source.current_index;
+       delete [] dead_slots;
+       dead_slots = NULL;
+       dead_count = 0;
+
+       // Every item may have changed. The sequence keeps its own index,
+       // filter and checkpoints, which items_changed tells that every
+       // item has changed, and its own handles (told of the new items
+       // above).
+       items_changed(0);
 
        return *this;
    }
@@ -244,8 +573,9 @@ namespace CS3358_FA2017
    sequence::size_type sequence::size() const
    {
        // Size equates to the number of items in a sequence this number
-       // is tracked by the private member variable used.
-       return used;
+       // is tracked by the private member variable used, less any dead
+       // slots (invariant #8).
+       return used - dead_count;
 
    }
 
@@ -265,5 +595,199 @@ namespace CS3358_FA2017
 
        return data[current_index];
    }
-}
 
+   bool sequence::contains(const value_type& target) const
+   {
+       // The filter turns down most values that aren't items without a
+       // scan. Rebuilding it (or the index) doesn't change the sequence,
+       // and both are reached through pointers, so a const function may
+       // use them.
+       pack();
+       if(membership != NULL &&
+          !membership->might_contain(data, used, target)) {
+           return false;
+       }
+
+       if(position_index != NULL) {
+           size_type position;
+           return position_index->find(data, used, target, position);
+       }
+
+       for (size_type index = 0; index < used; ++index) {
+           if(data[index] == target){return true;}
+       }
+       return false;
+   }
+
+   double sequence::filter_false_positive_rate() const
+   {
+       // Protect pre-condition.
+       assert(membership != NULL);
+
+       // As in contains(), rebuilding the filter doesn't change the
+       // sequence.
+       pack();
+       return membership->false_positive_rate(data, used);
+   }
+
+   bool sequence::save_checkpoint(const char* path) const
+   {
+       // Protect pre-condition.
+       assert(checkpoints != NULL);
+
+       // Dead slots aren't saved. Noting what's been saved doesn't
+       // change the sequence, so a const function may.
+       pack();
+       return checkpoints->save(path, data, used);
+   }
+
+   sequence::item_handle sequence::current_handle() const
+   {
+       // Protect pre-condition.
+       assert(handles != NULL);
+       assert(is_item());
+
+       // Giving the item a handle doesn't change the sequence, and the
+       // table is reached through a pointer, so a const function may.
+       return handles->handle_at(current_index);
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   sequence::value_type* sequence::allocate_items(size_type& count)
+   {
+       // Allocate an array for data, from the pool if there is one (see
+       // invariant #7). With a pool, count may be rounded up.
+       if(pool != NULL){return pool->acquire(count);}
+       return new value_type[count];
+   }
+
+   void sequence::release_items(value_type* items, size_type count)
+   {
+       if(pool != NULL){pool->release(items, count);}
+       else {delete [] items;}
+   }
+
+   sequence::value_type* sequence::begin_bulk_write(size_type max_items)
+   {
+       // Discard the current contents so resize() has nothing to copy,
+       // then grow only if the buffer can't hold max_items. When the
+       // buffer is already large enough it's left untouched, which lets
+       // a friend read and overwrite the same items in place.
+       pack();
+       if(handles != NULL){handles->note_replace(used, 0);}
+       used = 0;
+       current_index = 0;
+       if(max_items > capacity){resize(max_items);}
+
+       return data;
+   }
+
+   void sequence::end_bulk_write(size_type new_used)
+   {
+       // The friend has filled data[0] through data[new_used-1]. Make
+       // the first item (if any) the current item, as start() would.
+       assert(new_used <= capacity);
+       used = new_used;
+       current_index = 0;
+       if(handles != NULL){handles->note_replace(0, new_used);}
+       items_changed(0);
+   }
+
+   void sequence::copy_items(const sequence& source)
+   {
+       // Replace the items with source's through a bulk write. Unlike
+       // an assignment, this keeps the sequence's own index, filter,
+       // handles and checkpoints, so a friend that builds an in-place
+       // result in a temporary copies it back with this.
+       assert(this != &source);
+       source.pack();
+       value_type* target = begin_bulk_write(source.used);
+       for (size_type index = 0; index < source.used; ++index) {
+           target[index] = source.data[index];
+       }
+       end_bulk_write(source.used);
+   }
+
+   bool sequence::seek_in(size_type low, size_type high,
+                          const value_type& target)
+   {
+       // Binary search data[low..high] for the first item not less than
+       // target, knowing it's there (or that it's high), and make it the
+       // current item.
+       while (low < high) {
+           size_type middle = low + (high - low) / 2;
+           if(data[middle] < target){low = middle + 1;}
+           else {high = middle;}
+       }
+       current_index = low;
+       return (low < used && !(target < data[low]));
+   }
+
+   void sequence::items_changed(size_type first) const
+   {
+       // Items from position first on have been overwritten in place by a
+       // friend (or by a bulk write); tell the index and filter they can't
+       // be trusted, and the checkpoints they have to be saved again.
+       if(position_index != NULL){position_index->note_change(first);}
+       if(membership != NULL){membership->note_change();}
+       if(checkpoints != NULL){checkpoints->note_change(first);}
+   }
+
+   void sequence::pack() const
+   {
+       // Squeeze the dead slots out (invariant #8), moving each live item
+       // down over them in one pass. The current item moves with it.
+       if(dead_count == 0){return;}
+
+       size_type first_dead = 0;
+       while (!(dead_slots[first_dead / WORD_BITS] &
+                (1UL << (first_dead % WORD_BITS)))) {
+           ++first_dead;
+       }
+       size_type new_current = current_index;
+       size_type live = first_dead;
+       for (size_type slot = first_dead; slot < used; ++slot) {
+           if(dead_slots[slot / WORD_BITS] & (1UL << (slot % WORD_BITS))) {
+               continue;
+           }
+           if(slot == current_index){new_current = live;}
+           if(handles != NULL){handles->note_move(slot, live);}
+           data[live] = data[slot];
+           ++live;
+       }
+       if(current_index == used){new_current = live;}
+
+       used = live;
+       current_index = new_current;
+       delete [] dead_slots;
+       dead_slots = NULL;
+       dead_count = 0;
+       items_changed(first_dead);
+   }
+
+   sequence::size_type sequence::next_live(size_type slot) const
+   {
+       // The first live slot at or after slot, or used if there isn't
+       // one. Dead slots are skipped a word of the bitmap at a time.
+       if(dead_count == 0 || slot >= used){return slot;}
+
+       size_type word = slot / WORD_BITS;
+       unsigned long live = ~dead_slots[word] & (~0UL << (slot % WORD_BITS));
+       size_type words = (used + WORD_BITS - 1) / WORD_BITS;
+       while (live == 0) {
+           ++word;
+           if(word == words){return used;}
+           live = ~dead_slots[word];
+       }
+#ifdef __GNUC__
+       slot = word * WORD_BITS + __builtin_ctzl(live);
+#else
+       slot = word * WORD_BITS;
+       while (!(live & 1UL)) {
+           live >>= 1;
+           ++slot;
+       }
+#endif
+       return (slot < used) ? slot : used;
+   }
+}
@@ -16,6 +16,13 @@
 //    sequence::DEFAULT_CAPACITY is the default initial capacity of a
 //    sequence that is created by the default constructor.
 //
+//   struct item_handle
+//    sequence::item_handle is a stable handle to one item of a sequence
+//    (see current_handle): an id in the sequence's table of handles,
+//    tagged with a generation number. The generation changes whenever
+//    the item behind an id is removed, so an old handle never finds a
+//    newer item that reuses its id.
+//
 // CONSTRUCTOR for the sequence class:
 //   sequence(size_type initial_capacity = DEFAULT_CAPACITY)
 //    Pre:  initial_capacity > 0
@@ -24,6 +31,15 @@
 //      allocating new memory) until this capacity is reached.
 //    Note: If Pre is not met, initial_capacity will be adjusted to 1.
 //
+//   sequence(sequence_pool& pool,
+//            size_type initial_capacity = DEFAULT_CAPACITY)
+//    Pre:  pool outlives the sequence.
+//    Post: As above, but the sequence's dynamic array (and every one it
+//      grows into) comes from pool rather than straight from the heap,
+//      and goes back to pool when the sequence no longer needs it (see
+//      SequencePool.h). Its capacity is rounded up to the pool's size
+//      classes. Copies of the sequence use the same pool.
+//
 // MODIFICATION MEMBER FUNCTIONS for the sequence class:
 //   void resize(size_type new_capacity)
 //    Pre:  new_capacity > 0
@@ -70,6 +86,132 @@
 //      item. If the current item was already the last item in the
 //      sequence, then there is no longer any current item.
 //
+//   void enable_lazy_remove()
+//    Pre:  none
+//    Post: remove_current no longer shifts the items after the current
+//      item down at once. It marks the item's slot dead in a bitmap
+//      instead, and start, advance and current skip dead slots (a whole
+//      word of them at a time), so a run of removals costs O(1) each.
+//      The dead slots are squeezed out by compact(), automatically by
+//      remove_current once more than half of the slots are dead, and
+//      before any other function that changes or searches the items.
+//      size() never counts dead slots.
+//
+//   void disable_lazy_remove()
+//    Pre:  none
+//    Post: The sequence has been compacted, and remove_current shifts the
+//      items down at once again (the default).
+//
+//   void compact()
+//    Pre:  none
+//    Post: No slots are dead. The items and the current item are as
+//      before.
+//
+//   void enable_index()
+//    Pre:  none
+//    Post: The sequence keeps a hash index from each item value to the
+//      position of its first occurrence (see SequenceIndex.h), which
+//      makes seek_to O(1) expected time. The index is kept consistent
+//      through every later change to the sequence. Once it has been
+//      built (by the first seek_to), insert, attach and remove_current
+//      update it as they shift items, at O(1) expected time per item
+//      shifted. Changes in bulk (and edits made before it's built) are
+//      repaired by the next seek_to, in time proportional to the size
+//      of the index plus the number of items from the first change on.
+//      Copies of the sequence have an index too. An assignment to the
+//      sequence keeps its own index (see VALUE SEMANTICS).
+//
+//   void disable_index()
+//    Pre:  none
+//    Post: The sequence no longer keeps an index, and seek_to goes back
+//      to scanning the items.
+//
+//   void enable_filter()
+//    Pre:  none
+//    Post: The sequence keeps a Bloom filter of its items (see
+//      SequenceFilter.h), so contains() can answer false for most values
+//      that aren't items in O(1) time instead of scanning. insert and
+//      attach add to the filter as they go; after many remove_current
+//      calls, or a change to the items in bulk, the filter is rebuilt by
+//      the next contains(). Copies of the sequence have a filter too,
+//      and an assignment to the sequence keeps its own filter.
+//
+//   void disable_filter()
+//    Pre:  none
+//    Post: The sequence no longer keeps a filter.
+//
+//   void enable_handles()
+//    Pre:  none
+//    Post: The sequence keeps a table of handles to its items (see
+//      SequenceHandle.h), so an item can be found again after inserts
+//      and removals have moved it. insert, attach and remove_current
+//      keep the table up to date at no more than the cost of the shift
+//      they already make, and seek_handle repairs the positions that
+//      moved before using them. Copies of the sequence keep handles too,
+//      but handles to the items of one sequence never work in another.
+//      An assignment to the sequence keeps its table of handles, though
+//      none of the handles handed out before it still works.
+//
+//   void disable_handles()
+//    Pre:  none
+//    Post: The sequence no longer keeps handles, and every handle
+//      handed out so far is invalid.
+//
+//   bool seek_handle(const item_handle& handle)
+//    Pre:  Handles are enabled, and handle was returned by
+//      current_handle of this sequence since they were last enabled.
+//    Post: If the item handle refers to is still in the sequence, it
+//      becomes the current item and the return value is true. If it has
+//      been removed (or every item was replaced, by an assignment or a
+//      bulk operation), the return value is false and the current item
+//      is unchanged. Takes O(1) time, apart from a repair after edits.
+//
+//   void enable_checkpoints()
+//    Pre:  none
+//    Post: The sequence can be saved to disk with save_checkpoint and
+//      read back with load_checkpoint (see SequenceCheckpoint.h). It
+//      keeps track of which blocks of items have changed since the last
+//      save or load, so saving again to the same path writes only those
+//      blocks and a small manifest. Copies of the sequence can be saved
+//      too, but their first save writes every block. An assignment to the
+//      sequence keeps its checkpoints, and marks every block as changed.
+//
+//   void disable_checkpoints()
+//    Pre:  none
+//    Post: The sequence no longer tracks changed blocks. Files already
+//      saved are left as they are.
+//
+//   bool load_checkpoint(const char* path)
+//    Pre:  Checkpoints are enabled.
+//    Post: If the return value is true, the items are those of the
+//      checkpoint at path (as last saved there), the first item (if
+//      any) is the current item, and a save to path writes only the
+//      blocks changed after this. Otherwise (the checkpoint couldn't be
+//      read) the sequence is unchanged.
+//
+//   bool seek_to(const value_type& target)
+//    Pre:  none
+//    Post: If target is an item of the sequence, the first occurrence of
+//      target becomes the current item and the return value is true.
+//      Otherwise the return value is false and the current item is
+//      unchanged.
+//
+//   bool interpolation_seek(const value_type& target)
+//   bool gallop_seek(const value_type& target)
+//    Pre:  The items are sorted (in increasing order).
+//    Post: The first item that is not less than target becomes the
+//      current item (if there isn't one, there is no current item). The
+//      return value is true if that item equals target.
+//    Note: interpolation_seek guesses where target lies from the values
+//      at the ends of the range still to search, as if the items were
+//      spread evenly, which takes O(log log n) steps on evenly spread
+//      items. Whenever a guess fails to halve the range, the next step is
+//      a plain binary search step, so it never takes more than about
+//      twice the steps of a binary search. gallop_seek searches outward
+//      from the current item (or from the end, if there is none) in
+//      steps of 1, 2, 4, ..., so it takes O(log d) steps when the answer
+//      is d items away: fast when successive targets are close together.
+//
 // CONSTANT MEMBER FUNCTIONS for the sequence class:
 //   size_type size() const
 //    Pre:  none
@@ -86,9 +228,46 @@
 //    Pre:  is_item() returns true.
 //    Post: The item returned is the current item in the sequence.
 //
+//   bool contains(const value_type& target) const
+//    Pre:  none
+//    Post: The return value is true if target is an item of the
+//      sequence, and false otherwise. The current item is unchanged.
+//      Uses the filter and the index, if the sequence keeps them.
+//
+//   double filter_false_positive_rate() const
+//    Pre:  The filter is enabled.
+//    Post: The return value estimates the fraction of values that aren't
+//      items which the filter still lets through, so that contains() has
+//      to look for them in the items (or the index) after all. It's
+//      about 0.01 (see SequenceFilter.h). The filter is rebuilt first if
+//      the next contains() would rebuild it.
+//
+//   bool save_checkpoint(const char* path) const
+//    Pre:  Checkpoints are enabled.
+//    Post: If the return value is true, the items are saved in the
+//      checkpoint at path (which is made up of path itself, path.0 and
+//      path.1). If the last save or load was at the same path, only the
+//      blocks that changed since were written. If the return value is
+//      false (a file couldn't be written), the checkpoint at path is as
+//      it was, and can still be loaded.
+//
+//   item_handle current_handle() const
+//    Pre:  Handles are enabled, and is_item() returns true.
+//    Post: The return value is a handle to the current item, which
+//      keeps referring to it for as long as it stays in the sequence,
+//      however other items are inserted and removed around it.
+//
 // VALUE SEMANTICS for the sequence class:
 //   Assignments and the copy constructor may be used with sequence
-//   objects.
+//   objects. An assignment copies the items and the current item, but
+//   the sequence assigned to keeps its own index, filter, handles and
+//   checkpoints (if any), and its own removal mode (see
+//   enable_lazy_remove), rather than taking on the source's.
+//
+// ELEMENT-WISE ARITHMETIC for the sequence class:
+//   A sequence may also be constructed from, or assigned, an element-wise
+//   expression such as 2.0 * x + y built from sequences and numbers with
+//   +, -, * and /. See SequenceExpr.h, which must be included to use them.
 
 #ifndef SEQUENCE_H
 #define SEQUENCE_H
@@ -96,6 +275,13 @@
 
 namespace CS3358_FA2017
 {
+   template <class E> class sequence_expr;
+   class value_index;
+   class membership_filter;
+   class sequence_pool;
+   class handle_table;
+   class checkpoint_file;
+
    class sequence
    {
    public:
@@ -103,9 +289,17 @@ namespace CS3358_FA2017
       typedef double value_type;
       typedef std::size_t size_type;
       static const size_type DEFAULT_CAPACITY = 30;
+      struct item_handle
+      {
+         size_type id;
+         size_type generation;
+      };
       // CONSTRUCTORS and DESTRUCTOR
       sequence(size_type initial_capacity = DEFAULT_CAPACITY);
+      sequence(sequence_pool& pool,
+               size_type initial_capacity = DEFAULT_CAPACITY);
       sequence(const sequence& source);
+      template <class E> sequence(const sequence_expr<E>& source);
       ~sequence();
       // MODIFICATION MEMBER FUNCTIONS
       void resize(size_type new_capacity);
@@ -114,16 +308,105 @@ namespace CS3358_FA2017
       void insert(const value_type& entry);
       void attach(const value_type& entry);
       void remove_current();
+      void enable_lazy_remove();
+      void disable_lazy_remove();
+      void compact();
+      void enable_index();
+      void disable_index();
+      void enable_filter();
+      void disable_filter();
+      void enable_handles();
+      void disable_handles();
+      bool seek_handle(const item_handle& handle);
+      void enable_checkpoints();
+      void disable_checkpoints();
+      bool load_checkpoint(const char* path);
+      bool seek_to(const value_type& target);
+      bool interpolation_seek(const value_type& target);
+      bool gallop_seek(const value_type& target);
       sequence& operator=(const sequence& source);
+      template <class E> sequence& operator=(const sequence_expr<E>& source);
       // CONSTANT MEMBER FUNCTIONS
       size_type size() const;
       bool is_item() const;
       value_type current() const;
+      bool contains(const value_type& target) const;
+      double filter_false_positive_rate() const;
+      bool save_checkpoint(const char* path) const;
+      item_handle current_handle() const;
+      // FRIENDS
+      friend class sequence_view;
+      friend class sequence_operand;
+      friend class frozen_sequence;
+      friend class quantized_sequence;
+      friend class rle_sequence;
+      friend class sparse_sequence;
+      friend class sequence_table;
+      friend class shared_sequence;
+      friend class sharded_sequence;
+      friend value_type dot(const sequence& x, const sequence& y);
+      friend void axpy(value_type a, const sequence& x, sequence& y);
+      friend void scal(value_type a, sequence& x);
+      friend value_type nrm2(const sequence& x);
+      friend value_type asum(const sequence& x);
+      friend void inclusive_scan(const sequence& source, sequence& dest);
+      friend void exclusive_scan(const sequence& source, sequence& dest,
+                                 value_type initial);
+      friend void rolling_mean(const sequence& source, size_type window,
+                               sequence& dest);
+      friend void rolling_min(const sequence& source, size_type window,
+                              sequence& dest);
+      friend void rolling_max(const sequence& source, size_type window,
+                              sequence& dest);
+      friend void rolling_stddev(const sequence& source, size_type window,
+                                 sequence& dest);
+      friend class histogram;
+      friend class tdigest;
+      friend value_type exact_quantile(const sequence& source, double q);
+      friend void top_k(const sequence& source, size_type k, sequence& dest);
+      friend void bottom_k(const sequence& source, size_type k,
+                           sequence& dest);
+      friend value_type nth(const sequence& source, size_type k);
+      friend void merge_sorted(const sequence* const inputs[],
+                               size_type input_count, sequence& dest);
+      friend void sorted_union(const sequence& a, const sequence& b,
+                               sequence& dest);
+      friend void sorted_intersection(const sequence& a, const sequence& b,
+                                      sequence& dest);
+      friend void sorted_difference(const sequence& a, const sequence& b,
+                                    sequence& dest);
+      friend void sorted_symmetric_difference(const sequence& a,
+                                              const sequence& b,
+                                              sequence& dest);
    private:
       value_type* data;
-      size_type used;
-      size_type current_index;
+      // pack() changes these (but not the items the sequence holds), so
+      // const functions may squeeze out dead slots before reading data.
+      mutable size_type used;
+      mutable size_type current_index;
       size_type capacity;
+      value_index* position_index;
+      membership_filter* membership;
+      sequence_pool* pool;
+      handle_table* handles;
+      checkpoint_file* checkpoints;
+      bool lazy_remove;
+      mutable unsigned long* dead_slots;
+      mutable size_type dead_count;
+      // HELPER MEMBER FUNCTIONS for the dynamic array
+      value_type* allocate_items(size_type& count);
+      void release_items(value_type* items, size_type count);
+      // HELPER MEMBER FUNCTIONS for friends that fill a sequence in bulk
+      value_type* begin_bulk_write(size_type max_items);
+      void end_bulk_write(size_type new_used);
+      void copy_items(const sequence& source);
+      void items_changed(size_type first) const;
+      // HELPER MEMBER FUNCTIONS for lazy removal. Every friend that reads
+      // data calls pack() first.
+      void pack() const;
+      size_type next_live(size_type slot) const;
+      // HELPER MEMBER FUNCTIONS for the sorted seeks
+      bool seek_in(size_type low, size_type high, const value_type& target);
    };
 }
 
@@ -0,0 +1,273 @@
+// FILE: SequenceCheckpoint.cpp
+// CLASS IMPLEMENTED: checkpoint_file (see SequenceCheckpoint.h for
+//   documentation)
+// INVARIANT for the checkpoint_file class:
+//   1. saved_path is the path of the checkpoint last saved or loaded,
+//      or "" if there hasn't been one. Its manifest lists saved_blocks
+//      blocks: block b is at byte offsets[b] of data file data_file,
+//      whose first data_size bytes the manifest covers. offsets has
+//      room for block_capacity blocks.
+//   2. The items before position dirty_from are the same as when the
+//      checkpoint at saved_path was saved or loaded, so the blocks that
+//      hold only such items don't need to be written again.
+
+#include <cstdio>      // provides FILE, fopen, fread, fwrite, rename
+#include <cstring>     // provides memcmp
+#include "SequenceCheckpoint.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>    // provides fsync
+#define SEQUENCE_HAVE_FSYNC
+#endif
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      const char MAGIC[8] = { 'S', 'E', 'Q', 'C', 'K', 'P', 'T', '1' };
+
+      // The start of a manifest, followed by one offset for each block.
+      struct manifest_header
+      {
+         char magic[8];
+         unsigned long block_items;
+         unsigned long used;
+         unsigned long data_file;
+         unsigned long data_size;
+      };
+
+      string data_name(const string& path, unsigned long file)
+      {
+          return path + ((file == 0) ? ".0" : ".1");
+      }
+
+      bool read_header(const char* path, manifest_header& header)
+      {
+          FILE* manifest = fopen(path, "rb");
+          if(manifest == NULL){return false;}
+          bool ok = fread(&header, sizeof(header), 1, manifest) == 1;
+          fclose(manifest);
+          return ok && memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 header.block_items == checkpoint_file::BLOCK_ITEMS &&
+                 header.data_file <= 1;
+      }
+   }
+
+   // CONSTRUCTOR and DESTRUCTOR
+   checkpoint_file::checkpoint_file() : offsets(NULL), block_capacity(0),
+           saved_blocks(0), data_file(0), data_size(0), dirty_from(0)
+   {
+   }
+
+   checkpoint_file::~checkpoint_file()
+   {
+       delete [] offsets;
+       offsets = NULL;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void checkpoint_file::note_change(size_type first)
+   {
+       if(first < dirty_from){dirty_from = first;}
+   }
+
+   void checkpoint_file::note_clean(size_type used)
+   {
+       dirty_from = used;
+   }
+
+   bool checkpoint_file::save(const char* path, const value_type* items,
+                              size_type used)
+   {
+       size_type block_total = (used + BLOCK_ITEMS - 1) / BLOCK_ITEMS;
+       size_type first_block = dirty_from / BLOCK_ITEMS;
+       if(first_block > block_total){first_block = block_total;}
+       unsigned long file = data_file;
+       unsigned long size = data_size;
+
+       // Start a data file afresh when saving somewhere new, or when
+       // appending would leave more than half of it unused (blocks no
+       // manifest points to any more). Never the one the manifest
+       // already at path uses, so it stays loadable until the rename.
+       bool fresh = (saved_path != path);
+       if(!fresh) {
+           unsigned long appended =
+                   (used - first_block * BLOCK_ITEMS) * sizeof(value_type);
+           unsigned long live = used * sizeof(value_type);
+           if(size + appended > 2 * live + BLOCK_ITEMS * sizeof(value_type)) {
+               fresh = true;
+           }
+       }
+       if(fresh) {
+           manifest_header header;
+           file = (read_header(path, header) && header.data_file == 0);
+           size = 0;
+           first_block = 0;
+       }
+
+       // Write the changed blocks, noting where each one goes.
+       string name = data_name(path, file);
+       FILE* data = fopen(name.c_str(), fresh ? "wb" : "r+b");
+       if(data == NULL){return false;}
+       bool ok = (fseek(data, long(size), SEEK_SET) == 0);
+       unsigned long* new_offsets =
+               new unsigned long[(block_total > 0) ? block_total : 1];
+       for (size_type block = 0; block < first_block; ++block) {
+           new_offsets[block] = offsets[block];
+       }
+       for (size_type block = first_block; ok && block < block_total;
+            ++block) {
+           size_type first = block * BLOCK_ITEMS;
+           size_type count = (used - first > BLOCK_ITEMS) ?
+                   BLOCK_ITEMS : used - first;
+           ok = (fwrite(items + first, sizeof(value_type), count, data) ==
+                 count);
+           new_offsets[block] = size;
+           size += count * sizeof(value_type);
+       }
+       if(ok){ok = sync(data);}
+       if(fclose(data) != 0){ok = false;}
+
+       // Only once the new manifest is in place does the checkpoint
+       // change.
+       if(ok) {
+           ok = write_manifest(path, used, file, size, new_offsets,
+                               block_total);
+       }
+       if(ok) {
+           reserve_blocks(block_total);
+           for (size_type block = 0; block < block_total; ++block) {
+               offsets[block] = new_offsets[block];
+           }
+           saved_path = path;
+           saved_blocks = block_total;
+           data_file = file;
+           data_size = size;
+           dirty_from = used;
+       }
+       delete [] new_offsets;
+       return ok;
+   }
+
+   bool checkpoint_file::load(const char* path, value_type*& items,
+                              size_type& used)
+   {
+       manifest_header header;
+       if(!read_header(path, header)){return false;}
+       size_type count = header.used;
+       size_type block_total = (count + BLOCK_ITEMS - 1) / BLOCK_ITEMS;
+
+       // Read the offsets, then each block from where they say it is.
+       unsigned long* new_offsets =
+               new unsigned long[(block_total > 0) ? block_total : 1];
+       FILE* manifest = fopen(path, "rb");
+       bool ok = (manifest != NULL);
+       if(ok) {
+           ok = fseek(manifest, long(sizeof(header)), SEEK_SET) == 0 &&
+                fread(new_offsets, sizeof(unsigned long), block_total,
+                      manifest) == block_total;
+           fclose(manifest);
+       }
+
+       value_type* new_items = new value_type[(count > 0) ? count : 1];
+       string name = data_name(path, header.data_file);
+       FILE* data = ok ? fopen(name.c_str(), "rb") : NULL;
+       ok = (data != NULL);
+       for (size_type block = 0; ok && block < block_total; ++block) {
+           size_type first = block * BLOCK_ITEMS;
+           size_type block_count = (count - first > BLOCK_ITEMS) ?
+                   BLOCK_ITEMS : count - first;
+           ok = fseek(data, long(new_offsets[block]), SEEK_SET) == 0 &&
+                fread(new_items + first, sizeof(value_type), block_count,
+                      data) == block_count;
+       }
+       if(data != NULL){fclose(data);}
+
+       if(!ok) {
+           delete [] new_offsets;
+           delete [] new_items;
+           return false;
+       }
+
+       // The checkpoint just read is now the one later saves build on.
+       reserve_blocks(block_total);
+       for (size_type block = 0; block < block_total; ++block) {
+           offsets[block] = new_offsets[block];
+       }
+       delete [] new_offsets;
+       saved_path = path;
+       saved_blocks = block_total;
+       data_file = header.data_file;
+       data_size = header.data_size;
+       dirty_from = count;
+
+       items = new_items;
+       used = count;
+       return true;
+   }
+
+   // STATIC MEMBER FUNCTION
+   bool checkpoint_file::sync(FILE* file)
+   {
+       if(fflush(file) != 0){return false;}
+#ifdef SEQUENCE_HAVE_FSYNC
+       if(fsync(fileno(file)) != 0){return false;}
+#endif
+       return true;
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   void checkpoint_file::reserve_blocks(size_type block_total)
+   {
+       if(block_total <= block_capacity){return;}
+
+       // Grow the way sequence::insert grows a sequence.
+       size_type new_capacity = size_type(1.25 * block_capacity) + 1;
+       if(new_capacity < block_total){new_capacity = block_total;}
+       unsigned long* temp_offsets = new unsigned long[new_capacity];
+       for (size_type block = 0; block < saved_blocks; ++block) {
+           temp_offsets[block] = offsets[block];
+       }
+       delete [] offsets;
+       offsets = temp_offsets;
+       block_capacity = new_capacity;
+   }
+
+   bool checkpoint_file::write_manifest(const char* path, size_type used,
+                                        unsigned long file,
+                                        unsigned long size,
+                                        const unsigned long* block_offsets,
+                                        size_type block_total) const
+   {
+       manifest_header header;
+       memcpy(header.magic, MAGIC, sizeof(MAGIC));
+       header.block_items = BLOCK_ITEMS;
+       header.used = used;
+       header.data_file = file;
+       header.data_size = size;
+
+       // Write the whole manifest beside the old one, then swap it in
+       // with a single rename.
+       string temp_name = string(path) + ".tmp";
+       FILE* manifest = fopen(temp_name.c_str(), "wb");
+       if(manifest == NULL){return false;}
+       bool ok = fwrite(&header, sizeof(header), 1, manifest) == 1 &&
+                 fwrite(block_offsets, sizeof(unsigned long), block_total,
+                        manifest) == block_total;
+       if(ok){ok = sync(manifest);}
+       if(fclose(manifest) != 0){ok = false;}
+       if(!ok) {
+           remove(temp_name.c_str());
+           return false;
+       }
+
+       // rename replaces path in one step on POSIX systems. Elsewhere it
+       // may refuse to replace a file, so remove it first.
+       if(rename(temp_name.c_str(), path) != 0) {
+           remove(path);
+           if(rename(temp_name.c_str(), path) != 0){return false;}
+       }
+       return true;
+   }
+}
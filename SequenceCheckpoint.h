@@ -0,0 +1,133 @@
+// FILE: SequenceCheckpoint.h
+// CLASS PROVIDED: checkpoint_file (part of the namespace CS3358_FA2017)
+//
+// A checkpoint_file lets a sequence save itself to disk again and again
+// while writing only what changed since the last save (see
+// sequence::enable_checkpoints in Sequence.h). It isn't meant to be
+// used on its own.
+//
+// The items are split into blocks of BLOCK_ITEMS items. Every edit a
+// sequence supports changes the items from some position to the end
+// (an insert or removal shifts everything after it, and an attach at
+// the end changes only the last block), so the changed blocks are
+// always the ones from some block on, and the checkpoint_file only has
+// to remember the first of them.
+//
+// A checkpoint at path is three files:
+//   path        the manifest: the number of items, and where in the
+//               data file each block is;
+//   path.0 and path.1
+//               the data files, only one of which is in use.
+// A save appends the changed blocks to the end of the data file in use,
+// then writes a new manifest to path.tmp and renames it over path. The
+// blocks the old manifest points to are never overwritten, so if the
+// program stops part way through a save, the old checkpoint can still
+// be loaded. Once more than half of the data file is blocks no manifest
+// points to any more, the next save writes every block afresh to the
+// other data file instead.
+//
+// The files hold the items and sizes in this machine's own format, so
+// they can only be read back by a program built the same way. On POSIX
+// systems each file is forced out to disk (see sync) before the
+// manifest is renamed, so a checkpoint survives the machine stopping as
+// well as the program. Elsewhere it survives only the program stopping.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the checkpoint_file class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+//   static const size_type BLOCK_ITEMS = _____
+//    The number of items in a block.
+//
+// CONSTRUCTOR for the checkpoint_file class:
+//   checkpoint_file()
+//    Post: Nothing has been saved, so the next save writes every block.
+//
+// MODIFICATION MEMBER FUNCTIONS for the checkpoint_file class:
+//   void note_change(size_type first)
+//    Pre:  none
+//    Post: The blocks holding items from position first on will be
+//      written by the next save.
+//
+//   void note_clean(size_type used)
+//    Pre:  The sequence has just been filled with the used items read by
+//      load.
+//    Post: No block will be written by the next save to the same path
+//      unless it changes first.
+//
+//   bool save(const char* path, const value_type* items, size_type used)
+//    Pre:  items[0] through items[used-1] are the items of the sequence.
+//    Post: If the return value is true, the items are saved in the
+//      checkpoint at path. Only the blocks that changed since the last
+//      save (or load) were written, if that was at the same path.
+//      Otherwise (a file couldn't be written) the checkpoint at path is
+//      as it was.
+//
+//   bool load(const char* path, value_type*& items, size_type& used)
+//    Pre:  none
+//    Post: If the return value is true, used is the number of items in
+//      the checkpoint at path, and items is a new dynamic array (of at
+//      least one item) holding them, which the caller must delete. A
+//      later save to path writes only the blocks that change after
+//      that. Otherwise (the checkpoint couldn't be read) items and used
+//      are unchanged.
+//
+// STATIC MEMBER FUNCTION for the checkpoint_file class:
+//   static bool sync(std::FILE* file)
+//    Pre:  file is open for writing.
+//    Post: Everything written to file has been handed to the operating
+//      system and, on POSIX systems, forced out to disk (fsync). The
+//      return value is false if that failed. It's also used by
+//      logged_sequence.
+//
+// VALUE SEMANTICS for the checkpoint_file class:
+//   checkpoint_file objects may not be copied or assigned. A sequence
+//   that is copied gives the copy a new checkpoint_file.
+
+#ifndef SEQUENCE_CHECKPOINT_H
+#define SEQUENCE_CHECKPOINT_H
+#include <cstdio>      // provides FILE
+#include <string>
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class checkpoint_file
+   {
+   public:
+      // TYPEDEFS and MEMBER CONSTANTS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      static const size_type BLOCK_ITEMS = 512;
+      // CONSTRUCTOR and DESTRUCTOR
+      checkpoint_file();
+      ~checkpoint_file();
+      // MODIFICATION MEMBER FUNCTIONS
+      void note_change(size_type first);
+      void note_clean(size_type used);
+      bool save(const char* path, const value_type* items, size_type used);
+      bool load(const char* path, value_type*& items, size_type& used);
+      // STATIC MEMBER FUNCTION
+      static bool sync(std::FILE* file);
+   private:
+      std::string saved_path;  // "" if nothing has been saved or loaded
+      unsigned long* offsets;  // where each block is in the data file
+      size_type block_capacity;
+      size_type saved_blocks;
+      unsigned long data_file; // 0 or 1: which data file is in use
+      unsigned long data_size; // bytes of it the manifest covers
+      size_type dirty_from;
+      // HELPER MEMBER FUNCTIONS
+      void reserve_blocks(size_type block_total);
+      bool write_manifest(const char* path, size_type used,
+                          unsigned long file, unsigned long size,
+                          const unsigned long* block_offsets,
+                          size_type block_total) const;
+      // Not copyable: see VALUE SEMANTICS above.
+      checkpoint_file(const checkpoint_file& source);
+      checkpoint_file& operator=(const checkpoint_file& source);
+   };
+}
+
+#endif
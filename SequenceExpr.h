@@ -0,0 +1,282 @@
+// FILE: SequenceExpr.h
+// TEMPLATES PROVIDED: element-wise arithmetic for the sequence class
+//   (part of the namespace CS3358_FA2017)
+//
+// An arithmetic expression on sequences such as
+//      y = a * x + b;
+// doesn't compute anything when the operators are applied. Each operator
+// returns a small expression object that only remembers its operands.
+// The whole expression is evaluated when it's assigned to a sequence (or
+// used to construct one), in a single loop that computes every item of
+// the result directly, so no temporary sequence is ever allocated for a
+// sub-expression. The loop is a plain indexed loop over the operands'
+// dynamic arrays, which the compiler is free to vectorize.
+//
+// OPERATORS provided for sequences:
+//   For op in +, -, * and / the following are provided, where e is a
+//   sequence or an expression and s is a number (sequence::value_type):
+//      e op e      item i of the result is (item i of lhs) op (item i of rhs)
+//      s op e      item i of the result is s op (item i of e)
+//      e op s      item i of the result is (item i of e) op s
+//   In addition, -e negates every item of e.
+//    Pre:  When both operands are sequences or expressions, they have the
+//      same number of items. If not, the program is terminated by assert
+//      when the operator is applied (or, if asserts are turned off with
+//      NDEBUG, the result only has as many items as the shorter operand).
+//
+// MEMBER FUNCTIONS added to the sequence class:
+//   template <class E> sequence(const sequence_expr<E>& source)
+//    Pre:  none
+//    Post: The sequence holds the items of source and its first item
+//      (if any) is the current item. Its capacity is source's size
+//      (but at least 1).
+//
+//   template <class E> sequence& operator=(const sequence_expr<E>& source)
+//    Pre:  none
+//    Post: The sequence holds the items of source and its first item
+//      (if any) is the current item. The sequence may itself appear in
+//      source (as in x = 2.0 * x + 1.0); new memory is only allocated
+//      when source has more items than the current capacity.
+//
+// NOTE: An expression refers directly to the dynamic arrays of the
+//   sequences it's built from, so it should be assigned in the same
+//   statement that builds it, before any of those sequences change.
+
+#ifndef SEQUENCE_EXPR_H
+#define SEQUENCE_EXPR_H
+#include <cassert>
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   // Base class of every expression. E is the actual expression class
+   // (a class derived from sequence_expr<E>), which must provide size()
+   // and operator[].
+   template <class E>
+   class sequence_expr
+   {
+   public:
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      const E& self() const { return static_cast<const E&>(*this); }
+      size_type size() const { return self().size(); }
+      value_type operator[](size_type index) const { return self()[index]; }
+   };
+
+   // A sequence used as an operand: its items, read in place.
+   class sequence_operand : public sequence_expr<sequence_operand>
+   {
+   public:
+      sequence_operand(const sequence& source)
+      {
+          source.pack();
+          items = source.data;
+          count = source.used;
+      }
+      size_type size() const { return count; }
+      value_type operator[](size_type index) const { return items[index]; }
+   private:
+      const value_type* items;
+      size_type count;
+   };
+
+   // The operations, as classes so they can be template arguments.
+   struct add_op
+   {
+      static sequence::value_type apply(sequence::value_type lhs,
+                                        sequence::value_type rhs)
+      { return lhs + rhs; }
+   };
+
+   struct subtract_op
+   {
+      static sequence::value_type apply(sequence::value_type lhs,
+                                        sequence::value_type rhs)
+      { return lhs - rhs; }
+   };
+
+   struct multiply_op
+   {
+      static sequence::value_type apply(sequence::value_type lhs,
+                                        sequence::value_type rhs)
+      { return lhs * rhs; }
+   };
+
+   struct divide_op
+   {
+      static sequence::value_type apply(sequence::value_type lhs,
+                                        sequence::value_type rhs)
+      { return lhs / rhs; }
+   };
+
+   // lhs op rhs, item by item. Operands are stored by value; they're
+   // only a pointer and a count (or a tree of them) in size.
+   template <class L, class R, class Op>
+   class binary_expr : public sequence_expr< binary_expr<L, R, Op> >
+   {
+   public:
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      binary_expr(const L& left, const R& right) : lhs(left), rhs(right)
+      {
+          // Protect pre-condition: the operands must line up item by item.
+          assert(lhs.size() == rhs.size());
+      }
+      // Never more items than the shorter operand has, even if the
+      // assert above is compiled out.
+      size_type size() const
+      { return (rhs.size() < lhs.size()) ? rhs.size() : lhs.size(); }
+      value_type operator[](size_type index) const
+      { return Op::apply(lhs[index], rhs[index]); }
+   private:
+      L lhs;
+      R rhs;
+   };
+
+   // number op expr, item by item.
+   template <class E, class Op>
+   class scalar_left_expr : public sequence_expr< scalar_left_expr<E, Op> >
+   {
+   public:
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      scalar_left_expr(value_type left, const E& right) :
+              lhs(left), rhs(right) { }
+      size_type size() const { return rhs.size(); }
+      value_type operator[](size_type index) const
+      { return Op::apply(lhs, rhs[index]); }
+   private:
+      value_type lhs;
+      E rhs;
+   };
+
+   // expr op number, item by item.
+   template <class E, class Op>
+   class scalar_right_expr : public sequence_expr< scalar_right_expr<E, Op> >
+   {
+   public:
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      scalar_right_expr(const E& left, value_type right) :
+              lhs(left), rhs(right) { }
+      size_type size() const { return lhs.size(); }
+      value_type operator[](size_type index) const
+      { return Op::apply(lhs[index], rhs); }
+   private:
+      E lhs;
+      value_type rhs;
+   };
+
+   // -expr, item by item.
+   template <class E>
+   class negate_expr : public sequence_expr< negate_expr<E> >
+   {
+   public:
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      negate_expr(const E& operand) : arg(operand) { }
+      size_type size() const { return arg.size(); }
+      value_type operator[](size_type index) const { return -arg[index]; }
+   private:
+      E arg;
+   };
+
+   // OPERATORS
+   // Every operator needs a version for each mix of sequence, expression
+   // and number operands, and the four arithmetic operators only differ in
+   // their symbol and operation class, so the overloads are generated.
+#define CS3358_SEQUENCE_BINARY_OPERATOR(SYMBOL, OP)                         \
+   template <class L, class R>                                              \
+   inline binary_expr<L, R, OP>                                             \
+   operator SYMBOL(const sequence_expr<L>& lhs, const sequence_expr<R>& rhs) \
+   { return binary_expr<L, R, OP>(lhs.self(), rhs.self()); }               \
+                                                                            \
+   template <class R>                                                       \
+   inline binary_expr<sequence_operand, R, OP>                              \
+   operator SYMBOL(const sequence& lhs, const sequence_expr<R>& rhs)        \
+   { return binary_expr<sequence_operand, R, OP>(lhs, rhs.self()); }       \
+                                                                            \
+   template <class L>                                                       \
+   inline binary_expr<L, sequence_operand, OP>                              \
+   operator SYMBOL(const sequence_expr<L>& lhs, const sequence& rhs)        \
+   { return binary_expr<L, sequence_operand, OP>(lhs.self(), rhs); }       \
+                                                                            \
+   inline binary_expr<sequence_operand, sequence_operand, OP>               \
+   operator SYMBOL(const sequence& lhs, const sequence& rhs)                \
+   {                                                                        \
+       return binary_expr<sequence_operand, sequence_operand, OP>(lhs, rhs);\
+   }                                                                        \
+                                                                            \
+   template <class R>                                                       \
+   inline scalar_left_expr<R, OP>                                           \
+   operator SYMBOL(sequence::value_type lhs, const sequence_expr<R>& rhs)   \
+   { return scalar_left_expr<R, OP>(lhs, rhs.self()); }                    \
+                                                                            \
+   inline scalar_left_expr<sequence_operand, OP>                            \
+   operator SYMBOL(sequence::value_type lhs, const sequence& rhs)           \
+   { return scalar_left_expr<sequence_operand, OP>(lhs, rhs); }            \
+                                                                            \
+   template <class L>                                                       \
+   inline scalar_right_expr<L, OP>                                          \
+   operator SYMBOL(const sequence_expr<L>& lhs, sequence::value_type rhs)   \
+   { return scalar_right_expr<L, OP>(lhs.self(), rhs); }                   \
+                                                                            \
+   inline scalar_right_expr<sequence_operand, OP>                           \
+   operator SYMBOL(const sequence& lhs, sequence::value_type rhs)           \
+   { return scalar_right_expr<sequence_operand, OP>(lhs, rhs); }
+
+   CS3358_SEQUENCE_BINARY_OPERATOR(+, add_op)
+   CS3358_SEQUENCE_BINARY_OPERATOR(-, subtract_op)
+   CS3358_SEQUENCE_BINARY_OPERATOR(*, multiply_op)
+   CS3358_SEQUENCE_BINARY_OPERATOR(/, divide_op)
+
+#undef CS3358_SEQUENCE_BINARY_OPERATOR
+
+   template <class E>
+   inline negate_expr<E> operator -(const sequence_expr<E>& operand)
+   {
+       return negate_expr<E>(operand.self());
+   }
+
+   inline negate_expr<sequence_operand> operator -(const sequence& operand)
+   {
+       return negate_expr<sequence_operand>(operand);
+   }
+
+   // MEMBER FUNCTIONS of sequence that take an expression
+   template <class E>
+   sequence::sequence(const sequence_expr<E>& source) :
+           used(0), current_index(0), capacity(source.size()),
+           position_index(NULL), membership(NULL), pool(NULL), handles(NULL),
+           checkpoints(NULL), lazy_remove(false), dead_slots(NULL),
+           dead_count(0)
+   {
+       // Same rule as the size_type constructor: capacity is at least 1.
+       if(capacity < 1){capacity = 1;}
+
+       // Create new dynamic sequence array, then evaluate into it.
+       data = new value_type[capacity];
+       *this = source;
+   }
+
+   template <class E>
+   sequence& sequence::operator=(const sequence_expr<E>& source)
+   {
+       const E& expr = source.self();
+       size_type count = expr.size();
+
+       // If this sequence is one of the operands then count equals used,
+       // so begin_bulk_write() keeps the current array and each item is
+       // read before it's overwritten (item i only depends on item i of
+       // each operand). Otherwise a larger array may be allocated first.
+       value_type* target = begin_bulk_write(count);
+       for (size_type index = 0; index < count; ++index) {
+           target[index] = expr[index];
+       }
+       end_bulk_write(count);
+
+       return *this;
+   }
+}
+
+#endif
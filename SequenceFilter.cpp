@@ -0,0 +1,177 @@
+// FILE: SequenceFilter.cpp
+// CLASS IMPLEMENTED: membership_filter (see SequenceFilter.h for
+//   documentation)
+// INVARIANT for the membership_filter class:
+//   1. The filter is block_count blocks of BLOCK_BITS bits each, stored
+//      in the dynamic array words, WORDS_PER_BLOCK unsigned longs per
+//      block. It was sized for planned items.
+//   2. If stale is false, every item of the sequence has been added to
+//      the filter: since the last rebuild, added items have been added
+//      and removed items removed. If stale is true, the filter has to be
+//      rebuilt from the items before it's used (words may then be NULL).
+
+#include <climits>     // provides CHAR_BIT
+#include <cmath>       // provides pow
+#include "SequenceFilter.h"
+#include "SequenceIndex.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      const membership_filter::size_type WORD_BITS =
+              CHAR_BIT * sizeof(unsigned long);
+      const membership_filter::size_type WORDS_PER_BLOCK =
+              membership_filter::BLOCK_BITS / WORD_BITS;
+      const membership_filter::size_type MIN_PLANNED = 64;
+
+      // Mix state once more and return the next bit (within a block) it
+      // picks. Each probe gets its own round of mixing: deriving all of
+      // them from one step (b, b+s, b+2s, ...) lets values whose probes
+      // overlap share most of their bits, and triples the false positive
+      // rate in blocks this small.
+      membership_filter::size_type next_bit(
+              membership_filter::size_type& state)
+      {
+          state ^= state >> 15;
+          state *= 0x2c1b3c6dUL;
+          state ^= state >> 12;
+          state *= 0x297a2d39UL;
+          state ^= state >> 15;
+          return state % membership_filter::BLOCK_BITS;
+      }
+   }
+
+   // CONSTRUCTOR and DESTRUCTOR
+   membership_filter::membership_filter() :
+           words(NULL), block_count(0), planned(0), added(0), removed(0),
+           stale(true)
+   {
+   }
+
+   membership_filter::~membership_filter()
+   {
+       delete [] words;
+       words = NULL;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void membership_filter::note_insert(const value_type& entry)
+   {
+       // A stale filter is rebuilt from all of the items anyway.
+       if(stale){return;}
+       add(entry);
+       ++added;
+       if(added > planned){stale = true;}
+   }
+
+   void membership_filter::note_remove()
+   {
+       if(stale){return;}
+       ++removed;
+       // Once the removed items outnumber those left, most of the bits
+       // set belong to items that are gone.
+       if(2 * removed > added){stale = true;}
+   }
+
+   void membership_filter::note_change()
+   {
+       stale = true;
+   }
+
+   bool membership_filter::might_contain(const value_type* items,
+                                         size_type used,
+                                         const value_type& target)
+   {
+       if(target != target){return false;}   // NaN
+       if(stale){rebuild(items, used);}
+       return test(target);
+   }
+
+   double membership_filter::false_positive_rate(const value_type* items,
+                                                 size_type used)
+   {
+       if(stale){rebuild(items, used);}
+       if(block_count == 0){return 1.0;}
+
+       // A value that isn't an item is let through when all PROBES of its
+       // bits happen to be set in the block it lands on. Some blocks are
+       // fuller than others, so average the chance over the blocks.
+       double total = 0;
+       for (size_type block = 0; block < block_count; ++block) {
+           size_type set_bits = 0;
+           for (size_type index = block * WORDS_PER_BLOCK;
+                index < (block + 1) * WORDS_PER_BLOCK; ++index) {
+               for (unsigned long word = words[index]; word != 0;
+                    word &= word - 1) {
+                   ++set_bits;
+               }
+           }
+           total += pow(double(set_bits) / BLOCK_BITS, double(PROBES));
+       }
+       return total / block_count;
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   void membership_filter::add(const value_type& entry)
+   {
+       size_type state;
+       unsigned long* block = words + locate(entry, state);
+       for (size_type probe = 0; probe < PROBES; ++probe) {
+           size_type bit = next_bit(state);
+           block[bit / WORD_BITS] |= 1UL << (bit % WORD_BITS);
+       }
+   }
+
+   bool membership_filter::test(const value_type& entry) const
+   {
+       size_type state;
+       const unsigned long* block = words + locate(entry, state);
+       for (size_type probe = 0; probe < PROBES; ++probe) {
+           size_type bit = next_bit(state);
+           if((block[bit / WORD_BITS] & (1UL << (bit % WORD_BITS))) == 0) {
+               return false;
+           }
+       }
+       return true;
+   }
+
+   membership_filter::size_type membership_filter::locate(
+           const value_type& entry, size_type& state) const
+   {
+       // The hash picks the block, and what's left of it seeds the bits
+       // picked within the block (see next_bit).
+       size_type hash = value_index::hash(entry);
+       state = hash / block_count;
+       return (hash % block_count) * WORDS_PER_BLOCK;
+   }
+
+   void membership_filter::rebuild(const value_type* items, size_type used)
+   {
+       // Size the filter for twice the items there are now, so it can
+       // take as many appends again before it has to grow.
+       planned = 2 * used;
+       if(planned < MIN_PLANNED){planned = MIN_PLANNED;}
+       size_type new_blocks =
+               (planned * BITS_PER_ITEM + BLOCK_BITS - 1) / BLOCK_BITS;
+
+       if(new_blocks != block_count) {
+           delete [] words;
+           words = new unsigned long[new_blocks * WORDS_PER_BLOCK];
+           block_count = new_blocks;
+       }
+       for (size_type index = 0; index < block_count * WORDS_PER_BLOCK;
+            ++index) {
+           words[index] = 0;
+       }
+
+       for (size_type index = 0; index < used; ++index) {
+           if(items[index] == items[index]){add(items[index]);}
+       }
+       added = used;
+       removed = 0;
+       stale = false;
+   }
+}
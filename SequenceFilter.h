@@ -0,0 +1,115 @@
+// FILE: SequenceFilter.h
+// CLASS PROVIDED: membership_filter (part of the namespace CS3358_FA2017)
+//
+// A membership_filter is a blocked Bloom filter over the items of a
+// sequence. It answers "might x be in the sequence" in O(1) time: a
+// false answer is always right, while a true answer is wrong about 1% of
+// the time. It's used by the sequence class (see sequence::enable_filter
+// in Sequence.h) so that contains() can turn down most missing values
+// without scanning the sequence, and isn't meant to be used on its own:
+// it doesn't own the items, so it's given the sequence's array whenever
+// it has to be rebuilt.
+//
+// The filter is an array of 512-bit blocks (one cache line each). An
+// item sets PROBES bits, all within the single block its hash picks, so
+// a lookup touches one cache line however many bits it tests.
+//
+// A Bloom filter can't forget an item, so removing one leaves its bits
+// set. That never causes a wrong false answer, only more wrong true
+// ones, so removals are just counted, and the filter is rebuilt from the
+// items by the next lookup once they add up to more than the items left.
+// It's also rebuilt (twice as large) when more items have been added
+// than it was sized for, and after the items were changed in bulk.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the membership_filter class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+//   static const size_type BLOCK_BITS = _____
+//   static const size_type BITS_PER_ITEM = _____
+//   static const size_type PROBES = _____
+//    The size of a block in bits, the bits of filter kept per item it's
+//    sized for, and the number of bits each item sets. 10 bits per item
+//    and 7 probes give about 1% false positives.
+//
+// CONSTRUCTOR for the membership_filter class:
+//   membership_filter()
+//    Post: The filter is empty, and will be built by the first lookup.
+//
+// MODIFICATION MEMBER FUNCTIONS for the membership_filter class:
+//   void note_insert(const value_type& entry)
+//    Pre:  entry has just been inserted into the sequence.
+//    Post: The filter has taken note of entry.
+//
+//   void note_remove()
+//    Pre:  An item has just been removed from the sequence.
+//    Post: The filter has taken note of the removal.
+//
+//   void note_change()
+//    Pre:  none
+//    Post: The filter will treat every item as changed, and be rebuilt by
+//      the next lookup.
+//
+//   bool might_contain(const value_type* items, size_type used,
+//                      const value_type& target)
+//    Pre:  items[0] through items[used-1] are the items of the sequence.
+//    Post: If the return value is false, target isn't one of the items.
+//      If it's true, target may be one of them. NaN is never contained
+//      (it isn't equal to anything).
+//
+//   double false_positive_rate(const value_type* items, size_type used)
+//    Pre:  items[0] through items[used-1] are the items of the sequence.
+//    Post: The return value estimates the fraction of values that are
+//      not items for which might_contain returns true, from how many
+//      bits of the filter are set. (The filter is rebuilt first, if a
+//      lookup would rebuild it.)
+//
+// VALUE SEMANTICS for the membership_filter class:
+//   membership_filter objects may not be copied or assigned. A sequence
+//   that is copied builds a new filter of its own.
+
+#ifndef SEQUENCE_FILTER_H
+#define SEQUENCE_FILTER_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class membership_filter
+   {
+   public:
+      // TYPEDEFS and MEMBER CONSTANTS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      static const size_type BLOCK_BITS = 512;
+      static const size_type BITS_PER_ITEM = 10;
+      static const size_type PROBES = 7;
+      // CONSTRUCTOR and DESTRUCTOR
+      membership_filter();
+      ~membership_filter();
+      // MODIFICATION MEMBER FUNCTIONS
+      void note_insert(const value_type& entry);
+      void note_remove();
+      void note_change();
+      bool might_contain(const value_type* items, size_type used,
+                         const value_type& target);
+      double false_positive_rate(const value_type* items, size_type used);
+   private:
+      unsigned long* words;
+      size_type block_count;
+      size_type planned;      // items the filter was sized for
+      size_type added;        // items added since the last rebuild
+      size_type removed;      // items removed since the last rebuild
+      bool stale;
+      // HELPER MEMBER FUNCTIONS
+      void add(const value_type& entry);
+      bool test(const value_type& entry) const;
+      size_type locate(const value_type& entry, size_type& state) const;
+      void rebuild(const value_type* items, size_type used);
+      // Not copyable: see VALUE SEMANTICS above.
+      membership_filter(const membership_filter& source);
+      membership_filter& operator=(const membership_filter& source);
+   };
+}
+
+#endif
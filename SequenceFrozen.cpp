@@ -0,0 +1,234 @@
+// FILE: SequenceFrozen.cpp
+// CLASS IMPLEMENTED: frozen_sequence (see SequenceFrozen.h for
+//   documentation)
+// INVARIANT for the frozen_sequence class:
+//   1. The number of items is in the member variable used.
+//   2. The items are stored in tree[1] through tree[used] in Eytzinger
+//      order: for every node k, the items in the subtree of its left
+//      child 2k are all no greater than tree[k], and those in the subtree
+//      of its right child 2k+1 are all no less. tree[0] isn't used.
+//   3. tree points into the dynamic array storage (or is NULL when
+//      storage is), placed so that tree[0] starts a cache line.
+//   4. current_node is the node of the current item, or 0 if there is
+//      no current item.
+
+#include <cassert>
+#include "SequenceFrozen.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      // Items per cache line (assumed to be 64 bytes). With tree[0] at
+      // the start of a line, the LINE_ITEMS descendants of node k that
+      // are log2(LINE_ITEMS) levels further down, tree[k * LINE_ITEMS]
+      // onwards, share a single line.
+      const frozen_sequence::size_type LINE_BYTES = 64;
+      const frozen_sequence::size_type LINE_ITEMS =
+              (LINE_BYTES / sizeof(frozen_sequence::value_type) > 0) ?
+              LINE_BYTES / sizeof(frozen_sequence::value_type) : 1;
+   }
+
+   // CONSTRUCTORS and DESTRUCTOR
+   frozen_sequence::frozen_sequence() :
+           storage(NULL), tree(NULL), used(0), current_node(0)
+   {
+   }
+
+   frozen_sequence::frozen_sequence(const sequence& source) :
+           storage(NULL), tree(NULL), used(0), current_node(0)
+   {
+       freeze(source);
+   }
+
+   frozen_sequence::frozen_sequence(const frozen_sequence& source) :
+           storage(NULL), tree(NULL), used(0), current_node(0)
+   {
+       allocate(source.used);
+       for (size_type node = 1; node <= used; ++node) {
+           tree[node] = source.tree[node];
+       }
+       current_node = source.current_node;
+   }
+
+   frozen_sequence::~frozen_sequence()
+   {
+       delete [] storage;
+       storage = NULL;
+       tree = NULL;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void frozen_sequence::freeze(const sequence& source)
+   {
+       source.pack();
+
+       // Protect pre-condition.
+       for (size_type index = 1; index < source.used; ++index) {
+           assert(!(source.data[index] < source.data[index - 1]));
+       }
+
+       // Visiting the nodes in order and handing each the next item
+       // of source puts every item where invariant #2 wants it.
+       allocate(source.used);
+       size_type node = first_node();
+       for (size_type index = 0; index < used; ++index) {
+           tree[node] = source.data[index];
+           node = next_node(node);
+       }
+       current_node = 0;
+   }
+
+   void frozen_sequence::start()
+   {
+       current_node = first_node();
+   }
+
+   void frozen_sequence::advance()
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       current_node = next_node(current_node);
+   }
+
+   bool frozen_sequence::seek(const value_type& target)
+   {
+       current_node = lower_bound(target);
+       return current_node != 0 && !(target < tree[current_node]);
+   }
+
+   frozen_sequence& frozen_sequence::operator=(
+           const frozen_sequence& source)
+   {
+       // Self-assignment fail safe.
+       if (this == &source)
+           return *this;
+
+       allocate(source.used);
+       for (size_type node = 1; node <= used; ++node) {
+           tree[node] = source.tree[node];
+       }
+       current_node = source.current_node;
+
+       return *this;
+   }
+
+   // CONSTANT MEMBER FUNCTIONS
+   frozen_sequence::size_type frozen_sequence::size() const
+   {
+       return used;
+   }
+
+   bool frozen_sequence::is_item() const
+   {
+       return (current_node != 0);
+   }
+
+   frozen_sequence::value_type frozen_sequence::current() const
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       return tree[current_node];
+   }
+
+   bool frozen_sequence::contains(const value_type& target) const
+   {
+       size_type node = lower_bound(target);
+       return node != 0 && !(target < tree[node]);
+   }
+
+   void frozen_sequence::thaw(sequence& dest) const
+   {
+       sequence::value_type* target = dest.begin_bulk_write(used);
+       size_type node = first_node();
+       for (size_type index = 0; index < used; ++index) {
+           target[index] = tree[node];
+           node = next_node(node);
+       }
+       dest.end_bulk_write(used);
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   void frozen_sequence::allocate(size_type count)
+   {
+       // Make room for tree[0] through tree[count], plus enough spare
+       // items to slide tree[0] up to the start of a cache line.
+       value_type* new_storage = NULL;
+       value_type* new_tree = NULL;
+       if(count > 0) {
+           new_storage = new value_type[count + 1 + LINE_ITEMS];
+           size_t misalignment = size_t(new_storage) % LINE_BYTES;
+           size_t shift = (misalignment == 0) ? 0 :
+                   (LINE_BYTES - misalignment) / sizeof(value_type);
+           new_tree = new_storage + shift;
+       }
+
+       delete [] storage;
+       storage = new_storage;
+       tree = new_tree;
+       used = count;
+       current_node = 0;
+   }
+
+   frozen_sequence::size_type frozen_sequence::first_node() const
+   {
+       // The smallest item is the leftmost node.
+       if(used == 0){return 0;}
+       size_type node = 1;
+       while (2 * node <= used) {
+           node = 2 * node;
+       }
+       return node;
+   }
+
+   frozen_sequence::size_type frozen_sequence::next_node(size_type node)
+           const
+   {
+       // If node has a right subtree, the next item is its leftmost node.
+       if(2 * node + 1 <= used) {
+           node = 2 * node + 1;
+           while (2 * node <= used) {
+               node = 2 * node;
+           }
+           return node;
+       }
+
+       // Otherwise climb past every ancestor we're the right child of;
+       // the next item is the parent of the last one (0 at the root).
+       while (node % 2 == 1) {
+           node /= 2;
+       }
+       return node / 2;
+   }
+
+   frozen_sequence::size_type frozen_sequence::lower_bound(
+           const value_type& target) const
+   {
+       // Walk down from the root, going right whenever the node is less
+       // than target. The comparison decides an index rather than a
+       // branch, so the compiler can avoid a branch miss at every level.
+       size_type node = 1;
+       while (node <= used) {
+#ifdef __GNUC__
+           // Only near the top: further down, the line the walk is
+           // headed for is past the end of tree (and so is the pointer).
+           if(node * LINE_ITEMS <= used) {
+               __builtin_prefetch(tree + node * LINE_ITEMS);
+           }
+#endif
+           node = 2 * node + (tree[node] < target ? 1 : 0);
+       }
+
+       // node's path went right until it went left at the node we want,
+       // then right all the way down: drop those trailing right turns,
+       // then the left turn. 0 means every item is less than target.
+       while (node % 2 == 1) {
+           node /= 2;
+       }
+       return node / 2;
+   }
+}
@@ -0,0 +1,121 @@
+// FILE: SequenceFrozen.h
+// CLASS PROVIDED: frozen_sequence (part of the namespace CS3358_FA2017)
+//
+// A frozen_sequence is a read-only copy of a sorted sequence, laid out
+// for fast searching. The items are stored in Eytzinger (breadth-first)
+// order: item 1 is the root of a complete binary search tree, and the
+// children of item k are items 2k and 2k+1. A search walks down from the
+// root and so reads the top of the tree, which every search shares, from
+// the cache; the next few levels it's headed for are prefetched while it
+// compares, since they're packed together. A binary search of a sorted
+// array, by contrast, jumps to a new cache line at nearly every step, so
+// once the items don't fit in the cache this layout searches faster.
+//
+// The items can still be visited in increasing order with the cursor
+// functions: the next item in order is found from a node's position by
+// arithmetic alone, without any extra table.
+//
+// TYPEDEFS for the frozen_sequence class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+// CONSTRUCTORS for the frozen_sequence class:
+//   frozen_sequence()
+//    Post: The frozen_sequence is empty.
+//
+//   frozen_sequence(const sequence& source)
+//    Pre:  source is sorted (its items are in increasing order).
+//    Post: The frozen_sequence holds the items of source, as if by
+//      freeze(source).
+//
+// MODIFICATION MEMBER FUNCTIONS for the frozen_sequence class:
+//   void freeze(const sequence& source)
+//    Pre:  source is sorted.
+//    Post: The frozen_sequence holds the items of source, in place of
+//      whatever it held before, and there is no current item. source is
+//      not changed. Takes O(n) time.
+//
+//   void start()
+//    Pre:  none
+//    Post: The smallest item becomes the current item (but if the
+//      frozen_sequence is empty, then there is no current item).
+//
+//   void advance()
+//    Pre:  is_item returns true.
+//    Post: The next larger item (in the order of the sequence that was
+//      frozen) becomes the current item, or if the current item was the
+//      largest, there is no longer any current item. Amortized O(1).
+//
+//   bool seek(const value_type& target)
+//    Pre:  none
+//    Post: The first item that is not less than target becomes the
+//      current item (if there isn't one, there is no current item). The
+//      return value is true if that item equals target. O(log n).
+//
+// CONSTANT MEMBER FUNCTIONS for the frozen_sequence class:
+//   size_type size() const
+//    Post: The return value is the number of items.
+//
+//   bool is_item() const
+//   value_type current() const
+//    Pre:  is_item() returns true for current.
+//    Post: As for the sequence class.
+//
+//   bool contains(const value_type& target) const
+//    Pre:  none
+//    Post: The return value is true if target is one of the items. The
+//      current item is unchanged. O(log n).
+//
+//   void thaw(sequence& dest) const
+//    Pre:  none
+//    Post: dest holds the items in increasing order, and its first item
+//      (if any) is the current item.
+//
+// VALUE SEMANTICS for the frozen_sequence class:
+//   Assignments and the copy constructor may be used with frozen_sequence
+//   objects.
+
+#ifndef SEQUENCE_FROZEN_H
+#define SEQUENCE_FROZEN_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class frozen_sequence
+   {
+   public:
+      // TYPEDEFS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      // CONSTRUCTORS and DESTRUCTOR
+      frozen_sequence();
+      frozen_sequence(const sequence& source);
+      frozen_sequence(const frozen_sequence& source);
+      ~frozen_sequence();
+      // MODIFICATION MEMBER FUNCTIONS
+      void freeze(const sequence& source);
+      void start();
+      void advance();
+      bool seek(const value_type& target);
+      frozen_sequence& operator=(const frozen_sequence& source);
+      // CONSTANT MEMBER FUNCTIONS
+      size_type size() const;
+      bool is_item() const;
+      value_type current() const;
+      bool contains(const value_type& target) const;
+      void thaw(sequence& dest) const;
+   private:
+      value_type* storage;    // the dynamic array, as allocated
+      value_type* tree;       // tree[1] through tree[used], in storage
+      size_type used;
+      size_type current_node;
+      // HELPER MEMBER FUNCTIONS
+      void allocate(size_type count);
+      size_type first_node() const;
+      size_type next_node(size_type node) const;
+      size_type lower_bound(const value_type& target) const;
+   };
+}
+
+#endif
@@ -0,0 +1,182 @@
+// FILE: SequenceHandle.cpp
+// CLASS IMPLEMENTED: handle_table (see SequenceHandle.h for documentation)
+// INVARIANT for the handle_table class:
+//   1. ids[0] through ids[used-1] hold, for each position of the
+//      sequence, the id of the item there, or NONE if it has none. ids
+//      has room for id_capacity entries.
+//   2. Ids 0 through slots-1 have been handed out; positions and
+//      generations have room for slot_capacity of them. A live id
+//      appears exactly once in ids. A free id appears nowhere in ids;
+//      it's on the free list that starts at free_head, and positions[id]
+//      is the next free id (NONE at the end of the list).
+//   3. Every live id whose item is before position dirty_from has its
+//      position in positions. Any other live id has a stale position, of
+//      dirty_from or more. dirty_from is never more than the number of
+//      items.
+//   4. The handle of the item of a live id is {id, generations[id]}.
+//      generations[id] goes up by one whenever id is freed.
+
+#include <cassert>
+#include "SequenceHandle.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      const handle_table::size_type NONE = handle_table::size_type(-1);
+      const handle_table::size_type INITIAL_SLOTS = 16;
+   }
+
+   // CONSTRUCTOR and DESTRUCTOR
+   handle_table::handle_table(size_type used) : ids(NULL), id_capacity(0),
+           slots(0), slot_capacity(INITIAL_SLOTS), free_head(NONE),
+           dirty_from(used)
+   {
+       reserve_ids(used);
+       for (size_type position = 0; position < used; ++position) {
+           ids[position] = NONE;
+       }
+       positions = new size_type[slot_capacity];
+       generations = new size_type[slot_capacity];
+   }
+
+   handle_table::~handle_table()
+   {
+       delete [] ids;
+       delete [] positions;
+       delete [] generations;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void handle_table::note_insert(size_type used, size_type position)
+   {
+       reserve_ids(used);
+       for (size_type index = used - 1; index > position; --index) {
+           ids[index] = ids[index - 1];
+       }
+       ids[position] = NONE;
+       if(position < dirty_from){dirty_from = position;}
+   }
+
+   void handle_table::note_remove(size_type used, size_type position)
+   {
+       if(ids[position] != NONE){release(ids[position]);}
+       for (size_type index = position; index < used; ++index) {
+           ids[index] = ids[index + 1];
+       }
+       if(position < dirty_from){dirty_from = position;}
+   }
+
+   void handle_table::note_kill(size_type position)
+   {
+       if(ids[position] != NONE){release(ids[position]);}
+       ids[position] = NONE;
+   }
+
+   void handle_table::note_move(size_type from, size_type to)
+   {
+       ids[to] = ids[from];
+       if(to < dirty_from){dirty_from = to;}
+   }
+
+   void handle_table::note_replace(size_type old_used, size_type new_used)
+   {
+       for (size_type position = 0; position < old_used; ++position) {
+           if(ids[position] != NONE){release(ids[position]);}
+       }
+       reserve_ids(new_used);
+       for (size_type position = 0; position < new_used; ++position) {
+           ids[position] = NONE;
+       }
+       dirty_from = new_used;
+   }
+
+   handle_table::item_handle handle_table::handle_at(size_type position)
+   {
+       size_type id = ids[position];
+       if(id == NONE) {
+
+           // Reuse a free id if there is one, or hand out a new one.
+           if(free_head != NONE) {
+               id = free_head;
+               free_head = positions[id];
+           } else {
+               if(slots == slot_capacity){grow_slots();}
+               id = slots;
+               generations[id] = 0;
+               ++slots;
+           }
+           ids[position] = id;
+           positions[id] = position;
+       }
+
+       item_handle answer;
+       answer.id = id;
+       answer.generation = generations[id];
+       return answer;
+   }
+
+   bool handle_table::find(const item_handle& handle, size_type used,
+                           size_type& position)
+   {
+       // Protect pre-condition.
+       assert(handle.id < slots);
+
+       if(generations[handle.id] != handle.generation){return false;}
+
+       // A position of dirty_from or more may be stale (invariant #3).
+       if(positions[handle.id] >= dirty_from){repair(used);}
+       position = positions[handle.id];
+       return true;
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   void handle_table::release(size_type id)
+   {
+       ++generations[id];
+       positions[id] = free_head;
+       free_head = id;
+   }
+
+   void handle_table::grow_slots()
+   {
+       size_type new_capacity = size_type(1.25 * slot_capacity) + 1;
+       size_type* temp_positions = new size_type[new_capacity];
+       size_type* temp_generations = new size_type[new_capacity];
+       for (size_type slot = 0; slot < slots; ++slot) {
+           temp_positions[slot] = positions[slot];
+           temp_generations[slot] = generations[slot];
+       }
+       delete [] positions;
+       delete [] generations;
+       positions = temp_positions;
+       generations = temp_generations;
+       slot_capacity = new_capacity;
+   }
+
+   void handle_table::reserve_ids(size_type used)
+   {
+       // Grow the way sequence::insert grows a sequence.
+       if(used <= id_capacity){return;}
+
+       size_type new_capacity = size_type(1.25 * id_capacity) + 1;
+       if(new_capacity < used){new_capacity = used;}
+       size_type* temp_ids = new size_type[new_capacity];
+       for (size_type index = 0; index < id_capacity; ++index) {
+           temp_ids[index] = ids[index];
+       }
+       delete [] ids;
+       ids = temp_ids;
+       id_capacity = new_capacity;
+   }
+
+   void handle_table::repair(size_type used)
+   {
+       for (size_type position = dirty_from; position < used; ++position) {
+           if(ids[position] != NONE){positions[ids[position]] = position;}
+       }
+       dirty_from = used;
+   }
+}
@@ -0,0 +1,118 @@
+// FILE: SequenceHandle.h
+// CLASS PROVIDED: handle_table (part of the namespace CS3358_FA2017)
+//
+// A handle_table gives the items of a sequence stable handles (see
+// sequence::enable_handles in Sequence.h). It isn't meant to be used on
+// its own. Each handle is an id, and the table has two arrays: one from
+// each position of the sequence to the id of the item there (if it has
+// been given one), and one from each id to the position of its item. A
+// handle is looked up through the second array in O(1) time.
+//
+// The first array is shifted along with the sequence's items, so an
+// insert or remove costs no more than it did. The positions in the
+// second array aren't updated right away: like value_index, the table
+// remembers the lowest position that may have moved, and the positions
+// from there on are repaired by the next lookup that needs them.
+//
+// An id goes back on a free list when its item is removed, and its
+// generation number goes up, so handles to the removed item no longer
+// match it.
+//
+// TYPEDEFS for the handle_table class:
+//   typedef ____ size_type
+//   typedef ____ item_handle
+//    Same as sequence::size_type and sequence::item_handle.
+//
+// CONSTRUCTOR for the handle_table class:
+//   handle_table(size_type used)
+//    Pre:  The sequence has used items.
+//    Post: No item has a handle yet.
+//
+// MODIFICATION MEMBER FUNCTIONS for the handle_table class:
+//   void note_insert(size_type used, size_type position)
+//    Pre:  An item has just been inserted at position of the sequence,
+//      which now has used items.
+//    Post: The table has taken note of the new item (which has no
+//      handle yet).
+//
+//   void note_remove(size_type used, size_type position)
+//    Pre:  The item at position has just been removed from the sequence,
+//      which now has used items.
+//    Post: Handles to the removed item are invalid.
+//
+//   void note_kill(size_type position)
+//    Pre:  position < the number of items.
+//    Post: Handles to the item at position are invalid, but no items
+//      have moved (the sequence has only marked its slot dead).
+//
+//   void note_move(size_type from, size_type to)
+//    Pre:  to < from < the number of items.
+//    Post: The table has taken note that the item at from is now at to.
+//
+//   void note_replace(size_type old_used, size_type new_used)
+//    Pre:  The sequence's old_used items have been replaced by new_used
+//      other items.
+//    Post: Every handle handed out so far is invalid.
+//
+//   item_handle handle_at(size_type position)
+//    Pre:  position < the number of items.
+//    Post: The return value is the handle of the item at position, which
+//      is given one if it doesn't have one yet.
+//
+//   bool find(const item_handle& handle, size_type used,
+//             size_type& position)
+//    Pre:  The sequence has used items, and handle was returned by
+//      handle_at of this table.
+//    Post: If handle's item is still in the sequence, the return value is
+//      true and position is where it is. Otherwise the return value is
+//      false and position is unchanged.
+//
+// VALUE SEMANTICS for the handle_table class:
+//   handle_table objects may not be copied or assigned. A sequence that
+//   is copied gives the copy a new, empty table.
+
+#ifndef SEQUENCE_HANDLE_H
+#define SEQUENCE_HANDLE_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class handle_table
+   {
+   public:
+      // TYPEDEFS
+      typedef sequence::size_type size_type;
+      typedef sequence::item_handle item_handle;
+      // CONSTRUCTOR and DESTRUCTOR
+      handle_table(size_type used);
+      ~handle_table();
+      // MODIFICATION MEMBER FUNCTIONS
+      void note_insert(size_type used, size_type position);
+      void note_remove(size_type used, size_type position);
+      void note_kill(size_type position);
+      void note_move(size_type from, size_type to);
+      void note_replace(size_type old_used, size_type new_used);
+      item_handle handle_at(size_type position);
+      bool find(const item_handle& handle, size_type used,
+                size_type& position);
+   private:
+      size_type* ids;         // ids[p] is the id of the item at p, or NONE
+      size_type id_capacity;
+      size_type* positions;   // where each id's item is (or next free id)
+      size_type* generations;
+      size_type slots;        // ids handed out so far, live or free
+      size_type slot_capacity;
+      size_type free_head;    // first free id, or NONE
+      size_type dirty_from;
+      // HELPER MEMBER FUNCTIONS
+      void release(size_type id);
+      void grow_slots();
+      void reserve_ids(size_type used);
+      void repair(size_type used);
+      // Not copyable: see VALUE SEMANTICS above.
+      handle_table(const handle_table& source);
+      handle_table& operator=(const handle_table& source);
+   };
+}
+
+#endif
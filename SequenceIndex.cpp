@@ -0,0 +1,281 @@
+// FILE: SequenceIndex.cpp
+// CLASS IMPLEMENTED: value_index (see SequenceIndex.h for documentation)
+// INVARIANT for the value_index class:
+//   1. The table is an open-addressing hash table with linear probing of
+//      slots slots (a power of 2). Slot i holds the key keys[i] and the
+//      position positions[i] when states[i] is FULL. ERASED slots held
+//      a key that has since been erased; a search has to step past them,
+//      but they can be reused for new keys. There are live FULL slots and
+//      erased ERASED slots, and live + erased is kept below half of
+//      slots so searches stay short.
+//   2. Every item of the sequence before position dirty_from is trusted:
+//      for each distinct (non-NaN) value among items[0] through
+//      items[dirty_from-1], the table holds that value with the position
+//      of its first occurrence. Entries with a position of dirty_from or
+//      more are stale, and items from dirty_from on may be missing from
+//      the table altogether. dirty_from is never more than the number of
+//      items. stale is false only if there are no stale entries, so when
+//      it's false and dirty_from equals the number of items the whole
+//      table is up to date.
+
+#include <cassert>
+#include <cstring>     // provides memcpy
+#include "SequenceIndex.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      const value_index::size_type INITIAL_SLOTS = 16;
+   }
+
+   // CONSTRUCTOR and DESTRUCTOR
+   value_index::value_index() :
+           slots(INITIAL_SLOTS), live(0), erased(0), dirty_from(0),
+           stale(false)
+   {
+       keys = new value_type[slots];
+       positions = new size_type[slots];
+       states = new unsigned char[slots];
+       for (size_type slot = 0; slot < slots; ++slot) {
+           states[slot] = EMPTY;
+       }
+   }
+
+   value_index::~value_index()
+   {
+       delete [] keys;
+       delete [] positions;
+       delete [] states;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void value_index::note_insert(const value_type* items, size_type used,
+                                 size_type position)
+   {
+       if(dirty_from + 1 == used && !stale) {
+           // The table was up to date, so bring it along with the shift:
+           // each moved item that was its value's first occurrence moves
+           // up one place. Going down from the end, an entry moved for
+           // one item is never mistaken for that of a later copy.
+           for (size_type index = used - 1; index > position; --index) {
+               value_type moved = items[index];
+               if(moved != moved){continue;}   // NaN
+               size_type slot = probe(moved);
+               if(states[slot] == FULL && positions[slot] + 1 == index) {
+                   positions[slot] = index;
+               }
+           }
+
+           // The new item is its value's first occurrence unless an
+           // earlier copy is already there.
+           value_type entry = items[position];
+           if(entry == entry) {
+               size_type slot = probe(entry);
+               if(states[slot] != FULL){put(entry, position);}
+               else if(positions[slot] > position) {
+                   positions[slot] = position;
+               }
+           }
+           dirty_from = used;
+       } else if(position < dirty_from) {
+           // Every item from position on has moved up one place.
+           dirty_from = position;
+           stale = true;
+       }
+   }
+
+   void value_index::note_remove(const value_type* items, size_type used,
+                                 size_type position, const value_type& entry)
+   {
+       if(dirty_from == used + 1 && !stale) {
+           // The table was up to date: each moved item that was its
+           // value's first occurrence moves down one place.
+           for (size_type index = position; index < used; ++index) {
+               value_type moved = items[index];
+               if(moved != moved){continue;}   // NaN
+               size_type slot = probe(moved);
+               if(states[slot] == FULL && positions[slot] == index + 1) {
+                   positions[slot] = index;
+               }
+           }
+
+           // If entry's first occurrence was removed, its next one (if
+           // any) is the first now.
+           if(entry == entry) {
+               size_type slot = probe(entry);
+               if(states[slot] == FULL && positions[slot] == position) {
+                   size_type next = position;
+                   while (next < used && !(items[next] == entry)) {
+                       ++next;
+                   }
+                   if(next < used){positions[slot] = next;}
+                   else {erase_at(slot);}
+               }
+           }
+           dirty_from = used;
+       } else if(position < dirty_from) {
+           dirty_from = position;
+           stale = true;
+       }
+   }
+
+   void value_index::note_change(size_type first)
+   {
+       if(first < dirty_from) {
+           dirty_from = first;
+           stale = true;
+       }
+   }
+
+   bool value_index::find(const value_type* items, size_type used,
+                          const value_type& target, size_type& position)
+   {
+       if(target != target){return false;}   // NaN
+
+       // Bring the table up to date first (invariant #2).
+       if(dirty_from < used || stale){repair(items, used);}
+
+       size_type slot = probe(target);
+       if(states[slot] != FULL){return false;}
+
+       position = positions[slot];
+       return true;
+   }
+
+   // STATIC MEMBER FUNCTION
+   value_index::size_type value_index::hash(value_type key)
+   {
+       // -0.0 == 0.0, so both have to hash alike. The bits are folded
+       // into an unsigned long, then mixed (with the finishing steps of
+       // MurmurHash3) so that every bit of the key affects the low bits
+       // used to pick a slot.
+       if(key == 0){key = 0;}
+
+       const size_t WORDS = sizeof(key) / sizeof(unsigned long) + 1;
+       unsigned long words[WORDS];
+       for (size_t index = 0; index < WORDS; ++index) {
+           words[index] = 0;
+       }
+       memcpy(words, &key, sizeof(key));
+
+       unsigned long mixed = 0;
+       for (size_t index = 0; index < WORDS; ++index) {
+           mixed = mixed * 31 + words[index];
+       }
+       mixed ^= (mixed >> 16) >> 16;   // top half of a 64-bit long
+       mixed ^= mixed >> 16;
+       mixed *= 0x85ebca6bUL;
+       mixed ^= mixed >> 13;
+       mixed *= 0xc2b2ae35UL;
+       mixed ^= mixed >> 16;
+       return size_type(mixed);
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   value_index::size_type value_index::probe(const value_type& key) const
+   {
+       // Step through the probe sequence of key until it's found, or an
+       // EMPTY slot shows it isn't in the table. Invariant #1 guarantees
+       // there is an EMPTY slot.
+       size_type mask = slots - 1;
+       size_type slot = hash(key) & mask;
+       while (states[slot] != EMPTY) {
+           if(states[slot] == FULL && keys[slot] == key){return slot;}
+           slot = (slot + 1) & mask;
+       }
+       return slot;
+   }
+
+   void value_index::put(const value_type& key, size_type position)
+   {
+       // Pre: key isn't in the table. Keep invariant #1's load limit.
+       if((live + erased + 1) * 2 > slots) {
+           size_type new_slots = INITIAL_SLOTS;
+           while (new_slots < 4 * (live + 1)) {
+               new_slots *= 2;
+           }
+           rehash(new_slots);
+       }
+
+       // The first slot on the probe sequence that isn't FULL will do,
+       // since key isn't further along it.
+       size_type mask = slots - 1;
+       size_type slot = hash(key) & mask;
+       while (states[slot] == FULL) {
+           slot = (slot + 1) & mask;
+       }
+       if(states[slot] == ERASED){--erased;}
+       states[slot] = FULL;
+       keys[slot] = key;
+       positions[slot] = position;
+       ++live;
+   }
+
+   void value_index::erase_at(size_type slot)
+   {
+       // Searches for other keys may have to step past this slot, so it
+       // can't simply become EMPTY.
+       states[slot] = ERASED;
+       --live;
+       ++erased;
+   }
+
+   void value_index::repair(const value_type* items, size_type used)
+   {
+       // Drop the stale entries, then record the first occurrence of each
+       // item from dirty_from on that isn't already in the table.
+       if(dirty_from == 0) {
+           for (size_type slot = 0; slot < slots; ++slot) {
+               states[slot] = EMPTY;
+           }
+           live = 0;
+           erased = 0;
+       } else {
+           for (size_type slot = 0; slot < slots; ++slot) {
+               if(states[slot] == FULL && positions[slot] >= dirty_from) {
+                   erase_at(slot);
+               }
+           }
+       }
+
+       for (size_type index = dirty_from; index < used; ++index) {
+           value_type entry = items[index];
+           if(entry != entry){continue;}   // NaN
+           size_type slot = probe(entry);
+           if(states[slot] != FULL){put(entry, index);}
+       }
+       dirty_from = used;
+       stale = false;
+   }
+
+   void value_index::rehash(size_type new_slots)
+   {
+       value_type* old_keys = keys;
+       size_type* old_positions = positions;
+       unsigned char* old_states = states;
+       size_type old_slots = slots;
+
+       keys = new value_type[new_slots];
+       positions = new size_type[new_slots];
+       states = new unsigned char[new_slots];
+       slots = new_slots;
+       for (size_type slot = 0; slot < slots; ++slot) {
+           states[slot] = EMPTY;
+       }
+       live = 0;
+       erased = 0;
+
+       for (size_type slot = 0; slot < old_slots; ++slot) {
+           if(old_states[slot] == FULL) {
+               put(old_keys[slot], old_positions[slot]);
+           }
+       }
+
+       delete [] old_keys;
+       delete [] old_positions;
+       delete [] old_states;
+   }
+}
@@ -0,0 +1,116 @@
+// FILE: SequenceIndex.h
+// CLASS PROVIDED: value_index (part of the namespace CS3358_FA2017)
+//
+// A value_index is a hash table that maps each distinct item of a
+// sequence to the position of its first occurrence, so "where is x" can
+// be answered in O(1) expected time instead of by a linear scan. It's
+// used by the sequence class (see sequence::enable_index in Sequence.h)
+// and isn't meant to be used on its own: it doesn't own the items, so
+// every operation is given the sequence's array and number of items.
+//
+// An insert or remove on an up-to-date table updates it at once: the
+// entry of every item the edit shifted is moved along with it, at O(1)
+// expected time per item, so the edit costs no more than the shift the
+// sequence makes anyway (appending at the end costs O(1)). Alternating
+// edits and lookups therefore never rebuild anything. Other changes, and
+// edits made while the table is already out of date (before it was
+// first built, say), aren't applied item by item: the index only
+// remembers the lowest position that may have changed, and the table is
+// repaired from there by the next lookup.
+//
+// TYPEDEFS for the value_index class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+// CONSTRUCTOR for the value_index class:
+//   value_index()
+//    Post: The index is empty, and will be built from scratch by the
+//      first find.
+//
+// MODIFICATION MEMBER FUNCTIONS for the value_index class:
+//   void note_insert(const value_type* items, size_type used,
+//                    size_type position)
+//    Pre:  items[position] has just been inserted into the sequence,
+//      which now has used items (those after it having moved up one).
+//    Post: The index has taken note of the new item.
+//
+//   void note_remove(const value_type* items, size_type used,
+//                    size_type position, const value_type& entry)
+//    Pre:  entry has just been removed from position of the sequence,
+//      which now has the used items items[0] through items[used-1]
+//      (those after it having moved down one).
+//    Post: The index has taken note of the removal.
+//
+//   void note_change(size_type first)
+//    Pre:  none
+//    Post: The index will treat every item from position first on as
+//      changed.
+//
+//   bool find(const value_type* items, size_type used,
+//             const value_type& target, size_type& position)
+//    Pre:  items[0] through items[used-1] are the items of the sequence.
+//    Post: If target is one of the items, the return value is true and
+//      position is the position of its first occurrence. Otherwise the
+//      return value is false and position is unchanged. NaN is never
+//      found (it isn't equal to anything).
+//
+// STATIC MEMBER FUNCTION for the value_index class:
+//   static size_type hash(value_type key)
+//    Pre:  none
+//    Post: The return value is a hash of key in which every bit of the
+//      key affects every bit of the hash. Equal keys (including 0.0 and
+//      -0.0) hash alike. It's also used by membership_filter.
+//
+// VALUE SEMANTICS for the value_index class:
+//   value_index objects may not be copied or assigned. A sequence that
+//   is copied builds a new index of its own.
+
+#ifndef SEQUENCE_INDEX_H
+#define SEQUENCE_INDEX_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class value_index
+   {
+   public:
+      // TYPEDEFS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      // CONSTRUCTOR and DESTRUCTOR
+      value_index();
+      ~value_index();
+      // MODIFICATION MEMBER FUNCTIONS
+      void note_insert(const value_type* items, size_type used,
+                       size_type position);
+      void note_remove(const value_type* items, size_type used,
+                       size_type position, const value_type& entry);
+      void note_change(size_type first);
+      bool find(const value_type* items, size_type used,
+                const value_type& target, size_type& position);
+      // STATIC MEMBER FUNCTION
+      static size_type hash(value_type key);
+   private:
+      enum slot_state { EMPTY, FULL, ERASED };
+      value_type* keys;
+      size_type* positions;
+      unsigned char* states;
+      size_type slots;        // always a power of 2
+      size_type live;         // slots in state FULL
+      size_type erased;       // slots in state ERASED
+      size_type dirty_from;
+      bool stale;             // entries at dirty_from or later may exist
+      // HELPER MEMBER FUNCTIONS
+      size_type probe(const value_type& key) const;
+      void put(const value_type& key, size_type position);
+      void erase_at(size_type slot);
+      void repair(const value_type* items, size_type used);
+      void rehash(size_type new_slots);
+      // Not copyable: see VALUE SEMANTICS above.
+      value_index(const value_index& source);
+      value_index& operator=(const value_index& source);
+   };
+}
+
+#endif
@@ -0,0 +1,390 @@
+// FILE: SequenceLog.cpp
+// CLASS IMPLEMENTED: logged_sequence (see SequenceLog.h for
+//   documentation)
+// INVARIANT for the logged_sequence class:
+//   1. items is the sequence, with checkpoints enabled (so it can be
+//      saved as a snapshot), and cursor is the position of its current
+//      item (items.size() if there is none). logged_cursor is where the
+//      current item would be after replaying the log and buffer.
+//   2. The snapshot named by generation (none if it's 0), followed by
+//      the groups in the log at base_path.log, gives items as it was at
+//      the last commit. log is that file, open for appending, unless a
+//      write to it has failed (then it's NULL).
+//   3. buffer[0] through buffer[buffer_used-1] hold the records made
+//      since then, of which there are records (less than group_size,
+//      between calls). A record is its letter, followed for 'I' and 'A'
+//      by the bytes of the entry, and for 'J' by the position as the
+//      bytes of an unsigned long. buffer has room for buffer_capacity
+//      bytes: enough for group_size + 1 records, since a change may add
+//      a 'J' record as well as its own.
+//   4. healthy is false if recovery, a commit or a checkpoint has failed
+//      since the last checkpoint that succeeded.
+
+#include <cassert>
+#include <cstring>     // provides memcmp, memcpy
+#include "SequenceLog.h"
+#include "SequenceCheckpoint.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      const char MAGIC[8] = { 'S', 'E', 'Q', 'W', 'A', 'L', '0', '2' };
+
+      // The most bytes that follow a record's letter.
+      const size_t MAX_ARGUMENT =
+              (sizeof(sequence::value_type) > sizeof(unsigned long)) ?
+              sizeof(sequence::value_type) : sizeof(unsigned long);
+
+      // The start of a log. Groups follow, each a group_header and then
+      // length bytes of records.
+      struct log_header
+      {
+         char magic[8];
+         unsigned long generation;
+         unsigned long cursor;
+      };
+
+      struct group_header
+      {
+         unsigned long length;
+         unsigned long checksum;
+      };
+
+      unsigned long checksum(const unsigned char* bytes, unsigned long length)
+      {
+          // 32-bit FNV-1a.
+          unsigned long hash = 2166136261UL;
+          for (unsigned long index = 0; index < length; ++index) {
+              hash ^= bytes[index];
+              hash = (hash * 16777619UL) & 0xffffffffUL;
+          }
+          return hash;
+      }
+   }
+
+   // CONSTRUCTOR and DESTRUCTOR
+   logged_sequence::logged_sequence(const char* path, size_type group_size) :
+           base_path(path), log(NULL), generation(0), cursor(0),
+           logged_cursor(0), buffer_used(0), records(0),
+           group_size(group_size), healthy(true)
+   {
+       // Protect pre-condition.
+       assert(group_size > 0);
+
+       buffer_capacity = (group_size + 1) * (1 + MAX_ARGUMENT);
+       buffer = new unsigned char[buffer_capacity];
+       items.enable_checkpoints();
+       healthy = recover();
+   }
+
+   logged_sequence::~logged_sequence()
+   {
+       commit();
+       if(log != NULL){fclose(log);}
+       log = NULL;
+       delete [] buffer;
+       buffer = NULL;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void logged_sequence::start()
+   {
+       // Only the cursor moves, which is logged with the next change.
+       items.start();
+       cursor = 0;
+   }
+
+   void logged_sequence::advance()
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       items.advance();
+       ++cursor;
+   }
+
+   void logged_sequence::insert(const value_type& entry)
+   {
+       log_change('I', entry);
+   }
+
+   void logged_sequence::attach(const value_type& entry)
+   {
+       log_change('A', entry);
+   }
+
+   void logged_sequence::remove_current()
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       log_change('R', 0);
+   }
+
+   bool logged_sequence::commit()
+   {
+       // Recovery should find the current item where it is now.
+       if(cursor != logged_cursor){append('J', 0);}
+       if(records == 0){return healthy;}
+
+       // The whole group goes out with one write and one sync.
+       group_header header;
+       header.length = buffer_used;
+       header.checksum = checksum(buffer, buffer_used);
+       bool ok = (log != NULL) &&
+                 fwrite(&header, sizeof(header), 1, log) == 1 &&
+                 fwrite(buffer, 1, buffer_used, log) == buffer_used &&
+                 checkpoint_file::sync(log);
+       buffer_used = 0;
+       records = 0;
+
+       // A group that was only partly written would hide every later one
+       // from replay, so stop logging until the next checkpoint.
+       if(!ok) {
+           if(log != NULL){fclose(log);}
+           log = NULL;
+           healthy = false;
+       }
+       return ok;
+   }
+
+   bool logged_sequence::checkpoint()
+   {
+       // The snapshot has every change, so the records waiting for a
+       // commit aren't needed any more.
+       unsigned long next = generation + 1;
+       if(!items.save_checkpoint(snapshot_path(next).c_str()) ||
+          !start_log(next)) {
+           healthy = false;
+           return false;
+       }
+       buffer_used = 0;
+       records = 0;
+       logged_cursor = cursor;
+       healthy = true;
+       return true;
+   }
+
+   // CONSTANT MEMBER FUNCTIONS
+   logged_sequence::size_type logged_sequence::size() const
+   {
+       return items.size();
+   }
+
+   bool logged_sequence::is_item() const
+   {
+       return items.is_item();
+   }
+
+   logged_sequence::value_type logged_sequence::current() const
+   {
+       return items.current();
+   }
+
+   const sequence& logged_sequence::contents() const
+   {
+       return items;
+   }
+
+   logged_sequence::size_type logged_sequence::pending() const
+   {
+       return records;
+   }
+
+   bool logged_sequence::good() const
+   {
+       return healthy;
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   bool logged_sequence::apply(char op, const value_type& entry)
+   {
+       // Make the change a record stands for, keeping cursor in step
+       // with the current item. False if op isn't a change, or can't be
+       // applied (replay checks, since a log may be damaged).
+       switch (op) {
+       case 'I':
+           if(!items.is_item()){cursor = 0;}
+           items.insert(entry);
+           break;
+       case 'A':
+           if(items.is_item()){++cursor;}
+           items.attach(entry);
+           break;
+       case 'R':
+           if(!items.is_item()){return false;}
+           items.remove_current();
+           break;
+       default:
+           return false;
+       }
+       return true;
+   }
+
+   bool logged_sequence::jump(unsigned long position)
+   {
+       // Make the item at position the current item (none, if position
+       // is the size), walking on from the current item if it's before
+       // position. False if there is no such position.
+       if(position > items.size()){return false;}
+       if(position < cursor) {
+           items.start();
+           cursor = 0;
+       }
+       for (; cursor < position; ++cursor) {
+           items.advance();
+       }
+       return true;
+   }
+
+   void logged_sequence::log_change(char op, const value_type& entry)
+   {
+       // A change is made at the current item, so if that has moved
+       // since the last record, replay has to be told where it is first.
+       if(cursor != logged_cursor){append('J', 0);}
+       apply(op, entry);
+       append(op, entry);
+       logged_cursor = cursor;
+       if(records >= group_size){commit();}
+   }
+
+   void logged_sequence::append(char op, const value_type& entry)
+   {
+       // A 'J' record holds the current position; entry is ignored.
+       buffer[buffer_used] = op;
+       ++buffer_used;
+       if(op == 'I' || op == 'A') {
+           memcpy(buffer + buffer_used, &entry, sizeof(value_type));
+           buffer_used += sizeof(value_type);
+       }
+       if(op == 'J') {
+           unsigned long position = cursor;
+           memcpy(buffer + buffer_used, &position, sizeof(position));
+           buffer_used += sizeof(position);
+           logged_cursor = cursor;
+       }
+       ++records;
+   }
+
+   bool logged_sequence::recover()
+   {
+       // With no log yet, start one for an empty sequence.
+       string log_name = base_path + ".log";
+       FILE* file = fopen(log_name.c_str(), "rb");
+       if(file == NULL){return start_log(0);}
+
+       log_header header;
+       bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+                 memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0;
+       if(ok && header.generation > 0) {
+           ok = items.load_checkpoint(
+                   snapshot_path(header.generation).c_str());
+       }
+       if(!ok) {
+           fclose(file);
+           return false;
+       }
+
+       // Put the current item back where it was, then replay.
+       generation = header.generation;
+       items.start();
+       cursor = 0;
+       bool complete = jump(header.cursor) && replay(file);
+       logged_cursor = cursor;
+       fclose(file);
+
+       // After a torn group, new groups can't just be appended (replay
+       // would never reach them), so start afresh from a snapshot.
+       if(!complete){return checkpoint();}
+       log = fopen(log_name.c_str(), "ab");
+       return (log != NULL);
+   }
+
+   bool logged_sequence::replay(FILE* file)
+   {
+       // Apply every group in the rest of file. True if it ends cleanly,
+       // false if a group is cut short, damaged or can't be applied (the
+       // groups before it are applied).
+       // A length past the end of the file is a group cut short. It's
+       // checked before the bytes are allocated, so a damaged header
+       // can't ask for any amount of memory.
+       long here = ftell(file);
+       if(here < 0 || fseek(file, 0, SEEK_END) != 0){return false;}
+       long end = ftell(file);
+       if(end < here || fseek(file, here, SEEK_SET) != 0){return false;}
+       unsigned long left = (unsigned long)(end - here);
+
+       group_header header;
+       size_t got;
+       while ((got = fread(&header, 1, sizeof(header), file)) ==
+              sizeof(header)) {
+           left -= sizeof(header);
+           if(header.length > left){return false;}
+           left -= header.length;
+           unsigned char* bytes =
+                   new unsigned char[(header.length > 0) ? header.length : 1];
+           bool ok = fread(bytes, 1, header.length, file) == header.length &&
+                     checksum(bytes, header.length) == header.checksum;
+           unsigned long next = 0;
+           while (ok && next < header.length) {
+               char op = bytes[next];
+               ++next;
+               value_type entry = 0;
+               unsigned long position = 0;
+               if(op == 'I' || op == 'A') {
+                   ok = (header.length - next >= sizeof(value_type));
+                   if(ok){memcpy(&entry, bytes + next, sizeof(value_type));}
+                   next += sizeof(value_type);
+               }
+               if(op == 'J') {
+                   ok = (header.length - next >= sizeof(position));
+                   if(ok){memcpy(&position, bytes + next, sizeof(position));}
+                   next += sizeof(position);
+                   if(ok){ok = jump(position);}
+               }
+               else if(ok){ok = apply(op, entry);}
+           }
+           delete [] bytes;
+           if(!ok){return false;}
+       }
+       return (got == 0 && !ferror(file));
+   }
+
+   bool logged_sequence::start_log(unsigned long new_generation)
+   {
+       // Write the new log beside the old one and swap it in with one
+       // rename, so a crash leaves one or the other.
+       log_header header;
+       memcpy(header.magic, MAGIC, sizeof(MAGIC));
+       header.generation = new_generation;
+       header.cursor = cursor;
+       string log_name = base_path + ".log";
+       string temp_name = log_name + ".tmp";
+       FILE* file = fopen(temp_name.c_str(), "wb");
+       if(file == NULL){return false;}
+       bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 checkpoint_file::sync(file);
+       if(fclose(file) != 0){ok = false;}
+       if(ok && rename(temp_name.c_str(), log_name.c_str()) != 0) {
+           remove(log_name.c_str());
+           ok = (rename(temp_name.c_str(), log_name.c_str()) == 0);
+       }
+       if(!ok) {
+           remove(temp_name.c_str());
+           return false;
+       }
+
+       if(log != NULL){fclose(log);}
+       log = fopen(log_name.c_str(), "ab");
+       generation = new_generation;
+       return (log != NULL);
+   }
+
+   string logged_sequence::snapshot_path(unsigned long snapshot) const
+   {
+       return base_path + ((snapshot % 2 == 0) ? ".snap0" : ".snap1");
+   }
+}
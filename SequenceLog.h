@@ -0,0 +1,177 @@
+// FILE: SequenceLog.h
+// CLASS PROVIDED: logged_sequence (part of the namespace CS3358_FA2017)
+//
+// A logged_sequence is a sequence that survives the program (or the
+// machine) stopping. Every insert, attach and remove_current is appended
+// to a write-ahead log as a record named by its letter in the Assign03
+// menu ('I', 'A' and 'R'), and the next logged_sequence made with the
+// same path replays the log to get back to where it left off.
+//
+// start and advance change nothing but the current item, so they aren't
+// logged: a read-only pass over the items writes nothing. The position
+// of the current item is written in the log's header at each
+// checkpoint, and as a 'J' record (jump to a position) before the
+// first change, or commit, after it has moved.
+//
+// Records are kept in memory and written in groups: commit writes all
+// of the records made since the last commit, and forces them out to
+// disk once (with fsync, on POSIX systems), so the cost of that is
+// shared by the whole group. A commit happens by itself whenever
+// group_size records are waiting, and when the logged_sequence is
+// destroyed. Changes that haven't been committed are lost if the
+// program stops.
+//
+// So that the log doesn't grow forever, checkpoint saves the whole
+// sequence as a snapshot (see SequenceCheckpoint.h) and starts a new,
+// empty log. Recovery loads the last snapshot, then replays the log.
+// Every snapshot is written in full, in time proportional to the size
+// of the sequence: the two snapshot files below take turns, and only a
+// save to the same path as the last one can skip the unchanged blocks.
+//
+// The files at path are:
+//   path.log    the log: a header naming the snapshot it follows (and
+//               where its current item was), then one group of
+//               records after another, each with its length and a
+//               checksum;
+//   path.snap0 and path.snap1
+//               the last two snapshots (each a checkpoint, which is
+//               itself more than one file).
+// A group cut short by a crash fails its checksum, and it and anything
+// after it are ignored. A new log is written beside the old one and
+// renamed over it, after the snapshot it follows has been saved, so
+// there is always a snapshot and log that go together.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the logged_sequence class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+//   static const size_type DEFAULT_GROUP = _____
+//    The default number of records in a group commit.
+//
+// CONSTRUCTOR for the logged_sequence class:
+//   logged_sequence(const char* path, size_type group_size = DEFAULT_GROUP)
+//    Pre:  group_size > 0, and no other logged_sequence is using path.
+//    Post: The sequence is as it was when the last commit was made by a
+//      logged_sequence with the same path (empty, and with no current
+//      item, if there wasn't one). good() tells whether the files could
+//      be read and the log opened.
+//
+// MODIFICATION MEMBER FUNCTIONS for the logged_sequence class:
+//   void start()
+//   void advance()
+//    Pre:  As for the same functions of sequence (see Sequence.h).
+//    Post: As for sequence. Nothing is logged yet.
+//
+//   void insert(const value_type& entry)
+//   void attach(const value_type& entry)
+//   void remove_current()
+//    Pre:  As for the same functions of sequence.
+//    Post: As for sequence, and the change has been logged (after a 'J'
+//      record, if the current item has moved since the last record). If
+//      that makes group_size records waiting, they have been committed.
+//
+//   bool commit()
+//    Pre:  none
+//    Post: If the return value is true, every change made so far, and
+//      the position of the current item, is in the log on disk, and will
+//      be recovered. Otherwise a write failed, and good() is now false.
+//
+//   bool checkpoint()
+//    Pre:  none
+//    Post: If the return value is true, the whole sequence (with every
+//      change so far, committed or not) has been saved as a snapshot,
+//      the log has been started again empty, and good() is true again.
+//      Otherwise a file couldn't be written, good() is false, and the
+//      old snapshot and log are still there to recover from.
+//
+// CONSTANT MEMBER FUNCTIONS for the logged_sequence class:
+//   size_type size() const
+//   bool is_item() const
+//   value_type current() const
+//    Pre:  is_item() returns true, for current.
+//    Post: As for sequence.
+//
+//   const sequence& contents() const
+//    Pre:  none
+//    Post: The return value is the sequence itself, for the sequence
+//      functions that don't change it (such as those in
+//      SequenceNumeric.h).
+//
+//   size_type pending() const
+//    Pre:  none
+//    Post: The return value is the number of records not yet committed.
+//
+//   bool good() const
+//    Pre:  none
+//    Post: The return value is false if recovery, a commit or a
+//      checkpoint has failed since the last successful checkpoint. The
+//      sequence still works in memory, but changes may not be logged.
+//
+// VALUE SEMANTICS for the logged_sequence class:
+//   logged_sequence objects may not be copied or assigned (two of them
+//   can't share a log). Use contents() to copy the sequence itself.
+
+#ifndef SEQUENCE_LOG_H
+#define SEQUENCE_LOG_H
+#include <cstdio>      // provides FILE
+#include <string>
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class logged_sequence
+   {
+   public:
+      // TYPEDEFS and MEMBER CONSTANTS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      static const size_type DEFAULT_GROUP = 64;
+      // CONSTRUCTOR and DESTRUCTOR
+      logged_sequence(const char* path,
+                      size_type group_size = DEFAULT_GROUP);
+      ~logged_sequence();
+      // MODIFICATION MEMBER FUNCTIONS
+      void start();
+      void advance();
+      void insert(const value_type& entry);
+      void attach(const value_type& entry);
+      void remove_current();
+      bool commit();
+      bool checkpoint();
+      // CONSTANT MEMBER FUNCTIONS
+      size_type size() const;
+      bool is_item() const;
+      value_type current() const;
+      const sequence& contents() const;
+      size_type pending() const;
+      bool good() const;
+   private:
+      sequence items;
+      std::string base_path;
+      std::FILE* log;           // open for appending, or NULL
+      unsigned long generation; // the snapshot the log follows
+      size_type cursor;         // position of the current item
+      size_type logged_cursor;  // where replay will put it
+      unsigned char* buffer;    // records not yet committed
+      size_type buffer_used;
+      size_type buffer_capacity;
+      size_type records;        // how many records are in buffer
+      size_type group_size;
+      bool healthy;
+      // HELPER MEMBER FUNCTIONS
+      bool apply(char op, const value_type& entry);
+      bool jump(unsigned long position);
+      void log_change(char op, const value_type& entry);
+      void append(char op, const value_type& entry);
+      bool recover();
+      bool replay(std::FILE* file);
+      bool start_log(unsigned long new_generation);
+      std::string snapshot_path(unsigned long snapshot) const;
+      // Not copyable: see VALUE SEMANTICS above.
+      logged_sequence(const logged_sequence& source);
+      logged_sequence& operator=(const logged_sequence& source);
+   };
+}
+
+#endif
@@ -0,0 +1,385 @@
+// FILE: SequenceNumeric.cpp
+// FUNCTIONS IMPLEMENTED: numeric kernels for the sequence class
+//   (see SequenceNumeric.h for documentation)
+//
+// The reductions keep four independent partial sums instead of one.
+// With a single running sum every addition has to wait for the one
+// before it; with four, consecutive additions don't depend on each other
+// and the compiler can keep them in separate (vector) registers. The
+// partial sums are only combined at the end.
+
+#include <cassert>
+#include <cmath>       // provides sqrt and fabs
+#include <limits>      // provides numeric_limits
+#include "SequenceNumeric.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      // Add value to the running sum using Neumaier's compensated
+      // summation: correction collects the low-order bits that are lost
+      // when sum + value is rounded, so sum + correction stays accurate
+      // even after many additions and subtractions of large items.
+      void compensated_add(sequence::value_type& sum,
+                           sequence::value_type& correction,
+                           sequence::value_type value)
+      {
+          sequence::value_type total = sum + value;
+          if(fabs(sum) >= fabs(value)){correction += (sum - total) + value;}
+          else {correction += (value - total) + sum;}
+          sum = total;
+      }
+
+      // Write the minimum (or maximum, if want_max) of every run of window
+      // consecutive items to target. queue holds indices of the current
+      // window's items in increasing order, each one's item smaller (or
+      // larger) than every item before it in the queue, so the front is
+      // always the window's extreme. It's a circular array of window
+      // slots, starting at head.
+      void window_extreme(const sequence::value_type* items,
+                          sequence::size_type count,
+                          sequence::size_type window,
+                          sequence::value_type* target, bool want_max)
+      {
+          // With fewer items than window there's no run to write, and
+          // window may be far too big to allocate a queue for.
+          if(count < window){return;}
+
+          sequence::size_type* queue = new sequence::size_type[window];
+          sequence::size_type head = 0;
+          sequence::size_type length = 0;
+
+          for (sequence::size_type index = 0; index < count; ++index) {
+              // Drop the front index once it has slid out of the window.
+              if(length > 0 && queue[head] + window <= index) {
+                  if(++head == window){head = 0;}
+                  --length;
+              }
+
+              // Drop indices from the back whose items can never be the
+              // extreme again, since items[index] is at least as extreme
+              // and will stay in the window longer.
+              while (length > 0) {
+                  sequence::size_type back = head + length - 1;
+                  if(back >= window){back -= window;}
+                  if(want_max ? items[queue[back]] > items[index]
+                              : items[queue[back]] < items[index]) {
+                      break;
+                  }
+                  --length;
+              }
+
+              sequence::size_type slot = head + length;
+              if(slot >= window){slot -= window;}
+              queue[slot] = index;
+              ++length;
+
+              if(index + 1 >= window) {
+                  target[index + 1 - window] = items[queue[head]];
+              }
+          }
+
+          delete [] queue;
+      }
+   }
+
+   // VECTOR KERNELS
+   sequence::value_type dot(const sequence& x, const sequence& y)
+   {
+       // Every kernel reads data directly, so dead slots (see
+       // enable_lazy_remove in Sequence.h) are squeezed out first.
+       x.pack();
+       y.pack();
+
+       // Protect pre-condition.
+       assert(x.used == y.used);
+
+       // Never read past the shorter sequence, even if the assert above
+       // is compiled out.
+       const sequence::value_type* xs = x.data;
+       const sequence::value_type* ys = y.data;
+       sequence::size_type count = (y.used < x.used) ? y.used : x.used;
+       sequence::size_type index = 0;
+       sequence::value_type sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+       for ( ; index + 4 <= count; index += 4) {
+           sum0 += xs[index] * ys[index];
+           sum1 += xs[index+1] * ys[index+1];
+           sum2 += xs[index+2] * ys[index+2];
+           sum3 += xs[index+3] * ys[index+3];
+       }
+       // Pick up the (at most 3) items left over.
+       for ( ; index < count; ++index) {
+           sum0 += xs[index] * ys[index];
+       }
+
+       return (sum0 + sum1) + (sum2 + sum3);
+   }
+
+   void axpy(sequence::value_type a, const sequence& x, sequence& y)
+   {
+       x.pack();
+       y.pack();
+
+       // Protect pre-condition.
+       assert(x.used == y.used);
+
+       // Each item is independent of the others, so a single loop is
+       // already easy for the compiler to vectorize.
+       // (Bounded by the shorter sequence, as in dot.)
+       const sequence::value_type* xs = x.data;
+       sequence::value_type* ys = y.data;
+       sequence::size_type count = (y.used < x.used) ? y.used : x.used;
+       for (sequence::size_type index = 0; index < count; ++index) {
+           ys[index] += a * xs[index];
+       }
+       y.items_changed(0);
+   }
+
+   void scal(sequence::value_type a, sequence& x)
+   {
+       x.pack();
+       sequence::value_type* xs = x.data;
+       for (sequence::size_type index = 0; index < x.used; ++index) {
+           xs[index] *= a;
+       }
+       x.items_changed(0);
+   }
+
+   sequence::value_type nrm2(const sequence& x)
+   {
+       x.pack();
+       const sequence::value_type* xs = x.data;
+       sequence::size_type count = x.used;
+       sequence::size_type index = 0;
+       sequence::value_type sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+       // Fast path: plain sum of squares.
+       for ( ; index + 4 <= count; index += 4) {
+           sum0 += xs[index] * xs[index];
+           sum1 += xs[index+1] * xs[index+1];
+           sum2 += xs[index+2] * xs[index+2];
+           sum3 += xs[index+3] * xs[index+3];
+       }
+       for ( ; index < count; ++index) {
+           sum0 += xs[index] * xs[index];
+       }
+       sequence::value_type sum = (sum0 + sum1) + (sum2 + sum3);
+
+       // The squares can only have overflowed (sum is infinite or NaN) or
+       // underflowed (sum is below the smallest normal number) for very
+       // large or very small items. That's rare, so only then pay for a
+       // second pass that scales every item by the largest magnitude.
+       if(sum <= numeric_limits<sequence::value_type>::max() &&
+          sum >= numeric_limits<sequence::value_type>::min()) {
+           return sqrt(sum);
+       }
+       if(sum != sum){return sum;}   // a NaN item makes the length NaN
+
+       sequence::value_type scale = 0;
+       for (index = 0; index < count; ++index) {
+           if(fabs(xs[index]) > scale){scale = fabs(xs[index]);}
+       }
+       // All zeros, or an infinite item: no scaling needed (or possible).
+       if(scale == 0 || scale > numeric_limits<sequence::value_type>::max()) {
+           return scale;
+       }
+
+       sum = 0;
+       for (index = 0; index < count; ++index) {
+           sequence::value_type scaled = xs[index] / scale;
+           sum += scaled * scaled;
+       }
+       return scale * sqrt(sum);
+   }
+
+   sequence::value_type asum(const sequence& x)
+   {
+       x.pack();
+       const sequence::value_type* xs = x.data;
+       sequence::size_type count = x.used;
+       sequence::size_type index = 0;
+       sequence::value_type sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+       for ( ; index + 4 <= count; index += 4) {
+           sum0 += fabs(xs[index]);
+           sum1 += fabs(xs[index+1]);
+           sum2 += fabs(xs[index+2]);
+           sum3 += fabs(xs[index+3]);
+       }
+       for ( ; index < count; ++index) {
+           sum0 += fabs(xs[index]);
+       }
+
+       return (sum0 + sum1) + (sum2 + sum3);
+   }
+
+   // SCANS
+   void inclusive_scan(const sequence& source, sequence& dest)
+   {
+       // Read the source size before begin_bulk_write() empties dest,
+       // which may be the same sequence.
+       source.pack();
+       const sequence::value_type* items = source.data;
+       sequence::size_type count = source.used;
+
+       // Each item is read before the same slot is written, so this is
+       // safe when dest is source.
+       sequence::value_type* target = dest.begin_bulk_write(count);
+       sequence::value_type running = 0;
+       for (sequence::size_type index = 0; index < count; ++index) {
+           running += items[index];
+           target[index] = running;
+       }
+       dest.end_bulk_write(count);
+   }
+
+   void exclusive_scan(const sequence& source, sequence& dest,
+                       sequence::value_type initial)
+   {
+       source.pack();
+       const sequence::value_type* items = source.data;
+       sequence::size_type count = source.used;
+
+       // Hold on to each source item before its slot is overwritten with
+       // the running total of the items before it.
+       sequence::value_type* target = dest.begin_bulk_write(count);
+       sequence::value_type running = initial;
+       for (sequence::size_type index = 0; index < count; ++index) {
+           sequence::value_type entry = items[index];
+           target[index] = running;
+           running += entry;
+       }
+       dest.end_bulk_write(count);
+   }
+
+   // ROLLING-WINDOW AGGREGATES
+   void rolling_mean(const sequence& source, sequence::size_type window,
+                     sequence& dest)
+   {
+       // Protect pre-condition.
+       assert(window > 0);
+       source.pack();
+
+       // The running sum still needs items whose slots have already been
+       // written, so an in-place call goes through a temporary.
+       if(&source == &dest) {
+           sequence temp(source.used);
+           rolling_mean(source, window, temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       const sequence::value_type* items = source.data;
+       sequence::size_type count = source.used;
+       sequence::size_type result_count =
+               (count >= window) ? count - window + 1 : 0;
+
+       sequence::value_type* target = dest.begin_bulk_write(result_count);
+       sequence::value_type sum = 0;
+       sequence::value_type correction = 0;
+       for (sequence::size_type index = 0; index < count; ++index) {
+           // Slide the window: take in the new item, let the oldest go.
+           compensated_add(sum, correction, items[index]);
+           if(index >= window) {
+               compensated_add(sum, correction, -items[index - window]);
+           }
+           if(index + 1 >= window) {
+               target[index + 1 - window] = (sum + correction) / window;
+           }
+       }
+       dest.end_bulk_write(result_count);
+   }
+
+   void rolling_min(const sequence& source, sequence::size_type window,
+                    sequence& dest)
+   {
+       // Protect pre-condition.
+       assert(window > 0);
+       source.pack();
+
+       if(&source == &dest) {
+           sequence temp(source.used);
+           rolling_min(source, window, temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       sequence::size_type result_count =
+               (source.used >= window) ? source.used - window + 1 : 0;
+       sequence::value_type* target = dest.begin_bulk_write(result_count);
+       window_extreme(source.data, source.used, window, target, false);
+       dest.end_bulk_write(result_count);
+   }
+
+   void rolling_max(const sequence& source, sequence::size_type window,
+                    sequence& dest)
+   {
+       // Protect pre-condition.
+       assert(window > 0);
+       source.pack();
+
+       if(&source == &dest) {
+           sequence temp(source.used);
+           rolling_max(source, window, temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       sequence::size_type result_count =
+               (source.used >= window) ? source.used - window + 1 : 0;
+       sequence::value_type* target = dest.begin_bulk_write(result_count);
+       window_extreme(source.data, source.used, window, target, true);
+       dest.end_bulk_write(result_count);
+   }
+
+   void rolling_stddev(const sequence& source, sequence::size_type window,
+                       sequence& dest)
+   {
+       // Protect pre-condition.
+       assert(window > 1);
+       source.pack();
+
+       if(&source == &dest) {
+           sequence temp(source.used);
+           rolling_stddev(source, window, temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       const sequence::value_type* items = source.data;
+       sequence::size_type count = source.used;
+       sequence::size_type result_count =
+               (count >= window) ? count - window + 1 : 0;
+
+       sequence::value_type* target = dest.begin_bulk_write(result_count);
+       sequence::value_type mean = 0;
+       sequence::value_type squares = 0;   // sum of squared deviations
+       for (sequence::size_type index = 0; index < count; ++index) {
+           sequence::value_type entry = items[index];
+           if(index < window) {
+               // Fill the first window with Welford's running update,
+               // which avoids subtracting two large sums of squares.
+               sequence::value_type delta = entry - mean;
+               mean += delta / (index + 1);
+               squares += delta * (entry - mean);
+           } else {
+               // Slide the window: replace the oldest item by entry in
+               // both the mean and the sum of squared deviations.
+               sequence::value_type oldest = items[index - window];
+               sequence::value_type old_mean = mean;
+               mean += (entry - oldest) / window;
+               squares += (entry - oldest) * (entry - mean + oldest - old_mean);
+               // Rounding can push a (near) zero sum slightly negative.
+               if(squares < 0){squares = 0;}
+           }
+           if(index + 1 >= window) {
+               target[index + 1 - window] = sqrt(squares / (window - 1));
+           }
+       }
+       dest.end_bulk_write(result_count);
+   }
+}
@@ -0,0 +1,109 @@
+// FILE: SequenceNumeric.h
+// FUNCTIONS PROVIDED: numeric kernels for the sequence class
+//   (part of the namespace CS3358_FA2017)
+//
+// These functions work directly on the items of one or two sequences,
+// without moving any cursor, which is far cheaper than stepping through
+// the items with start(), advance() and current().
+//
+// VECTOR KERNELS (after the BLAS level 1 routines of the same names):
+//   sequence::value_type dot(const sequence& x, const sequence& y)
+//    Pre:  x.size() == y.size(). If not, the program is terminated by
+//      assert (or, if asserts are turned off with NDEBUG, only as many
+//      items as the shorter sequence has are used, as for the operators
+//      of SequenceExpr.h).
+//    Post: The return value is the sum of x[i] * y[i] over all items.
+//
+//   void axpy(sequence::value_type a, const sequence& x, sequence& y)
+//    Pre:  x.size() == y.size(), as for dot.
+//    Post: Every item y[i] has been replaced by a * x[i] + y[i]. The
+//      size and current item of y are unchanged. x and y may be the same
+//      sequence.
+//
+//   void scal(sequence::value_type a, sequence& x)
+//    Pre:  none
+//    Post: Every item x[i] has been replaced by a * x[i]. The size and
+//      current item of x are unchanged.
+//
+//   sequence::value_type nrm2(const sequence& x)
+//    Pre:  none
+//    Post: The return value is the Euclidean length of x, the square root
+//      of the sum of x[i] * x[i]. It doesn't overflow or underflow unless
+//      the length itself does.
+//
+//   sequence::value_type asum(const sequence& x)
+//    Pre:  none
+//    Post: The return value is the sum of the absolute values of the
+//      items of x.
+//
+// SCANS (prefix sums):
+//   void inclusive_scan(const sequence& source, sequence& dest)
+//    Pre:  none
+//    Post: dest has the same size as source, and dest[i] is the sum of
+//      source[0] through source[i]. dest's first item (if any) is the
+//      current item. dest may be source.
+//
+//   void exclusive_scan(const sequence& source, sequence& dest,
+//                       sequence::value_type initial = 0)
+//    Pre:  none
+//    Post: dest has the same size as source, dest[0] is initial, and
+//      dest[i] is initial plus the sum of source[0] through source[i-1].
+//      dest's first item (if any) is the current item. dest may be
+//      source.
+//    Note: In both scans dest's array is only replaced if it's too small
+//      to hold the result, so a dest that was resize()d beforehand is
+//      written without allocating, in one pass over source.
+//
+// ROLLING-WINDOW AGGREGATES:
+//   void rolling_mean(const sequence& source, sequence::size_type window,
+//                     sequence& dest)
+//   void rolling_min(const sequence& source, sequence::size_type window,
+//                    sequence& dest)
+//   void rolling_max(const sequence& source, sequence::size_type window,
+//                    sequence& dest)
+//   void rolling_stddev(const sequence& source, sequence::size_type window,
+//                       sequence& dest)
+//    Pre:  window > 0 (window > 1 for rolling_stddev).
+//    Post: dest holds one item for every run of window consecutive items
+//      of source, in order: dest[i] is the mean, minimum, maximum or
+//      sample standard deviation of source[i] through source[i+window-1].
+//      So dest has source.size() - window + 1 items, or none at all if
+//      source has fewer than window items. dest's first item (if any) is
+//      the current item. dest may be source.
+//    Note: Each function takes O(source.size()) time whatever the window
+//      size. The mean keeps a compensated running sum, and the standard
+//      deviation a running mean and sum of squared deviations, that are
+//      updated as the window slides. The minimum and maximum keep a
+//      queue of the window's candidate items, which uses O(window) extra
+//      memory.
+//
+// NOTE: x[i] above means item i of x, counting the first item as item 0.
+
+#ifndef SEQUENCE_NUMERIC_H
+#define SEQUENCE_NUMERIC_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   // VECTOR KERNELS
+   sequence::value_type dot(const sequence& x, const sequence& y);
+   void axpy(sequence::value_type a, const sequence& x, sequence& y);
+   void scal(sequence::value_type a, sequence& x);
+   sequence::value_type nrm2(const sequence& x);
+   sequence::value_type asum(const sequence& x);
+   // SCANS
+   void inclusive_scan(const sequence& source, sequence& dest);
+   void exclusive_scan(const sequence& source, sequence& dest,
+                       sequence::value_type initial = 0);
+   // ROLLING-WINDOW AGGREGATES
+   void rolling_mean(const sequence& source, sequence::size_type window,
+                     sequence& dest);
+   void rolling_min(const sequence& source, sequence::size_type window,
+                    sequence& dest);
+   void rolling_max(const sequence& source, sequence::size_type window,
+                    sequence& dest);
+   void rolling_stddev(const sequence& source, sequence::size_type window,
+                       sequence& dest);
+}
+
+#endif
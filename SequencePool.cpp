@@ -0,0 +1,159 @@
+// FILE: SequencePool.cpp
+// CLASS IMPLEMENTED: sequence_pool (see SequencePool.h for documentation)
+// INVARIANT for the sequence_pool class:
+//   1. slabs[0] through slabs[slab_count-1] are every dynamic array the
+//      pool has taken from the heap; slabs has room for slab_capacity of
+//      them. reserved is their total size in bytes.
+//   2. lists[c] is a stack of the free arrays of class c (each of
+//      SMALLEST_CLASS << c items, cut from one of the slabs): arrays[0]
+//      through arrays[count-1], with room for capacity of them.
+//   3. in_use is the total size in bytes of the arrays handed out by
+//      acquire and not yet released. Every byte of a slab is either in
+//      use or in a free array.
+
+#include <cassert>
+#include "SequencePool.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   // CONSTRUCTOR and DESTRUCTOR
+   sequence_pool::sequence_pool() : slabs(NULL), slab_count(0),
+           slab_capacity(0), reserved(0), in_use(0)
+   {
+       for (size_type size_class = 0; size_class < CLASS_COUNT;
+            ++size_class) {
+           lists[size_class].arrays = NULL;
+           lists[size_class].count = 0;
+           lists[size_class].capacity = 0;
+       }
+   }
+
+   sequence_pool::~sequence_pool()
+   {
+       for (size_type slab = 0; slab < slab_count; ++slab) {
+           delete [] slabs[slab];
+       }
+       delete [] slabs;
+       slabs = NULL;
+       for (size_type size_class = 0; size_class < CLASS_COUNT;
+            ++size_class) {
+           delete [] lists[size_class].arrays;
+           lists[size_class].arrays = NULL;
+       }
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   sequence_pool::value_type* sequence_pool::acquire(size_type& count)
+   {
+       // Protect pre-condition.
+       assert(count > 0);
+       assert(count <= SMALLEST_CLASS << (CLASS_COUNT - 1));
+
+       size_type size_class = class_of(count);
+       free_list& list = lists[size_class];
+       if(list.count == 0){carve(size_class);}
+
+       count = SMALLEST_CLASS << size_class;
+       in_use += count * sizeof(value_type);
+       --list.count;
+       return list.arrays[list.count];
+   }
+
+   void sequence_pool::release(value_type* items, size_type count)
+   {
+       size_type size_class = class_of(count);
+
+       // Protect pre-condition.
+       assert(count == SMALLEST_CLASS << size_class);
+
+       in_use -= count * sizeof(value_type);
+       push(lists[size_class], items);
+   }
+
+   // CONSTANT MEMBER FUNCTIONS
+   sequence_pool::size_type sequence_pool::bytes_reserved() const
+   {
+       return reserved;
+   }
+
+   sequence_pool::size_type sequence_pool::bytes_in_use() const
+   {
+       return in_use;
+   }
+
+   sequence_pool::size_type sequence_pool::free_arrays() const
+   {
+       size_type total = 0;
+       for (size_type size_class = 0; size_class < CLASS_COUNT;
+            ++size_class) {
+           total += lists[size_class].count;
+       }
+       return total;
+   }
+
+   double sequence_pool::fragmentation() const
+   {
+       if(reserved == 0){return 0;}
+       return double(reserved - in_use) / double(reserved);
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   sequence_pool::size_type sequence_pool::class_of(size_type count) const
+   {
+       // The smallest class whose arrays hold count items.
+       size_type size_class = 0;
+       while ((SMALLEST_CLASS << size_class) < count) {
+           ++size_class;
+       }
+       return size_class;
+   }
+
+   void sequence_pool::push(free_list& list, value_type* items)
+   {
+       // Grow the stack the way sequence::insert grows a sequence.
+       if(list.count == list.capacity) {
+           size_type new_capacity = size_type(1.25 * list.capacity) + 1;
+           value_type** temp_arrays = new value_type*[new_capacity];
+           for (size_type index = 0; index < list.count; ++index) {
+               temp_arrays[index] = list.arrays[index];
+           }
+           delete [] list.arrays;
+           list.arrays = temp_arrays;
+           list.capacity = new_capacity;
+       }
+       list.arrays[list.count] = items;
+       ++list.count;
+   }
+
+   void sequence_pool::carve(size_type size_class)
+   {
+       // Take a new slab from the heap and cut it into arrays of
+       // size_class, all of which go on its free list. An array larger
+       // than a slab gets a slab of its own.
+       size_type array_items = SMALLEST_CLASS << size_class;
+       size_type array_total = (array_items < SLAB_ITEMS) ?
+               SLAB_ITEMS / array_items : 1;
+
+       if(slab_count == slab_capacity) {
+           size_type new_capacity = size_type(1.25 * slab_capacity) + 1;
+           value_type** temp_slabs = new value_type*[new_capacity];
+           for (size_type slab = 0; slab < slab_count; ++slab) {
+               temp_slabs[slab] = slabs[slab];
+           }
+           delete [] slabs;
+           slabs = temp_slabs;
+           slab_capacity = new_capacity;
+       }
+       value_type* slab = new value_type[array_total * array_items];
+       slabs[slab_count] = slab;
+       ++slab_count;
+       reserved += array_total * array_items * sizeof(value_type);
+
+       // Push them in reverse so the first array is handed out first.
+       for (size_type index = array_total; index > 0; --index) {
+           push(lists[size_class], slab + (index - 1) * array_items);
+       }
+   }
+}
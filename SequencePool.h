@@ -0,0 +1,117 @@
+// FILE: SequencePool.h
+// CLASS PROVIDED: sequence_pool (part of the namespace CS3358_FA2017)
+//
+// A sequence_pool supplies the dynamic arrays of sequences made with the
+// sequence(sequence_pool&, size_type) constructor (see Sequence.h). It
+// gets memory from the heap in large slabs and cuts each slab into
+// arrays of one size class: class c holds arrays of SMALLEST_CLASS * 2^c
+// items. An array a sequence no longer needs (because it grew, or was
+// destroyed) goes on a free list for its class and is handed out again
+// to the next sequence asking for that class, so a program that keeps
+// creating, growing and destroying small sequences stops calling new and
+// delete almost entirely, and the heap isn't fragmented by them. The
+// slabs are only given back when the pool itself is destroyed.
+//
+// A sequence asking for n items gets an array of the smallest class that
+// holds n, so its capacity is rounded up to that size.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the sequence_pool class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+//   static const size_type SMALLEST_CLASS = _____
+//   static const size_type CLASS_COUNT = _____
+//   static const size_type SLAB_ITEMS = _____
+//    The size of the smallest class, in items; the number of classes;
+//    and the size of a slab, in items. Arrays larger than a slab get a
+//    slab of their own.
+//
+// CONSTRUCTOR for the sequence_pool class:
+//   sequence_pool()
+//    Post: The pool is empty, and has taken no memory from the heap.
+//
+// MODIFICATION MEMBER FUNCTIONS for the sequence_pool class:
+//   value_type* acquire(size_type& count)
+//    Pre:  0 < count <= SMALLEST_CLASS * 2^(CLASS_COUNT-1)
+//    Post: The return value is an array of at least count items, and
+//      count has been rounded up to its size.
+//
+//   void release(value_type* items, size_type count)
+//    Pre:  items was returned by acquire on this pool, which set count to
+//      this value, and hasn't been released since.
+//    Post: items is on the free list of its class, ready to be reused.
+//
+// CONSTANT MEMBER FUNCTIONS for the sequence_pool class:
+//   size_type bytes_reserved() const
+//    Post: The return value is the number of bytes the pool has taken
+//      from the heap.
+//
+//   size_type bytes_in_use() const
+//    Post: The return value is the number of bytes of the arrays that
+//      have been acquired and not released.
+//
+//   size_type free_arrays() const
+//    Post: The return value is the number of arrays on the free lists.
+//
+//   double fragmentation() const
+//    Post: The return value is the fraction of the reserved bytes that
+//      aren't in use (0 if nothing has been reserved): memory held on
+//      free lists, or not yet handed out from a slab, that only arrays
+//      of its own class can use.
+//
+// VALUE SEMANTICS for the sequence_pool class:
+//   sequence_pool objects may not be copied or assigned. A pool must
+//   outlive every sequence that uses it.
+
+#ifndef SEQUENCE_POOL_H
+#define SEQUENCE_POOL_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class sequence_pool
+   {
+   public:
+      // TYPEDEFS and MEMBER CONSTANTS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      static const size_type SMALLEST_CLASS = 8;
+      static const size_type CLASS_COUNT = 28;
+      static const size_type SLAB_ITEMS = 8192;
+      // CONSTRUCTOR and DESTRUCTOR
+      sequence_pool();
+      ~sequence_pool();
+      // MODIFICATION MEMBER FUNCTIONS
+      value_type* acquire(size_type& count);
+      void release(value_type* items, size_type count);
+      // CONSTANT MEMBER FUNCTIONS
+      size_type bytes_reserved() const;
+      size_type bytes_in_use() const;
+      size_type free_arrays() const;
+      double fragmentation() const;
+   private:
+      // A stack of free arrays of one size class.
+      struct free_list
+      {
+         value_type** arrays;
+         size_type count;
+         size_type capacity;
+      };
+      free_list lists[CLASS_COUNT];
+      value_type** slabs;     // every slab taken from the heap
+      size_type slab_count;
+      size_type slab_capacity;
+      size_type reserved;     // bytes in all the slabs
+      size_type in_use;       // bytes acquired and not released
+      // HELPER MEMBER FUNCTIONS
+      size_type class_of(size_type count) const;
+      void push(free_list& list, value_type* items);
+      void carve(size_type size_class);
+      // Not copyable: see VALUE SEMANTICS above.
+      sequence_pool(const sequence_pool& source);
+      sequence_pool& operator=(const sequence_pool& source);
+   };
+}
+
+#endif
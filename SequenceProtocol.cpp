@@ -0,0 +1,167 @@
+// FILE: SequenceProtocol.cpp
+// FUNCTIONS IMPLEMENTED: a binary command protocol for a sequence
+//   (see SequenceProtocol.h for documentation)
+//
+// Replies are added to the end of a string that the caller sends all at
+// once, so a server answers any number of pipelined commands with one
+// write, instead of one for each command.
+
+#include <cstring>     // provides memcpy
+#include "SequenceProtocol.h"
+#include "SequenceNumeric.h"
+#include "SequenceView.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      // The number of bytes that follow op's letter in a command.
+      sequence::size_type argument_bytes(char op)
+      {
+          if(op == 'I' || op == 'A' || op == 'X') {
+              return sizeof(sequence::value_type);
+          }
+          return (op == 'J') ? sizeof(unsigned long) : 0;
+      }
+
+      template <class Item>
+      void put_bytes(string& out, const Item& item)
+      {
+          out.append(reinterpret_cast<const char*>(&item), sizeof(Item));
+      }
+
+      template <class Item>
+      void get_bytes(const char* in, Item& item)
+      {
+          memcpy(&item, in, sizeof(Item));
+      }
+   }
+
+   sequence::size_type run_commands(sequence& target, const char* input,
+                                    sequence::size_type length,
+                                    string& replies,
+                                    sequence::size_type reply_limit)
+   {
+       sequence::size_type next = 0;
+       while (next < length && length - next > argument_bytes(input[next]) &&
+              replies.size() < reply_limit) {
+           char op = input[next];
+           sequence::value_type entry = 0;
+           unsigned long position = 0;
+           if(op == 'J'){get_bytes(input + next + 1, position);}
+           else if(argument_bytes(op) > 0) {
+               get_bytes(input + next + 1, entry);
+           }
+           next += 1 + argument_bytes(op);
+
+           // Run the command, then reply with whether it could be run,
+           // and what it returns.
+           bool ok = true;
+           switch (op) {
+           case '!':
+               target.start();
+               break;
+           case '+':
+               ok = target.is_item();
+               if(ok){target.advance();}
+               break;
+           case 'I':
+               target.insert(entry);
+               break;
+           case 'A':
+               target.attach(entry);
+               break;
+           case 'R':
+               ok = target.is_item();
+               if(ok){target.remove_current();}
+               break;
+           case 'J':
+               target.start();
+               for (unsigned long index = 0;
+                    index < position && target.is_item(); ++index) {
+                   target.advance();
+               }
+               ok = target.is_item();
+               break;
+           case 'X':
+               exclusive_scan(target, target, entry);
+               break;
+           case '?':
+           case 'C':
+               ok = target.is_item();
+               break;
+           case 'T':
+           case 'S':
+           case 'P':
+               break;
+           default:
+               ok = false;
+               break;
+           }
+           replies += ok ? COMMAND_OK : COMMAND_FAILED;
+           if(ok && op == 'C'){put_bytes(replies, target.current());}
+           if(ok && op == 'T') {
+               put_bytes(replies, sequence_view(target).sum());
+           }
+           if(ok && op == 'S') {
+               put_bytes(replies, static_cast<unsigned long>(target.size()));
+           }
+           if(ok && op == 'P') {
+               // A view reads the items without moving the cursor.
+               sequence_view items(target);
+               put_bytes(replies, static_cast<unsigned long>(items.size()));
+               for (items.start(); items.is_item(); items.advance()) {
+                   put_bytes(replies, items.current());
+               }
+           }
+       }
+       return next;
+   }
+
+   void put_command(string& commands, char op, sequence::value_type entry)
+   {
+       commands += op;
+       if(op == 'J') {
+           put_bytes(commands, static_cast<unsigned long>(entry));
+       }
+       else if(argument_bytes(op) > 0){put_bytes(commands, entry);}
+   }
+
+   sequence::size_type get_reply(char op, const char* input,
+                                 sequence::size_type length,
+                                 command_reply& reply)
+   {
+       if(length == 0){return 0;}
+       bool ok = (input[0] == COMMAND_OK);
+       sequence::size_type need = 1;
+       unsigned long count = 0;
+       if(ok && (op == 'C' || op == 'T')) {
+           need += sizeof(sequence::value_type);
+       }
+       if(ok && (op == 'S' || op == 'P')) {
+           need += sizeof(unsigned long);
+           if(length < need){return 0;}
+           get_bytes(input + 1, count);
+           if(op == 'P'){need += count * sizeof(sequence::value_type);}
+       }
+       if(length < need){return 0;}
+
+       // The whole reply is here, so it can be read.
+       reply.ok = ok;
+       if(ok && (op == 'C' || op == 'T')){get_bytes(input + 1, reply.value);}
+       if(ok && (op == 'S' || op == 'P')){reply.count = count;}
+       if(ok && op == 'P') {
+           reply.items = sequence();
+           const char* item = input + 1 + sizeof(unsigned long);
+           for (unsigned long index = 0; index < count; ++index) {
+               sequence::value_type entry;
+               get_bytes(item, entry);
+               reply.items.attach(entry);
+               item += sizeof(sequence::value_type);
+           }
+       }
+       return need;
+   }
+}
@@ -0,0 +1,115 @@
+// FILE: SequenceProtocol.h
+// FUNCTIONS PROVIDED: a binary command protocol for a sequence (part of
+//   the namespace CS3358_FA2017)
+//
+// These functions let a program drive a sequence it can't call directly,
+// such as one held by a server (see SequenceServer.cpp), using the
+// commands of the Assign03 menu:
+//   '!' start           '+' advance          '?' is_item
+//   'C' current         'S' size             'P' all of the items
+//   'I' insert          'A' attach           'R' remove_current
+// and three more, for programs that hold parts of a larger sequence
+// (see SequenceShard.h):
+//   'J' the item at a position becomes the current item (or, if there
+//       is no such item, there is no current item); O(position) time
+//   'T' the total (sum) of the items
+//   'X' exclusive_scan (see SequenceNumeric.h) of the sequence into
+//       itself, starting from a given initial value
+// A command is its letter, followed for 'I', 'A' and 'X' by the bytes of
+// the entry or initial value, and for 'J' by the position as the bytes
+// of an unsigned long. Every command gets a reply, in the order the
+// commands were sent: COMMAND_OK or COMMAND_FAILED, followed when it's
+// COMMAND_OK by
+//   'C'  the bytes of the current item;
+//   'T'  the bytes of the total;
+//   'S'  the size, as the bytes of an unsigned long;
+//   'P'  the number of items, as for 'S', then the bytes of each item.
+// A command is COMMAND_FAILED if its precondition doesn't hold ('+',
+// 'C' or 'R' with no current item), or if its letter isn't one of the
+// above; '?' and 'J' are COMMAND_OK only if there is a current item
+// afterwards.
+//
+// Many commands may be sent at once ("pipelined") without waiting for
+// the replies to the earlier ones, and run_commands runs as many of them
+// as it is given in one call (or as many as fit under a limit on the
+// replies, so a client that sends but never reads can't make a server
+// hold any amount of them). Numbers are sent in this machine's own
+// format, so both ends must be built the same way (as they are on one
+// machine).
+//
+// CONSTANTS:
+//   const char COMMAND_OK = 'Y'
+//   const char COMMAND_FAILED = 'N'
+//    The first byte of every reply.
+//
+// STRUCT PROVIDED: command_reply
+//   bool ok
+//    True if the reply was COMMAND_OK.
+//   sequence::value_type value
+//    The current item, for 'C', or the total, for 'T'.
+//   sequence::size_type count
+//    The number of items, for 'S' and 'P'.
+//   sequence items
+//    The items, for 'P'.
+//
+// FUNCTIONS:
+//   sequence::size_type run_commands(sequence& target, const char* input,
+//                                    sequence::size_type length,
+//                                    std::string& replies,
+//                                    sequence::size_type reply_limit = -1)
+//    Pre:  input[0] through input[length-1] are bytes of commands.
+//    Post: The whole commands at the front of input have been run on
+//      target, in order, and their replies added to the end of replies,
+//      stopping before any command once replies holds reply_limit bytes
+//      or more (by default, there is no limit). The return value is the
+//      number of bytes of input they took; the rest (commands left for
+//      later, and part of a command not yet all received) has not been
+//      run.
+//
+//   void put_command(std::string& commands, char op,
+//                    sequence::value_type entry = 0)
+//    Pre:  none
+//    Post: The command op (with entry, if op is 'I', 'A' or 'X', or with
+//      entry as the position, if op is 'J') has been added to the end
+//      of commands.
+//
+//   sequence::size_type get_reply(char op, const char* input,
+//                                 sequence::size_type length,
+//                                 command_reply& reply)
+//    Pre:  input[0] through input[length-1] are the bytes of replies, the
+//      first of which is the reply to a command op.
+//    Post: If input holds the whole of that reply, it has been read into
+//      reply, and the return value is the number of bytes it took.
+//      Otherwise the return value is 0 and reply is unchanged.
+
+#ifndef SEQUENCE_PROTOCOL_H
+#define SEQUENCE_PROTOCOL_H
+#include <string>
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   const char COMMAND_OK = 'Y';
+   const char COMMAND_FAILED = 'N';
+
+   struct command_reply
+   {
+      bool ok;
+      sequence::value_type value;
+      sequence::size_type count;
+      sequence items;
+   };
+
+   sequence::size_type run_commands(sequence& target, const char* input,
+                                    sequence::size_type length,
+                                    std::string& replies,
+                                    sequence::size_type reply_limit =
+                                            sequence::size_type(-1));
+   void put_command(std::string& commands, char op,
+                    sequence::value_type entry = 0);
+   sequence::size_type get_reply(char op, const char* input,
+                                 sequence::size_type length,
+                                 command_reply& reply);
+}
+
+#endif
@@ -0,0 +1,405 @@
+// FILE: SequenceQuantized.cpp
+// CLASS IMPLEMENTED: quantized_sequence (see SequenceQuantized.h for
+//   documentation)
+// INVARIANT for the quantized_sequence class:
+//   1. The number of items is in the member variable used, and the
+//      storage mode in storage.
+//   2. In the FLOAT16, BFLOAT16 and INT16 modes the items are stored in
+//      wide[0] through wide[used-1] and narrow is NULL; in the INT8 mode
+//      they're in narrow[0] through narrow[used-1] and wide is NULL. An
+//      INT16 item is the bits of a short.
+//   3. In the INT16 and INT8 modes, item i stands for its integer times
+//      scales[i / BLOCK_SIZE]. In the other modes scales is NULL.
+//   4. error is the largest difference between an original item and the
+//      value stored for it.
+//   5. current_index is the index of the current item, or used if there
+//      is no current item.
+//
+// Converting a FLOAT16 or BFLOAT16 item back to a value_type assembles
+// the bits of the equivalent float, which is exact and much faster than
+// computing it with ldexp. This assumes IEEE floats of the same size as
+// an unsigned int, which holds on every platform this project builds on.
+
+#include <cassert>
+#include <cmath>       // provides fabs, floor, fmod, frexp and ldexp
+#include <cstring>     // provides memcpy
+#include "SequenceQuantized.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      // Round value to the nearest integer, ties to even, as the IEEE
+      // conversions do.
+      double round_even(double value)
+      {
+          double whole = floor(value);
+          double part = value - whole;
+          if(part > 0.5 || (part == 0.5 && fmod(whole, 2.0) != 0)) {
+              whole += 1;
+          }
+          return whole;
+      }
+
+      // Encode value as a 16-bit float with a sign bit, exponent_bits bits
+      // of exponent and mantissa_bits bits of mantissa (FLOAT16 is 5 and
+      // 10, BFLOAT16 8 and 7), rounding to nearest even. Values too large
+      // become infinity.
+      unsigned short encode_float(double value, int exponent_bits,
+                                  int mantissa_bits)
+      {
+          const unsigned long SIGN = 1UL << (exponent_bits + mantissa_bits);
+          const unsigned long EXPONENTS = (1UL << exponent_bits) - 1;
+          const unsigned long INFINITE = EXPONENTS << mantissa_bits;
+          const unsigned long HIDDEN = 1UL << mantissa_bits;
+          const int BIAS = int(EXPONENTS / 2);
+
+          if(value != value){return (unsigned short)(INFINITE | HIDDEN / 2);}
+          unsigned long bits = (value < 0) ? SIGN : 0;
+          double magnitude = fabs(value);
+          if(magnitude == 0){return (unsigned short)(bits);}
+
+          int exponent;
+          frexp(magnitude, &exponent);
+          --exponent;    // now magnitude = 1.f * 2^exponent
+
+          if(exponent < 1 - BIAS) {
+              // Subnormal. If it rounds up to HIDDEN, that's the bits of
+              // the smallest normal number, as it should be.
+              double steps = ldexp(magnitude, mantissa_bits + BIAS - 1);
+              bits |= (unsigned long)(round_even(steps));
+              return (unsigned short)(bits);
+          }
+
+          unsigned long mantissa = (unsigned long)(
+                  round_even(ldexp(magnitude, mantissa_bits - exponent)));
+          if(mantissa == 2 * HIDDEN) {
+              mantissa = HIDDEN;
+              ++exponent;
+          }
+          if(exponent > BIAS){return (unsigned short)(bits | INFINITE);}
+          bits |= (unsigned long)(exponent + BIAS) << mantissa_bits;
+          bits |= mantissa - HIDDEN;
+          return (unsigned short)(bits);
+      }
+
+      double float_from_bits(unsigned int bits)
+      {
+          float result;
+          memcpy(&result, &bits, sizeof(result));
+          return result;
+      }
+
+      double decode_float16(unsigned short item)
+      {
+          unsigned int sign = (item & 0x8000U) << 16;
+          unsigned int exponent = (item >> 10) & 0x1fU;
+          unsigned int mantissa = item & 0x3ffU;
+          if(exponent == 0) {
+              double magnitude = ldexp(double(mantissa), -24);
+              return sign ? -magnitude : magnitude;
+          }
+          // Rebias the exponent from 15 to 127 (31, for infinity and NaN,
+          // becomes 255) and widen the mantissa from 10 bits to 23.
+          exponent = (exponent == 31) ? 255 : exponent + 112;
+          return float_from_bits(sign | exponent << 23 | mantissa << 13);
+      }
+
+      double decode_bfloat16(unsigned short item)
+      {
+          return float_from_bits((unsigned int)(item) << 16);
+      }
+   }
+
+   // CONSTRUCTORS and DESTRUCTOR
+   quantized_sequence::quantized_sequence(const sequence& source,
+                                          storage_mode mode) :
+           storage(mode), wide(NULL), narrow(NULL), scales(NULL),
+           used(0), current_index(0), error(0)
+   {
+       // Squeeze out any dead slots (see enable_lazy_remove in
+       // Sequence.h) before reading the items in place.
+       source.pack();
+       used = source.used;
+       current_index = used;
+       const value_type* items = source.data;
+
+       if(storage == INT16 || storage == INT8) {
+           const double LIMIT = (storage == INT16) ? 32767 : 127;
+           if(storage == INT16){wide = new unsigned short[used];}
+           else {narrow = new signed char[used];}
+           scales = new value_type[block_count()];
+
+           for (size_type block = 0; block < block_count(); ++block) {
+               size_type first = block * BLOCK_SIZE;
+               size_type last = (used - first > BLOCK_SIZE) ?
+                       first + BLOCK_SIZE : used;
+
+               // Protect pre-condition, and find the scale that makes the
+               // largest magnitude LIMIT steps.
+               value_type largest = 0;
+               for (size_type index = first; index < last; ++index) {
+                   assert(items[index] - items[index] == 0);   // finite
+                   if(fabs(items[index]) > largest) {
+                       largest = fabs(items[index]);
+                   }
+               }
+               value_type scale = largest / LIMIT;
+               if(!(scale > 0)){scale = (largest > 0) ? largest : 1;}
+               scales[block] = scale;
+
+               for (size_type index = first; index < last; ++index) {
+                   double steps = round_even(items[index] / scale);
+                   if(steps > LIMIT){steps = LIMIT;}
+                   if(steps < -LIMIT){steps = -LIMIT;}
+                   if(storage == INT16) {
+                       wide[index] = (unsigned short)(short(steps));
+                   } else {
+                       narrow[index] = (signed char)(steps);
+                   }
+               }
+           }
+       } else {
+           wide = new unsigned short[used];
+           for (size_type index = 0; index < used; ++index) {
+               wide[index] = (storage == FLOAT16) ?
+                       encode_float(items[index], 5, 10) :
+                       encode_float(items[index], 8, 7);
+           }
+       }
+
+       // Measure the error. Comparisons with NaN are false, so NaN items
+       // (and infinite items, which are stored exactly) don't count.
+       for (size_type index = 0; index < used; ++index) {
+           value_type difference = fabs(items[index] - item(index));
+           if(difference > error){error = difference;}
+       }
+   }
+
+   quantized_sequence::quantized_sequence(
+           const quantized_sequence& source)
+   {
+       copy_from(source);
+   }
+
+   quantized_sequence::~quantized_sequence()
+   {
+       delete [] wide;
+       wide = NULL;
+       delete [] narrow;
+       narrow = NULL;
+       delete [] scales;
+       scales = NULL;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void quantized_sequence::start()
+   {
+       current_index = 0;
+   }
+
+   void quantized_sequence::advance()
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       ++current_index;
+   }
+
+   quantized_sequence& quantized_sequence::operator=(
+           const quantized_sequence& source)
+   {
+       // Self-assignment fail safe.
+       if (this == &source)
+           return *this;
+
+       delete [] wide;
+       delete [] narrow;
+       delete [] scales;
+       copy_from(source);
+
+       return *this;
+   }
+
+   // CONSTANT MEMBER FUNCTIONS
+   quantized_sequence::size_type quantized_sequence::size() const
+   {
+       return used;
+   }
+
+   bool quantized_sequence::is_item() const
+   {
+       return (current_index != used);
+   }
+
+   quantized_sequence::value_type quantized_sequence::current() const
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       return item(current_index);
+   }
+
+   quantized_sequence::storage_mode quantized_sequence::mode() const
+   {
+       return storage;
+   }
+
+   quantized_sequence::size_type quantized_sequence::bytes() const
+   {
+       if(storage == INT8) {
+           return used + block_count() * sizeof(value_type);
+       }
+       if(storage == INT16) {
+           return used * sizeof(unsigned short) +
+                  block_count() * sizeof(value_type);
+       }
+       return used * sizeof(unsigned short);
+   }
+
+   quantized_sequence::value_type quantized_sequence::max_error() const
+   {
+       return error;
+   }
+
+   quantized_sequence::value_type quantized_sequence::sum() const
+   {
+       value_type sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+       if(storage == INT16 || storage == INT8) {
+           // A block's integers can't overflow a long (256 * 32767 is far
+           // below 2^31), so add them exactly and scale once per block.
+           for (size_type block = 0; block < block_count(); ++block) {
+               size_type first = block * BLOCK_SIZE;
+               size_type last = (used - first > BLOCK_SIZE) ?
+                       first + BLOCK_SIZE : used;
+               long total = 0;
+               for (size_type index = first; index < last; ++index) {
+                   total += (storage == INT16) ? short(wide[index])
+                                               : narrow[index];
+               }
+               sum0 += total * scales[block];
+           }
+           return sum0;
+       }
+
+       // Decode a block at a time into a small buffer that stays in the
+       // cache, then add it up with four partial sums (as the kernels in
+       // SequenceNumeric.cpp do).
+       value_type buffer[BLOCK_SIZE];
+       for (size_type block = 0; block < block_count(); ++block) {
+           decode_block(block, buffer);
+           size_type count = (used - block * BLOCK_SIZE > BLOCK_SIZE) ?
+                   BLOCK_SIZE : used - block * BLOCK_SIZE;
+           size_type index = 0;
+           for ( ; index + 4 <= count; index += 4) {
+               sum0 += buffer[index];
+               sum1 += buffer[index+1];
+               sum2 += buffer[index+2];
+               sum3 += buffer[index+3];
+           }
+           for ( ; index < count; ++index) {
+               sum0 += buffer[index];
+           }
+       }
+       return (sum0 + sum1) + (sum2 + sum3);
+   }
+
+   void quantized_sequence::decode(sequence& dest) const
+   {
+       sequence::value_type* target = dest.begin_bulk_write(used);
+       for (size_type block = 0; block < block_count(); ++block) {
+           decode_block(block, target + block * BLOCK_SIZE);
+       }
+       dest.end_bulk_write(used);
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   quantized_sequence::size_type quantized_sequence::block_count() const
+   {
+       return (used + BLOCK_SIZE - 1) / BLOCK_SIZE;
+   }
+
+   quantized_sequence::value_type quantized_sequence::item(
+           size_type index) const
+   {
+       switch (storage) {
+           case FLOAT16:
+               return decode_float16(wide[index]);
+           case BFLOAT16:
+               return decode_bfloat16(wide[index]);
+           case INT16:
+               return short(wide[index]) * scales[index / BLOCK_SIZE];
+           default:
+               return narrow[index] * scales[index / BLOCK_SIZE];
+       }
+   }
+
+   void quantized_sequence::decode_block(size_type block,
+                                         value_type* target) const
+   {
+       // Decode the items of block into target[0], target[1], .... The
+       // mode is tested once per block rather than once per item, so each
+       // loop below is simple enough for the compiler to vectorize. Only
+       // the array of the sequence's mode is indexed; the other is NULL.
+       size_type first = block * BLOCK_SIZE;
+       size_type count = (used - first > BLOCK_SIZE) ? BLOCK_SIZE
+                                                     : used - first;
+       switch (storage) {
+           case FLOAT16:
+               for (size_type index = 0; index < count; ++index) {
+                   target[index] = decode_float16(wide[first + index]);
+               }
+               break;
+           case BFLOAT16:
+               for (size_type index = 0; index < count; ++index) {
+                   target[index] = decode_bfloat16(wide[first + index]);
+               }
+               break;
+           case INT16:
+               for (size_type index = 0; index < count; ++index) {
+                   target[index] = short(wide[first + index]) * scales[block];
+               }
+               break;
+           default:
+               for (size_type index = 0; index < count; ++index) {
+                   target[index] = narrow[first + index] * scales[block];
+               }
+               break;
+       }
+   }
+
+   void quantized_sequence::copy_from(const quantized_sequence& source)
+   {
+       // Give this object its own copies of source's arrays. Any arrays
+       // it had must already have been freed.
+       storage = source.storage;
+       used = source.used;
+       current_index = source.current_index;
+       error = source.error;
+       wide = NULL;
+       narrow = NULL;
+       scales = NULL;
+
+       if(source.wide != NULL) {
+           wide = new unsigned short[used];
+           for (size_type index = 0; index < used; ++index) {
+               wide[index] = source.wide[index];
+           }
+       }
+       if(source.narrow != NULL) {
+           narrow = new signed char[used];
+           for (size_type index = 0; index < used; ++index) {
+               narrow[index] = source.narrow[index];
+           }
+       }
+       if(source.scales != NULL) {
+           scales = new value_type[block_count()];
+           for (size_type block = 0; block < block_count(); ++block) {
+               scales[block] = source.scales[block];
+           }
+       }
+   }
+}
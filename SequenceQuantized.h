@@ -0,0 +1,126 @@
+// FILE: SequenceQuantized.h
+// CLASS PROVIDED: quantized_sequence (part of the namespace CS3358_FA2017)
+//
+// A quantized_sequence is a read-only copy of a sequence that stores each
+// item in 16 or 8 bits instead of a full double, for data that only needs
+// a few significant digits. Scanning it reads a quarter or an eighth of
+// the memory a sequence would, at the cost of a small error in every
+// item, which the class measures as it stores the items.
+//
+// There are four storage modes:
+//   FLOAT16   IEEE half precision: 11 significant bits (about 3 decimal
+//             digits), for magnitudes from about 6e-8 to 65504. Larger
+//             items are stored as infinity.
+//   BFLOAT16  The top half of an IEEE float: 8 significant bits (about 2
+//             decimal digits), but the full range of a float.
+//   INT16     A 16-bit integer times a scale shared by each block of
+//   INT8      BLOCK_SIZE items (or an 8-bit integer). The scale is chosen
+//             so the largest magnitude in the block is 32767 (or 127)
+//             steps, so the error is at most half a step: 1/65534 (or
+//             1/254) of the largest magnitude in the block.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the quantized_sequence class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+//   enum storage_mode { FLOAT16, BFLOAT16, INT16, INT8 }
+//    The storage modes described above.
+//
+//   static const size_type BLOCK_SIZE = _____
+//    The number of items that share a scale in the INT16 and INT8 modes.
+//
+// CONSTRUCTOR for the quantized_sequence class:
+//   quantized_sequence(const sequence& source, storage_mode mode)
+//    Pre:  If mode is INT16 or INT8, every item of source is finite.
+//    Post: The quantized_sequence holds the items of source, each
+//      rounded to the nearest value mode can store, and there is no
+//      current item. source is not changed.
+//
+// MODIFICATION MEMBER FUNCTIONS for the quantized_sequence class:
+//   void start()
+//   void advance()
+//    Pre:  is_item returns true for advance.
+//    Post: As for the sequence class.
+//
+// CONSTANT MEMBER FUNCTIONS for the quantized_sequence class:
+//   size_type size() const
+//   bool is_item() const
+//   value_type current() const
+//    Pre:  is_item() returns true for current.
+//    Post: As for the sequence class. current converts the stored item
+//      back to a value_type.
+//
+//   storage_mode mode() const
+//    Post: The return value is the storage mode.
+//
+//   size_type bytes() const
+//    Post: The return value is the number of bytes of memory the items
+//      (and scales) take up, to compare with size() * sizeof(value_type).
+//
+//   value_type max_error() const
+//    Post: The return value is the largest difference between an item of
+//      the original sequence and the value stored for it (0 if there are
+//      no items). Infinite if an item overflowed.
+//
+//   value_type sum() const
+//    Post: The return value is the sum of the stored items. In the INT16
+//      and INT8 modes each block is summed as integers and scaled once.
+//
+//   void decode(sequence& dest) const
+//    Pre:  none
+//    Post: dest holds the stored items, converted back to value_type, and
+//      its first item (if any) is the current item.
+//
+// VALUE SEMANTICS for the quantized_sequence class:
+//   Assignments and the copy constructor may be used with
+//   quantized_sequence objects.
+
+#ifndef SEQUENCE_QUANTIZED_H
+#define SEQUENCE_QUANTIZED_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class quantized_sequence
+   {
+   public:
+      // TYPEDEFS and MEMBER CONSTANTS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      enum storage_mode { FLOAT16, BFLOAT16, INT16, INT8 };
+      static const size_type BLOCK_SIZE = 256;
+      // CONSTRUCTORS and DESTRUCTOR
+      quantized_sequence(const sequence& source, storage_mode mode);
+      quantized_sequence(const quantized_sequence& source);
+      ~quantized_sequence();
+      // MODIFICATION MEMBER FUNCTIONS
+      void start();
+      void advance();
+      quantized_sequence& operator=(const quantized_sequence& source);
+      // CONSTANT MEMBER FUNCTIONS
+      size_type size() const;
+      bool is_item() const;
+      value_type current() const;
+      storage_mode mode() const;
+      size_type bytes() const;
+      value_type max_error() const;
+      value_type sum() const;
+      void decode(sequence& dest) const;
+   private:
+      storage_mode storage;
+      unsigned short* wide;   // the items, in FLOAT16, BFLOAT16 and INT16
+      signed char* narrow;    // the items, in INT8
+      value_type* scales;     // one per block, in INT16 and INT8
+      size_type used;
+      size_type current_index;
+      value_type error;
+      // HELPER MEMBER FUNCTIONS
+      size_type block_count() const;
+      value_type item(size_type index) const;
+      void decode_block(size_type block, value_type* target) const;
+      void copy_from(const quantized_sequence& source);
+   };
+}
+
+#endif
@@ -0,0 +1,320 @@
+// FILE: SequenceRle.cpp
+// CLASS IMPLEMENTED: rle_sequence (see SequenceRle.h for documentation)
+// INVARIANT for the rle_sequence class:
+//   1. The items are stored as runs runs, in order: run r is lengths[r]
+//      copies of values[r]. Every run has a length of at least 1, and no
+//      two neighbouring runs have equal values.
+//   2. The arrays values and lengths both have room for capacity runs,
+//      and capacity >= runs.
+//   3. used is the number of items, the sum of all the lengths.
+//   4. If there is a current item it's item current_offset of run
+//      current_run (so current_offset < lengths[current_run]). If there
+//      is none, current_run is runs and current_offset is 0.
+
+#include <cassert>
+#include "SequenceRle.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   // CONSTRUCTORS and DESTRUCTOR
+   rle_sequence::rle_sequence() : runs(0), capacity(DEFAULT_CAPACITY),
+           used(0), current_run(0), current_offset(0)
+   {
+       values = new value_type[capacity];
+       lengths = new size_type[capacity];
+   }
+
+   rle_sequence::rle_sequence(const sequence& source) : runs(0),
+           capacity(DEFAULT_CAPACITY), used(0), current_run(0),
+           current_offset(0)
+   {
+       // Squeeze out any dead slots (see enable_lazy_remove in
+       // Sequence.h), then count the runs first so the arrays are
+       // allocated only once.
+       source.pack();
+       used = source.used;
+       const value_type* items = source.data;
+       size_type run_total = 0;
+       for (size_type index = 0; index < used; ++index) {
+           if(index == 0 || !(items[index] == items[index - 1])) {
+               ++run_total;
+           }
+       }
+       if(run_total > capacity){capacity = run_total;}
+       values = new value_type[capacity];
+       lengths = new size_type[capacity];
+
+       for (size_type index = 0; index < used; ++index) {
+           if(index == 0 || !(items[index] == items[index - 1])) {
+               values[runs] = items[index];
+               lengths[runs] = 0;
+               ++runs;
+           }
+           ++lengths[runs - 1];
+       }
+       current_run = runs;
+   }
+
+   rle_sequence::rle_sequence(const rle_sequence& source) :
+           runs(source.runs), capacity(source.capacity), used(source.used),
+           current_run(source.current_run),
+           current_offset(source.current_offset)
+   {
+       values = new value_type[capacity];
+       lengths = new size_type[capacity];
+       for (size_type run = 0; run < runs; ++run) {
+           values[run] = source.values[run];
+           lengths[run] = source.lengths[run];
+       }
+   }
+
+   rle_sequence::~rle_sequence()
+   {
+       delete [] values;
+       values = NULL;
+       delete [] lengths;
+       lengths = NULL;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void rle_sequence::start()
+   {
+       current_run = 0;
+       current_offset = 0;
+   }
+
+   void rle_sequence::advance()
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       ++current_offset;
+       if(current_offset == lengths[current_run]) {
+           ++current_run;
+           current_offset = 0;
+       }
+   }
+
+   void rle_sequence::insert(const value_type& entry)
+   {
+       // With no current item, entry goes in front of the first item.
+       if(!is_item()){insert_at(0, 0, entry);}
+       else {insert_at(current_run, current_offset, entry);}
+   }
+
+   void rle_sequence::attach(const value_type& entry)
+   {
+       if(!is_item()) {
+
+           // There's NO current item. Attach entry at the end.
+           insert_at(runs, 0, entry);
+
+       } else if(current_offset + 1 == lengths[current_run]) {
+
+           // The current item ends its run: entry goes in front of the
+           // next run (or at the end).
+           insert_at(current_run + 1, 0, entry);
+
+       } else {
+           insert_at(current_run, current_offset + 1, entry);
+       }
+   }
+
+   void rle_sequence::remove_current()
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       --used;
+       --lengths[current_run];
+       if(lengths[current_run] > 0) {
+           // The item after the removed one is now at the same offset,
+           // unless the removed one was the last of its run.
+           if(current_offset == lengths[current_run]) {
+               ++current_run;
+               current_offset = 0;
+           }
+           return;
+       }
+
+       // The run is gone. If that leaves two equal runs side by side,
+       // join them; the next item is then the first of the second one.
+       close_run(current_run);
+       current_offset = 0;
+       if(current_run > 0 && current_run < runs &&
+          values[current_run - 1] == values[current_run]) {
+           current_offset = lengths[current_run - 1];
+           lengths[current_run - 1] += lengths[current_run];
+           close_run(current_run);
+           --current_run;
+       }
+   }
+
+   rle_sequence& rle_sequence::operator=(const rle_sequence& source)
+   {
+       // Self-assignment fail safe.
+       if (this == &source)
+           return *this;
+
+       value_type* temp_values = new value_type[source.capacity];
+       size_type* temp_lengths = new size_type[source.capacity];
+       for (size_type run = 0; run < source.runs; ++run) {
+           temp_values[run] = source.values[run];
+           temp_lengths[run] = source.lengths[run];
+       }
+       delete [] values;
+       delete [] lengths;
+
+       values = temp_values;
+       lengths = temp_lengths;
+       runs = source.runs;
+       capacity = source.capacity;
+       used = source.used;
+       current_run = source.current_run;
+       current_offset = source.current_offset;
+
+       return *this;
+   }
+
+   // CONSTANT MEMBER FUNCTIONS
+   rle_sequence::size_type rle_sequence::size() const
+   {
+       return used;
+   }
+
+   bool rle_sequence::is_item() const
+   {
+       return (current_run != runs);
+   }
+
+   rle_sequence::value_type rle_sequence::current() const
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       return values[current_run];
+   }
+
+   rle_sequence::size_type rle_sequence::run_count() const
+   {
+       return runs;
+   }
+
+   rle_sequence::value_type rle_sequence::sum() const
+   {
+       value_type total = 0;
+       for (size_type run = 0; run < runs; ++run) {
+           total += values[run] * value_type(lengths[run]);
+       }
+       return total;
+   }
+
+   rle_sequence::size_type rle_sequence::count(const value_type& target)
+           const
+   {
+       size_type total = 0;
+       for (size_type run = 0; run < runs; ++run) {
+           if(values[run] == target){total += lengths[run];}
+       }
+       return total;
+   }
+
+   void rle_sequence::decode(sequence& dest) const
+   {
+       sequence::value_type* target = dest.begin_bulk_write(used);
+       size_type out = 0;
+       for (size_type run = 0; run < runs; ++run) {
+           for (size_type copy = 0; copy < lengths[run]; ++copy) {
+               target[out++] = values[run];
+           }
+       }
+       dest.end_bulk_write(used);
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   void rle_sequence::insert_at(size_type run, size_type offset,
+                                const value_type& entry)
+   {
+       // Insert entry in front of item offset of run (run may be runs,
+       // with offset 0, for the end), and make it the current item.
+       ++used;
+
+       if(run < runs && values[run] == entry) {
+
+           // Inside (or at the front of) a run of entry's value.
+           ++lengths[run];
+           current_run = run;
+           current_offset = offset;
+
+       } else if(offset == 0 && run > 0 && values[run - 1] == entry) {
+
+           // Right after a run of entry's value.
+           ++lengths[run - 1];
+           current_run = run - 1;
+           current_offset = lengths[run - 1] - 1;
+
+       } else if(offset == 0) {
+
+           // Between two runs of other values: a new run.
+           open_runs(run, 1);
+           values[run] = entry;
+           lengths[run] = 1;
+           current_run = run;
+           current_offset = 0;
+
+       } else {
+
+           // Inside a run of another value: split it around entry.
+           open_runs(run + 1, 2);
+           values[run + 1] = entry;
+           lengths[run + 1] = 1;
+           values[run + 2] = values[run];
+           lengths[run + 2] = lengths[run] - offset;
+           lengths[run] = offset;
+           current_run = run + 1;
+           current_offset = 0;
+       }
+   }
+
+   void rle_sequence::open_runs(size_type run, size_type count)
+   {
+       // Shift runs run onwards up by count places, growing the arrays
+       // the way sequence::insert does if they're full.
+       if(runs + count > capacity) {
+           size_type new_capacity = size_type(1.25 * capacity) + 1;
+           if(new_capacity < runs + count){new_capacity = runs + count;}
+           resize(new_capacity);
+       }
+       for (size_type index = runs; index > run; --index) {
+           values[index + count - 1] = values[index - 1];
+           lengths[index + count - 1] = lengths[index - 1];
+       }
+       runs += count;
+   }
+
+   void rle_sequence::close_run(size_type run)
+   {
+       for (size_type index = run; index + 1 < runs; ++index) {
+           values[index] = values[index + 1];
+           lengths[index] = lengths[index + 1];
+       }
+       --runs;
+   }
+
+   void rle_sequence::resize(size_type new_capacity)
+   {
+       capacity = new_capacity;
+       value_type* temp_values = new value_type[capacity];
+       size_type* temp_lengths = new size_type[capacity];
+       for (size_type index = 0; index < runs; ++index) {
+           temp_values[index] = values[index];
+           temp_lengths[index] = lengths[index];
+       }
+       delete [] values;
+       delete [] lengths;
+       values = temp_values;
+       lengths = temp_lengths;
+   }
+}
@@ -0,0 +1,119 @@
+// FILE: SequenceRle.h
+// CLASS PROVIDED: rle_sequence (part of the namespace CS3358_FA2017)
+//
+// An rle_sequence holds the same kind of items as a sequence, and has the
+// same cursor functions, but stores them run-length encoded: each run of
+// equal items next to each other is kept once, with its length. Data made
+// of long runs of the same value takes far less memory this way, and sums
+// and counts cost one step per run rather than one per item. (NaN isn't
+// equal to anything, so each NaN item is a run of its own.)
+//
+// The current item is kept as a run and an offset within the run.
+// Inserting or removing an item next to a run of equal items just changes
+// the run's length; inserting a different item inside a run splits it in
+// two, and removing the last item between two equal runs joins them.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the rle_sequence class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+//   static const size_type DEFAULT_CAPACITY = _____
+//    The number of runs an rle_sequence made by the default constructor
+//    has room for.
+//
+// CONSTRUCTORS for the rle_sequence class:
+//   rle_sequence()
+//    Post: The rle_sequence is empty.
+//
+//   rle_sequence(const sequence& source)
+//    Post: The rle_sequence holds the items of source, in order, and
+//      there is no current item. source is not changed.
+//
+// MODIFICATION MEMBER FUNCTIONS for the rle_sequence class:
+//   void start()
+//   void advance()
+//   void insert(const value_type& entry)
+//   void attach(const value_type& entry)
+//   void remove_current()
+//    Pre:  is_item returns true for advance and remove_current.
+//    Post: As for the sequence class.
+//
+// CONSTANT MEMBER FUNCTIONS for the rle_sequence class:
+//   size_type size() const
+//   bool is_item() const
+//   value_type current() const
+//    Pre:  is_item() returns true for current.
+//    Post: As for the sequence class.
+//
+//   size_type run_count() const
+//    Post: The return value is the number of runs the items are stored
+//      as.
+//
+//   value_type sum() const
+//    Post: The return value is the sum of the items, computed as the sum
+//      of each run's value times its length.
+//
+//   size_type count(const value_type& target) const
+//    Post: The return value is the number of items equal to target.
+//
+//   void decode(sequence& dest) const
+//    Pre:  none
+//    Post: dest holds the items, in order, and its first item (if any) is
+//      the current item.
+//
+// VALUE SEMANTICS for the rle_sequence class:
+//   Assignments and the copy constructor may be used with rle_sequence
+//   objects.
+
+#ifndef SEQUENCE_RLE_H
+#define SEQUENCE_RLE_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class rle_sequence
+   {
+   public:
+      // TYPEDEFS and MEMBER CONSTANTS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      static const size_type DEFAULT_CAPACITY = 30;
+      // CONSTRUCTORS and DESTRUCTOR
+      rle_sequence();
+      rle_sequence(const sequence& source);
+      rle_sequence(const rle_sequence& source);
+      ~rle_sequence();
+      // MODIFICATION MEMBER FUNCTIONS
+      void start();
+      void advance();
+      void insert(const value_type& entry);
+      void attach(const value_type& entry);
+      void remove_current();
+      rle_sequence& operator=(const rle_sequence& source);
+      // CONSTANT MEMBER FUNCTIONS
+      size_type size() const;
+      bool is_item() const;
+      value_type current() const;
+      size_type run_count() const;
+      value_type sum() const;
+      size_type count(const value_type& target) const;
+      void decode(sequence& dest) const;
+   private:
+      value_type* values;     // the value of each run
+      size_type* lengths;     // the number of items in each run
+      size_type runs;
+      size_type capacity;     // runs the arrays have room for
+      size_type used;         // items in all the runs together
+      size_type current_run;
+      size_type current_offset;
+      // HELPER MEMBER FUNCTIONS
+      void insert_at(size_type run, size_type offset,
+                     const value_type& entry);
+      void open_runs(size_type run, size_type count);
+      void close_run(size_type run);
+      void resize(size_type new_capacity);
+   };
+}
+
+#endif
@@ -0,0 +1,277 @@
+// FILE: SequenceServer.cpp
+// A server that holds one sequence and lets any number of local clients
+// drive it with the commands of the Assign03 menu, sent as described in
+// SequenceProtocol.h over a Unix domain socket. Linux only (it uses
+// epoll); build it with "make -f MakefileServer".
+//
+// Usage: seqserver [socket path]   (the default is sequence.sock)
+//
+// Clients may send many commands without waiting for the replies. Each
+// time epoll wakes the server up, it reads everything every ready client
+// has sent, runs the whole commands, and then answers each client with a
+// single write holding all of its replies. No more than about MAX_OUTPUT
+// bytes of replies are made for a client at a time; its other commands
+// wait until those have been sent, so a client that sends but never
+// reads can't make the server hold more. Interrupt the server (or send
+// it SIGTERM) to stop it.
+#include <cerrno>      // provides errno, EAGAIN, EINTR
+#include <csignal>     // provides signal, sig_atomic_t
+#include <cstdio>      // provides perror
+#include <cstring>     // provides memset, strncpy
+#include <iostream>    // provides cout and cerr
+#include <map>
+#include <string>
+#include <vector>
+#include <fcntl.h>     // provides fcntl, O_NONBLOCK
+#include <sys/epoll.h> // provides epoll_create, epoll_ctl, epoll_wait
+#include <sys/socket.h>
+#include <sys/un.h>    // provides sockaddr_un
+#include <unistd.h>    // provides close, read, unlink
+#include "Sequence.h"
+#include "SequenceProtocol.h"
+using namespace std;
+using namespace CS3358_FA2017;
+
+// The buffered bytes of one client.
+struct client
+{
+   string input;   // received, but not yet a whole command
+   string output;  // replies not yet sent
+   bool closing;   // the client has hung up (once output is sent, close)
+};
+
+const int MAX_EVENTS = 64;
+const size_t READ_CHUNK = 65536;
+const size_t MAX_OUTPUT = 1 << 20;  // the most replies made at a time
+
+volatile sig_atomic_t stop_requested = 0;
+
+// PROTOTYPES for functions used by this program:
+void request_stop(int signal_number);
+// Pre: (none)
+// Post: The main loop will stop the next time epoll_wait returns.
+
+int open_listener(const char* path);
+// Pre: (none)
+// Post: The return value is a non-blocking socket listening at path
+//   (replacing any socket file already there), or -1 if one couldn't
+//   be made.
+
+bool set_nonblocking(int fd);
+// Pre: fd is an open file descriptor.
+// Post: fd won't block on reads or writes. The return value is false if
+//   that couldn't be set.
+
+void watch(int epoll_fd, int fd, const client& buffers, bool added);
+// Pre: fd is a client's socket, and buffers are its buffers. added is
+//   true if fd is already being watched by epoll_fd.
+// Post: epoll_fd wakes up for fd when it can be read (unless MAX_OUTPUT
+//   bytes are already waiting to be sent to it, or to be run), and when
+//   it can be written (if anything is waiting to be sent).
+
+void receive(int fd, client& buffers);
+// Pre: fd is a client's non-blocking socket.
+// Post: Everything fd had to read (up to MAX_OUTPUT bytes) has been
+//   added to buffers.input. buffers.closing is true if the client hung up
+//   or the socket failed.
+
+void send_replies(int fd, client& buffers);
+// Pre: fd is a client's non-blocking socket.
+// Post: As much of buffers.output as fd would take has been written and
+//   removed from buffers.output.
+
+int main(int argc, char* argv[])
+{
+   const char* path = (argc > 1) ? argv[1] : "sequence.sock";
+   sequence served;              // the sequence the clients share
+   map<int, client> clients;     // each client's socket and buffers
+
+   signal(SIGINT, request_stop);
+   signal(SIGTERM, request_stop);
+   signal(SIGPIPE, SIG_IGN);
+
+   int listener = open_listener(path);
+   int epoll_fd = (listener < 0) ? -1 : epoll_create(MAX_EVENTS);
+   if (epoll_fd < 0)
+   {
+      perror("seqserver");
+      return 1;
+   }
+   epoll_event event;
+   memset(&event, 0, sizeof(event));
+   event.events = EPOLLIN;
+   event.data.fd = listener;
+   epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listener, &event);
+   cout << "Serving a sequence at " << path << endl;
+
+   epoll_event events[MAX_EVENTS];
+   while (!stop_requested)
+   {
+      int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+      if (ready < 0 && errno == EINTR)
+         continue;
+      if (ready < 0)
+      {
+         perror("seqserver");
+         break;
+      }
+
+      // First read from every ready client...
+      vector<int> touched;
+      for (int index = 0; index < ready; ++index)
+      {
+         int fd = events[index].data.fd;
+         if (fd == listener)
+         {
+            int accepted;
+            while ((accepted = accept(listener, NULL, NULL)) >= 0)
+            {
+               if (!set_nonblocking(accepted))
+               {
+                  close(accepted);
+                  continue;
+               }
+               clients[accepted].closing = false;
+               watch(epoll_fd, accepted, clients[accepted], false);
+            }
+            continue;
+         }
+         if (events[index].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            receive(fd, clients[fd]);
+         touched.push_back(fd);
+      }
+
+      // ...then run each one's commands, and answer with one write.
+      for (size_t index = 0; index < touched.size(); ++index)
+      {
+         int fd = touched[index];
+         client& buffers = clients[fd];
+         sequence::size_type used;
+         send_replies(fd, buffers);
+         do
+         {
+            // Only MAX_OUTPUT bytes of replies are made at a time; the
+            // commands after them wait until those have been sent.
+            used = run_commands(served, buffers.input.data(),
+                                buffers.input.size(), buffers.output,
+                                MAX_OUTPUT);
+            buffers.input.erase(0, used);
+            send_replies(fd, buffers);
+         } while (used > 0 && buffers.output.empty()
+                  && !buffers.input.empty());
+         if (buffers.closing && buffers.output.empty())
+         {
+            close(fd);   // also stops epoll watching it
+            clients.erase(fd);
+         }
+         else
+            watch(epoll_fd, fd, buffers, true);
+      }
+   }
+
+   for (map<int, client>::iterator it = clients.begin();
+        it != clients.end(); ++it)
+      close(it->first);
+   close(epoll_fd);
+   close(listener);
+   unlink(path);
+   cout << "Server stopped." << endl;
+   return 0;
+}
+
+void request_stop(int)
+{
+   stop_requested = 1;
+}
+
+int open_listener(const char* path)
+{
+   sockaddr_un address;
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   if (strlen(path) >= sizeof(address.sun_path))
+      return -1;
+   strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+   int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (fd < 0)
+      return -1;
+   unlink(path);
+   if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+       || listen(fd, SOMAXCONN) < 0 || !set_nonblocking(fd))
+   {
+      close(fd);
+      return -1;
+   }
+   return fd;
+}
+
+bool set_nonblocking(int fd)
+{
+   int flags = fcntl(fd, F_GETFL, 0);
+   return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+void watch(int epoll_fd, int fd, const client& buffers, bool added)
+{
+   epoll_event event;
+   memset(&event, 0, sizeof(event));
+   event.events = 0;
+   if (buffers.output.size() < MAX_OUTPUT
+       && buffers.input.size() < MAX_OUTPUT && !buffers.closing)
+      event.events |= EPOLLIN;
+   if (!buffers.output.empty())
+      event.events |= EPOLLOUT;
+   event.data.fd = fd;
+   epoll_ctl(epoll_fd, added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event);
+}
+
+void receive(int fd, client& buffers)
+{
+   char chunk[READ_CHUNK];
+   size_t total = 0;
+   while (total < MAX_OUTPUT && !buffers.closing)
+   {
+      ssize_t got = read(fd, chunk, READ_CHUNK);
+      if (got > 0)
+      {
+         buffers.input.append(chunk, got);
+         total += got;
+      }
+      else if (got < 0 && errno == EINTR)
+         continue;
+      else
+      {
+         // 0 is the client hanging up; EAGAIN is nothing more to read.
+         if (got == 0 || errno != EAGAIN)
+            buffers.closing = true;
+         break;
+      }
+   }
+}
+
+void send_replies(int fd, client& buffers)
+{
+   size_t sent = 0;
+   while (sent < buffers.output.size())
+   {
+      ssize_t wrote = send(fd, buffers.output.data() + sent,
+                           buffers.output.size() - sent, MSG_NOSIGNAL);
+      if (wrote > 0)
+         sent += wrote;
+      else if (wrote < 0 && errno == EINTR)
+         continue;
+      else
+      {
+         // The client can't take any more yet (or is gone: then it hangs
+         // up, and what's left is dropped).
+         if (errno != EAGAIN)
+         {
+            buffers.closing = true;
+            sent = buffers.output.size();
+         }
+         break;
+      }
+   }
+   buffers.output.erase(0, sent);
+}
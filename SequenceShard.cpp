@@ -0,0 +1,482 @@
+// FILE: SequenceShard.cpp
+// CLASS IMPLEMENTED: sharded_sequence (see SequenceShard.h for
+//   documentation)
+// INVARIANT for the sharded_sequence class:
+//   1. The items are those of shard 0, then shard 1, ... through shard
+//      shard_count-1. Shard s has sizes[s] items, and is held by the
+//      worker process pids[s], which the coordinator talks to through
+//      sockets[s] (-1, with pids[s] 0, if the worker couldn't be
+//      started). used is the total of sizes.
+//   2. current_index is the position of the current item, or used if
+//      there is none. If there is one, it's item shard_offset of shard
+//      current_shard, and it's that worker's current item too (other
+//      workers' current items don't matter). Otherwise current_shard is
+//      shard_count.
+//   3. outgoing[s] holds the commands for shard s not yet sent, and
+//      expected[s] the letters of every command sent or queued whose
+//      reply hasn't been read; incoming[s] holds the bytes of replies
+//      read from the socket but not yet taken apart.
+//   4. healthy is false if a worker couldn't be started, or talking to
+//      one has failed.
+
+#include <cassert>
+#include <cerrno>      // provides errno, EINTR
+#include "SequenceShard.h"
+#include "SequenceView.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h> // provides send, setsockopt, socketpair, shutdown
+#include <sys/types.h>
+#include <sys/wait.h>   // provides waitpid
+#include <unistd.h>     // provides close, fork, read, _exit
+#define SEQUENCE_HAVE_FORK
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // then SO_NOSIGPIPE is set on each socket instead
+#endif
+#endif
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      // At most this many replies are left unread, so that a worker
+      // never blocks writing replies while the coordinator blocks
+      // writing more commands.
+      const sequence::size_type MAX_QUEUED = 4096;
+      const sequence::size_type READ_CHUNK = 65536;
+
+#ifdef SEQUENCE_HAVE_FORK
+      bool write_all(int fd, const string& bytes)
+      {
+          // send, not write, so that writing to a worker that has died
+          // fails instead of killing the process with SIGPIPE.
+          string::size_type sent = 0;
+          while (sent < bytes.size()) {
+              ssize_t wrote = send(fd, bytes.data() + sent,
+                                   bytes.size() - sent, MSG_NOSIGNAL);
+              if(wrote < 0 && errno == EINTR){continue;}
+              if(wrote <= 0){return false;}
+              sent += wrote;
+          }
+          return true;
+      }
+
+      // The whole life of a worker: run the commands that come in on fd
+      // against its shard until the coordinator hangs up.
+      void serve(int fd, sequence& shard)
+      {
+          string input;
+          string replies;
+          char chunk[READ_CHUNK];
+          for (;;) {
+              ssize_t got = read(fd, chunk, READ_CHUNK);
+              if(got < 0 && errno == EINTR){continue;}
+              if(got <= 0){return;}
+              input.append(chunk, got);
+              sequence::size_type used = run_commands(shard, input.data(),
+                                                      input.size(), replies);
+              input.erase(0, used);
+              if(!write_all(fd, replies)){return;}
+              replies.clear();
+          }
+      }
+#endif
+   }
+
+   // CONSTRUCTOR and DESTRUCTOR
+   sharded_sequence::sharded_sequence(size_type workers) :
+           shard_count(workers), used(0), current_index(0),
+           current_shard(workers), shard_offset(0), healthy(true)
+   {
+       // Protect pre-condition.
+       assert(workers > 0);
+
+       sockets = new int[shard_count];
+       pids = new long[shard_count];
+       sizes = new size_type[shard_count];
+       outgoing = new string[shard_count];
+       expected = new string[shard_count];
+       incoming = new string[shard_count];
+       for (size_type shard = 0; shard < shard_count; ++shard) {
+           sockets[shard] = -1;
+           pids[shard] = 0;
+           sizes[shard] = 0;
+       }
+       start_workers(sequence());
+   }
+
+   sharded_sequence::~sharded_sequence()
+   {
+       stop_workers();
+       delete [] sockets;
+       delete [] pids;
+       delete [] sizes;
+       delete [] outgoing;
+       delete [] expected;
+       delete [] incoming;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void sharded_sequence::start()
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       current_index = 0;
+       enter_shard(0);
+   }
+
+   void sharded_sequence::advance()
+   {
+       // Protect pre-condition.
+       assert(good() && is_item());
+
+       // Step within the shard, or on to the first item of the next one
+       // that has any.
+       ++current_index;
+       if(shard_offset + 1 < sizes[current_shard]) {
+           queue(current_shard, '+');
+           ++shard_offset;
+       }
+       else {enter_shard(current_shard + 1);}
+   }
+
+   void sharded_sequence::insert(const value_type& entry)
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       // With no current item, the entry goes at the front of shard 0.
+       if(!is_item()) {
+           current_index = 0;
+           current_shard = 0;
+           shard_offset = 0;
+           queue(0, '!');
+       }
+       queue(current_shard, 'I', entry);
+       ++sizes[current_shard];
+       ++used;
+   }
+
+   void sharded_sequence::attach(const value_type& entry)
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       if(is_item()) {
+           queue(current_shard, 'A', entry);
+           ++current_index;
+           ++shard_offset;
+       }
+       else {
+           // With no current item, the entry goes after the last item
+           // of the last shard, which has to be its worker's current item.
+           size_type last = shard_count - 1;
+           if(sizes[last] > 0){queue(last, 'J', sizes[last] - 1);}
+           queue(last, 'A', entry);
+           current_index = used;
+           current_shard = last;
+           shard_offset = sizes[last];
+       }
+       ++sizes[current_shard];
+       ++used;
+   }
+
+   void sharded_sequence::remove_current()
+   {
+       // Protect pre-condition.
+       assert(good() && is_item());
+
+       // The item after the removed one (if any) takes its position,
+       // which may put it in a later shard.
+       queue(current_shard, 'R');
+       --sizes[current_shard];
+       --used;
+       if(shard_offset >= sizes[current_shard]) {
+           enter_shard(current_shard + 1);
+       }
+   }
+
+   void sharded_sequence::assign(const sequence& source)
+   {
+       stop_workers();
+       start_workers(source);
+   }
+
+   void sharded_sequence::rebalance()
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       sequence items;
+       gather(items);
+       assign(items);
+   }
+
+   void sharded_sequence::exclusive_scan(value_type initial)
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       // Every worker adds up its shard at once; then every worker scans
+       // its shard at once, starting from the total of those before it.
+       for (size_type shard = 0; shard < shard_count; ++shard) {
+           queue(shard, 'T');
+           send_queued(shard);
+       }
+       value_type running = initial;
+       for (size_type shard = 0; shard < shard_count; ++shard) {
+           value_type total = receive_replies(shard).value;
+           queue(shard, 'X', running);
+           send_queued(shard);
+           running += total;
+       }
+       for (size_type shard = 0; shard < shard_count; ++shard) {
+           receive_replies(shard);
+       }
+       start();
+   }
+
+   // CONSTANT MEMBER FUNCTIONS
+   bool sharded_sequence::good() const
+   {
+       return healthy;
+   }
+
+   sharded_sequence::size_type sharded_sequence::size() const
+   {
+       return used;
+   }
+
+   bool sharded_sequence::is_item() const
+   {
+       return (current_index < used);
+   }
+
+   sharded_sequence::value_type sharded_sequence::current() const
+   {
+       // Protect pre-condition.
+       assert(good() && is_item());
+
+       queue(current_shard, 'C');
+       send_queued(current_shard);
+       return receive_replies(current_shard).value;
+   }
+
+   sharded_sequence::size_type sharded_sequence::shards() const
+   {
+       return shard_count;
+   }
+
+   sharded_sequence::size_type sharded_sequence::shard_size(
+           size_type shard) const
+   {
+       // Protect pre-condition.
+       assert(shard < shard_count);
+
+       return sizes[shard];
+   }
+
+   sharded_sequence::value_type sharded_sequence::sum() const
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       // Ask every worker before waiting for any of them.
+       for (size_type shard = 0; shard < shard_count; ++shard) {
+           queue(shard, 'T');
+           send_queued(shard);
+       }
+       value_type total = 0;
+       for (size_type shard = 0; shard < shard_count; ++shard) {
+           total += receive_replies(shard).value;
+       }
+       return total;
+   }
+
+   void sharded_sequence::gather(sequence& dest) const
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       for (size_type shard = 0; shard < shard_count; ++shard) {
+           queue(shard, 'P');
+           send_queued(shard);
+       }
+       // Fill dest in place, so it keeps its own index, filter, handles
+       // and checkpoints. A shard that doesn't answer adds nothing.
+       value_type* target = dest.begin_bulk_write(used);
+       size_type filled = 0;
+       for (size_type shard = 0; shard < shard_count; ++shard) {
+           command_reply reply = receive_replies(shard);
+           if(!reply.ok){continue;}
+           reply.items.pack();
+           size_type count = reply.items.used;
+           if(count > used - filled){count = used - filled;}
+           for (size_type index = 0; index < count; ++index) {
+               target[filled + index] = reply.items.data[index];
+           }
+           filled += count;
+       }
+       dest.end_bulk_write(filled);
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   void sharded_sequence::start_workers(const sequence& source)
+   {
+       // Give each shard source.size() / shard_count items, and one more
+       // to each of the first few, to use up the remainder.
+       healthy = true;
+       used = source.size();
+       current_index = used;
+       current_shard = shard_count;
+       shard_offset = 0;
+       size_type shard_end = 0;
+       for (size_type shard = 0; shard < shard_count; ++shard) {
+           sizes[shard] = used / shard_count +
+                   ((shard < used % shard_count) ? 1 : 0);
+           shard_end += sizes[shard];
+           outgoing[shard].clear();
+           expected[shard].clear();
+           incoming[shard].clear();
+#ifdef SEQUENCE_HAVE_FORK
+           int ends[2];
+           if(socketpair(AF_UNIX, SOCK_STREAM, 0, ends) < 0) {
+               healthy = false;
+               continue;
+           }
+#ifdef SO_NOSIGPIPE
+           int on = 1;
+           setsockopt(ends[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+           setsockopt(ends[1], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+           pid_t child = fork();
+           if(child == 0) {
+               // The worker: keep only its own end of its own socket, and
+               // its own shard (fork gave it a copy of source).
+               close(ends[0]);
+               for (size_type other = 0; other < shard; ++other) {
+                   if(sockets[other] >= 0){close(sockets[other]);}
+               }
+               sequence items;
+               sequence_view whole(source);
+               whole.slice(shard_end - sizes[shard], shard_end)
+                       .materialize(items);
+               serve(ends[1], items);
+               _exit(0);
+           }
+           close(ends[1]);
+           if(child < 0) {
+               close(ends[0]);
+               healthy = false;
+               continue;
+           }
+           sockets[shard] = ends[0];
+           pids[shard] = child;
+#else
+           healthy = false;
+#endif
+       }
+   }
+
+   void sharded_sequence::stop_workers()
+   {
+       // shutdown, not just close, so a worker sees the end of its input
+       // even if another process (such as a worker of another
+       // sharded_sequence, made by fork) has a copy of the socket.
+       for (size_type shard = 0; shard < shard_count; ++shard) {
+#ifdef SEQUENCE_HAVE_FORK
+           if(sockets[shard] >= 0) {
+               shutdown(sockets[shard], SHUT_RDWR);
+               close(sockets[shard]);
+           }
+           if(pids[shard] > 0) {
+               waitpid(pid_t(pids[shard]), NULL, 0);
+           }
+#endif
+           sockets[shard] = -1;
+           pids[shard] = 0;
+       }
+   }
+
+   void sharded_sequence::queue(size_type shard, char op,
+                                value_type entry) const
+   {
+       // Settle the commands already waiting first, so the replies to
+       // them are read here, and op's is left for the caller to read.
+       if(expected[shard].size() >= MAX_QUEUED) {
+           send_queued(shard);
+           receive_replies(shard);
+       }
+       put_command(outgoing[shard], op, entry);
+       expected[shard] += op;
+   }
+
+   void sharded_sequence::send_queued(size_type shard) const
+   {
+#ifdef SEQUENCE_HAVE_FORK
+       if(sockets[shard] < 0 || !write_all(sockets[shard], outgoing[shard])) {
+           healthy = false;
+       }
+#endif
+       outgoing[shard].clear();
+   }
+
+   command_reply sharded_sequence::receive_replies(size_type shard) const
+   {
+       // Read replies until there is one for every command sent; the
+       // last one is returned.
+       command_reply reply;
+       reply.ok = false;
+       reply.value = 0;
+       reply.count = 0;
+       string& bytes = incoming[shard];
+       string& letters = expected[shard];
+       string::size_type taken = 0;
+       string::size_type answered = 0;
+       while (answered < letters.size()) {
+           size_type length = get_reply(letters[answered],
+                                        bytes.data() + taken,
+                                        bytes.size() - taken, reply);
+           if(length > 0) {
+               taken += length;
+               ++answered;
+               continue;
+           }
+#ifdef SEQUENCE_HAVE_FORK
+           char chunk[READ_CHUNK];
+           ssize_t got = (sockets[shard] < 0) ? -1 :
+                   read(sockets[shard], chunk, READ_CHUNK);
+           if(got < 0 && errno == EINTR){continue;}
+           if(got > 0) {
+               bytes.append(chunk, got);
+               continue;
+           }
+#endif
+           // The worker is gone, so no more replies will come.
+           healthy = false;
+           reply.ok = false;
+           reply.value = 0;
+           answered = letters.size();
+           taken = bytes.size();
+       }
+       bytes.erase(0, taken);
+       letters.erase(0, answered);
+       return reply;
+   }
+
+   void sharded_sequence::enter_shard(size_type first)
+   {
+       // Make the first item of the first shard from first on that has
+       // any items the current item (current_index is already its
+       // position), or, if there is none, note that there's no current
+       // item.
+       current_shard = first;
+       while (current_shard < shard_count && sizes[current_shard] == 0) {
+           ++current_shard;
+       }
+       shard_offset = 0;
+       if(current_shard < shard_count){queue(current_shard, '!');}
+   }
+}
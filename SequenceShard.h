@@ -0,0 +1,172 @@
+// FILE: SequenceShard.h
+// CLASS PROVIDED: sharded_sequence (part of the namespace CS3358_FA2017)
+//
+// A sharded_sequence splits its items into shards: consecutive runs of
+// items ("range partitions"), each held by a separate worker process.
+// Reducing or scanning the items then reads them with every worker at
+// once, so it isn't limited to the memory bandwidth one process gets.
+// The program that made the sharded_sequence (the coordinator) talks to
+// each worker over a socket, with the commands of SequenceProtocol.h.
+//
+// The position of the current item is kept by the coordinator, along
+// with the size of every shard, so it can tell which shard holds the
+// current item, and where in that shard it is. The cursor functions
+// and insert, attach and remove_current are sent to that shard only,
+// and the coordinator doesn't wait for the workers to answer the ones
+// whose answers it already knows: they are sent along with the next
+// command that needs an answer. sum and exclusive_scan send a command to
+// every shard before waiting for any of them.
+//
+// assign splits the items into shards of (nearly) equal size, and makes
+// a new worker for each, which starts with a copy of its shard (fork
+// copies it; nothing is sent over the socket). Items added afterwards
+// go to the shard where they belong in the order of the sequence, so
+// the shards may become uneven; rebalance evens them out again.
+//
+// Worker processes need POSIX (fork and socketpair). Elsewhere good() is
+// always false.
+//
+// TYPEDEFS for the sharded_sequence class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+// CONSTRUCTOR for the sharded_sequence class:
+//   sharded_sequence(size_type workers)
+//    Pre:  workers > 0
+//    Post: The sharded_sequence is empty, with workers shards (and a
+//      worker process for each). good() tells whether the workers could
+//      be started.
+//
+// DESTRUCTOR for the sharded_sequence class:
+//   ~sharded_sequence()
+//    Post: The worker processes have been stopped.
+//
+// MODIFICATION MEMBER FUNCTIONS for the sharded_sequence class:
+//   void start()
+//   void advance()
+//   void insert(const value_type& entry)
+//   void attach(const value_type& entry)
+//   void remove_current()
+//    Pre:  good() returns true, and as for the same functions of sequence
+//      (see Sequence.h).
+//    Post: As for sequence.
+//
+//   void assign(const sequence& source)
+//    Pre:  none
+//    Post: The items are a copy of source's, split evenly among new
+//      worker processes (the old ones have been stopped), and there is
+//      no current item. good() tells whether the workers could be
+//      started.
+//
+//   void rebalance()
+//    Pre:  good() returns true.
+//    Post: As for assign, with the items the sharded_sequence already had.
+//
+//   void exclusive_scan(value_type initial = 0)
+//    Pre:  good() returns true.
+//    Post: Each item has been replaced by initial plus the sum of the
+//      items before it (see exclusive_scan in SequenceNumeric.h). The
+//      first item (if any) is the current item. Each shard is scanned by
+//      its own worker, after only the totals of the shards before it are
+//      known.
+//
+// CONSTANT MEMBER FUNCTIONS for the sharded_sequence class:
+//   bool good() const
+//    Pre:  none
+//    Post: The return value is false if the workers couldn't be started,
+//      or if talking to one of them has failed.
+//
+//   size_type size() const
+//   bool is_item() const
+//   value_type current() const
+//    Pre:  good() returns true, and is_item() for current.
+//    Post: As for sequence.
+//
+//   size_type shards() const
+//   size_type shard_size(size_type shard) const
+//    Pre:  shard < shards(), for shard_size.
+//    Post: The return value is the number of shards, or the number of
+//      items in shard.
+//
+//   value_type sum() const
+//    Pre:  good() returns true.
+//    Post: The return value is the sum of all of the items, each worker
+//      having added up its own shard.
+//
+//   void gather(sequence& dest) const
+//    Pre:  good() returns true.
+//    Post: dest holds a copy of all of the items, and its first item (if
+//      any) is the current item. As for an assignment (see Sequence.h),
+//      dest keeps its own index, filter, handles and checkpoints.
+//
+// VALUE SEMANTICS for the sharded_sequence class:
+//   sharded_sequence objects may not be copied or assigned (each owns its
+//   worker processes). Use gather to copy the items into a sequence, and
+//   assign to copy a sequence into a sharded_sequence.
+
+#ifndef SEQUENCE_SHARD_H
+#define SEQUENCE_SHARD_H
+#include <string>
+#include "Sequence.h"
+#include "SequenceProtocol.h"
+
+namespace CS3358_FA2017
+{
+   class sharded_sequence
+   {
+   public:
+      // TYPEDEFS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      // CONSTRUCTOR and DESTRUCTOR
+      sharded_sequence(size_type workers);
+      ~sharded_sequence();
+      // MODIFICATION MEMBER FUNCTIONS
+      void start();
+      void advance();
+      void insert(const value_type& entry);
+      void attach(const value_type& entry);
+      void remove_current();
+      void assign(const sequence& source);
+      void rebalance();
+      void exclusive_scan(value_type initial = 0);
+      // CONSTANT MEMBER FUNCTIONS
+      bool good() const;
+      size_type size() const;
+      bool is_item() const;
+      value_type current() const;
+      size_type shards() const;
+      size_type shard_size(size_type shard) const;
+      value_type sum() const;
+      void gather(sequence& dest) const;
+   private:
+      size_type shard_count;
+      int* sockets;             // the coordinator's end of each socket
+      long* pids;               // each worker's process id, or 0
+      size_type* sizes;         // the number of items in each shard
+      size_type used;           // the sum of sizes
+      size_type current_index;  // position of the current item, or used
+      size_type current_shard;  // the shard it's in, and where in it
+      size_type shard_offset;
+      // Commands waiting to be sent, the letters of those whose replies
+      // haven't been read, and the bytes of replies read so far, for each
+      // shard. A const function may still have to send and read these.
+      std::string* outgoing;
+      std::string* expected;
+      std::string* incoming;
+      mutable bool healthy;
+      // HELPER MEMBER FUNCTIONS
+      void start_workers(const sequence& source);
+      void stop_workers();
+      void queue(size_type shard, char op, value_type entry = 0) const;
+      void send_queued(size_type shard) const;
+      command_reply receive_replies(size_type shard) const;
+      void enter_shard(size_type first);
+      // Not copyable: see VALUE SEMANTICS above.
+      sharded_sequence(const sharded_sequence& source);
+      sharded_sequence& operator=(const sharded_sequence& source);
+   };
+}
+
+#endif
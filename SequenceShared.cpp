@@ -0,0 +1,375 @@
+// FILE: SequenceShared.cpp
+// CLASS IMPLEMENTED: shared_sequence (see SequenceShared.h for
+//   documentation)
+// INVARIANT for the shared_sequence class:
+//   1. header is the start of mapped_bytes bytes of shared memory called
+//      shared_name, or NULL if it couldn't be made or opened. The header
+//      is followed by room for header->capacity items, data[0] through
+//      data[header->capacity-1], of which the first header->used are
+//      the items of the sequence.
+//   2. writer is true if this object made the shared memory. Only the
+//      writer changes it, and it makes header->version odd while it does
+//      (and even again, one higher, when it's done), so a reader that
+//      sees the same even version before and after reading has seen no
+//      change.
+//   3. For the writer, current_index is the position of the current
+//      item, or header->used if there is none. Readers don't use it.
+
+#include <cassert>
+#include <cstring>     // provides memcmp, memcpy
+#include <ctime>       // provides difftime, time, time_t
+#include "SequenceShared.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>     // provides O_CREAT, O_EXCL, O_RDONLY, O_RDWR
+#include <sys/mman.h>  // provides mmap, munmap, shm_open, shm_unlink
+#include <sys/stat.h>  // provides fstat
+#include <unistd.h>    // provides close, ftruncate
+#define SEQUENCE_HAVE_SHM
+#endif
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   // The start of the shared memory. Readers read version and used while
+   // the writer may be changing them, so the compiler mustn't keep them
+   // in registers.
+   struct shared_sequence::shared_header
+   {
+      char magic[8];
+      volatile unsigned long version;
+      unsigned long capacity;
+      volatile unsigned long used;
+   };
+
+   namespace
+   {
+      const char MAGIC[8] = { 'S', 'E', 'Q', 'S', 'H', 'M', '0', '1' };
+
+      // How long (in seconds) a reader waits out a change before deciding
+      // that the writer stopped in the middle of it, and how many times
+      // it reads the version between looks at the clock.
+      const double READ_PATIENCE = 2.0;
+      const unsigned long SPINS_PER_CHECK = 1024;
+
+      void memory_barrier()
+      {
+          // Keep reads and writes of the shared memory on their side of
+          // a change to the version, for the compiler and the processor.
+#ifdef __GNUC__
+          __sync_synchronize();
+#endif
+      }
+   }
+
+   // CONSTRUCTORS and DESTRUCTOR
+   shared_sequence::shared_sequence(const char* name, size_type capacity) :
+           shared_name(name), header(NULL), data(NULL), mapped_bytes(0),
+           current_index(0), writer(true)
+   {
+       // Protect pre-condition.
+       assert(name[0] == '/');
+       assert(capacity > 0);
+
+#ifdef SEQUENCE_HAVE_SHM
+       // The size of the memory must fit in ftruncate's (signed) off_t,
+       // without wrapping around.
+       size_type most = size_type(-1) / 2;
+       if(capacity > (most - sizeof(shared_header)) / sizeof(value_type)) {
+           return;
+       }
+
+       // Start afresh, so no reader can find half-made memory by name
+       // until the magic number says it's ready.
+       shm_unlink(name);
+       int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+       if(fd < 0){return;}
+       size_type bytes = sizeof(shared_header) + capacity * sizeof(value_type);
+       void* memory = MAP_FAILED;
+       if(ftruncate(fd, off_t(bytes)) == 0) {
+           memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         fd, 0);
+       }
+       close(fd);
+       if(memory == MAP_FAILED) {
+           shm_unlink(name);
+           return;
+       }
+
+       header = static_cast<shared_header*>(memory);
+       data = reinterpret_cast<value_type*>(header + 1);
+       mapped_bytes = bytes;
+       header->version = 0;
+       header->capacity = capacity;
+       header->used = 0;
+       memory_barrier();
+       memcpy(header->magic, MAGIC, sizeof(MAGIC));
+#endif
+   }
+
+   shared_sequence::shared_sequence(const char* name) :
+           shared_name(name), header(NULL), data(NULL), mapped_bytes(0),
+           current_index(0), writer(false)
+   {
+       // Protect pre-condition.
+       assert(name[0] == '/');
+
+#ifdef SEQUENCE_HAVE_SHM
+       int fd = shm_open(name, O_RDONLY, 0);
+       if(fd < 0){return;}
+       struct stat status;
+       void* memory = MAP_FAILED;
+       if(fstat(fd, &status) == 0 &&
+          size_type(status.st_size) >= sizeof(shared_header)) {
+           memory = mmap(NULL, size_type(status.st_size), PROT_READ,
+                         MAP_SHARED, fd, 0);
+       }
+       close(fd);
+       if(memory == MAP_FAILED){return;}
+
+       // Only use memory the writer has finished setting up, and that
+       // has room for the items it says it has.
+       shared_header* found = static_cast<shared_header*>(memory);
+       bool ok = memcmp(found->magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 found->capacity <= (size_type(status.st_size) -
+                         sizeof(shared_header)) / sizeof(value_type);
+       if(!ok) {
+           munmap(memory, size_type(status.st_size));
+           return;
+       }
+       memory_barrier();
+       header = found;
+       data = reinterpret_cast<value_type*>(header + 1);
+       mapped_bytes = size_type(status.st_size);
+#endif
+   }
+
+   shared_sequence::~shared_sequence()
+   {
+#ifdef SEQUENCE_HAVE_SHM
+       if(header != NULL){munmap(header, mapped_bytes);}
+       if(header != NULL && writer){shm_unlink(shared_name.c_str());}
+#endif
+       header = NULL;
+       data = NULL;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void shared_sequence::start()
+   {
+       // Protect pre-condition.
+       assert(good() && writer);
+
+       current_index = 0;
+   }
+
+   void shared_sequence::advance()
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       ++current_index;
+   }
+
+   void shared_sequence::insert(const value_type& entry)
+   {
+       // Protect pre-condition.
+       assert(good() && writer);
+       assert(header->used < header->capacity);
+
+       // With no current item, insert at the front, as sequence does.
+       size_type used = header->used;
+       if(current_index >= used){current_index = 0;}
+       begin_change();
+       for (size_type index = used; index > current_index; --index) {
+           data[index] = data[index-1];
+       }
+       data[current_index] = entry;
+       header->used = used + 1;
+       end_change();
+   }
+
+   void shared_sequence::attach(const value_type& entry)
+   {
+       // Protect pre-condition.
+       assert(good() && writer);
+       assert(header->used < header->capacity);
+
+       // With no current item, attach at the end, as sequence does.
+       size_type used = header->used;
+       current_index = (current_index >= used) ? used : current_index + 1;
+       begin_change();
+       for (size_type index = used; index > current_index; --index) {
+           data[index] = data[index-1];
+       }
+       data[current_index] = entry;
+       header->used = used + 1;
+       end_change();
+   }
+
+   void shared_sequence::remove_current()
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       size_type used = header->used;
+       begin_change();
+       for (size_type index = current_index; index + 1 < used; ++index) {
+           data[index] = data[index+1];
+       }
+       header->used = used - 1;
+       end_change();
+   }
+
+   void shared_sequence::assign(const sequence& source)
+   {
+       // Protect pre-condition.
+       assert(good() && writer);
+       assert(source.size() <= header->capacity);
+
+       source.pack();
+       begin_change();
+       memcpy(data, source.data, source.used * sizeof(value_type));
+       header->used = source.used;
+       end_change();
+       current_index = source.used;
+   }
+
+   // CONSTANT MEMBER FUNCTIONS
+   bool shared_sequence::good() const
+   {
+       return (header != NULL);
+   }
+
+   bool shared_sequence::is_writer() const
+   {
+       return writer;
+   }
+
+   shared_sequence::size_type shared_sequence::size() const
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       return header->used;
+   }
+
+   shared_sequence::size_type shared_sequence::capacity() const
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       return header->capacity;
+   }
+
+   bool shared_sequence::is_item() const
+   {
+       // Protect pre-condition.
+       assert(good() && writer);
+
+       return (current_index < header->used);
+   }
+
+   shared_sequence::value_type shared_sequence::current() const
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       return data[current_index];
+   }
+
+   bool shared_sequence::get(size_type position, value_type& result) const
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       // Try again until the writer didn't change anything meanwhile.
+       bool found;
+       value_type item = 0;
+       unsigned long started;
+       do {
+           if(!begin_read(started)){return false;}
+           size_type used = header->used;
+           if(used > header->capacity){used = header->capacity;}
+           found = (position < used);
+           if(found){item = data[position];}
+       } while (!end_read(started));
+
+       if(found){result = item;}
+       return found;
+   }
+
+   unsigned long shared_sequence::snapshot(sequence& dest) const
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       // The copy is made straight into dest, and made again if the
+       // writer changed anything while it was being made.
+       unsigned long started;
+       do {
+           if(!begin_read(started)) {
+               dest.begin_bulk_write(0);
+               dest.end_bulk_write(0);
+               return started;
+           }
+           size_type count = header->used;
+           if(count > header->capacity){count = header->capacity;}
+           value_type* target = dest.begin_bulk_write(count);
+           memcpy(target, data, count * sizeof(value_type));
+           dest.end_bulk_write(count);
+       } while (!end_read(started));
+       return started;
+   }
+
+   unsigned long shared_sequence::version() const
+   {
+       // Protect pre-condition.
+       assert(good());
+
+       unsigned long started;
+       begin_read(started);
+       return started;
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   void shared_sequence::begin_change()
+   {
+       header->version = header->version + 1;
+       memory_barrier();
+   }
+
+   void shared_sequence::end_change()
+   {
+       memory_barrier();
+       header->version = header->version + 1;
+   }
+
+   bool shared_sequence::begin_read(unsigned long& started) const
+   {
+       // Wait out a change the writer is in the middle of, but not for
+       // ever: a writer that dies during a change leaves the version odd.
+       time_t waiting_since = 0;
+       unsigned long spins = 0;
+       started = header->version;
+       while (started % 2 != 0) {
+           ++spins;
+           if(spins % SPINS_PER_CHECK == 0) {
+               time_t now = time(NULL);
+               if(waiting_since == 0){waiting_since = now;}
+               else if(difftime(now, waiting_since) >= READ_PATIENCE) {
+                   return false;
+               }
+           }
+           started = header->version;
+       }
+       memory_barrier();
+       return true;
+   }
+
+   bool shared_sequence::end_read(unsigned long started) const
+   {
+       memory_barrier();
+       return (header->version == started);
+   }
+}
@@ -0,0 +1,173 @@
+// FILE: SequenceShared.h
+// CLASS PROVIDED: shared_sequence (part of the namespace CS3358_FA2017)
+//
+// A shared_sequence keeps its items in POSIX shared memory, so that
+// several processes on the same machine can read one sequence without
+// each holding its own copy. Only one process writes: the one that made
+// the shared memory with the writer's constructor. Any number of others
+// open it by name with the reader's constructor, and map the same pages
+// read-only.
+//
+// Readers take no lock, and never hold up the writer. The shared memory
+// starts with a version number, which is even except while the writer is
+// changing the sequence (it adds one before and one after each change).
+// A reader notes the version, reads what it wants, and reads the version
+// again: if it was odd, or has changed, the writer got in the way and the
+// reader tries again (this is a "seqlock"). A reader may so have to wait
+// out a change, but it never sees one half made. If the writer dies in
+// the middle of a change, the version stays odd; a reader gives up after
+// waiting a couple of seconds, and get and snapshot say that they failed.
+//
+// The room for the items is fixed when the shared memory is made, since
+// every reader has it mapped; a sequence can't grow past capacity().
+// Each process has its own current item: the writer's is changed by the
+// writer's functions, as for sequence, and a reader asks for items by
+// position instead (since the writer may change them at any time).
+//
+// Shared memory is only available on POSIX systems. Elsewhere good()
+// is always false.
+//
+// TYPEDEFS for the shared_sequence class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+// CONSTRUCTORS for the shared_sequence class:
+//   shared_sequence(const char* name, size_type capacity)
+//    Pre:  name starts with '/' and has no other '/' (as shm_open needs),
+//      and capacity > 0.
+//    Post: This is the writer of a new, empty shared sequence called
+//      name, with room for capacity items, replacing any shared sequence
+//      that had that name. good() tells whether it could be made (it
+//      can't if capacity items are more bytes than memory can hold, and
+//      then the old shared sequence, if any, is left alone).
+//
+//   shared_sequence(const char* name)
+//    Pre:  name is as above.
+//    Post: This is a reader of the shared sequence called name. good()
+//      tells whether it could be opened.
+//
+// DESTRUCTOR for the shared_sequence class:
+//   ~shared_sequence()
+//    Post: The shared memory is no longer mapped in this process. If this
+//      is the writer, the name is removed too (readers that already have
+//      it open can still read it, but no more can open it).
+//
+// MODIFICATION MEMBER FUNCTIONS for the shared_sequence class:
+//   void start()
+//   void advance()
+//   void insert(const value_type& entry)
+//   void attach(const value_type& entry)
+//   void remove_current()
+//    Pre:  is_writer() returns true, and as for the same functions of
+//      sequence (see Sequence.h). size() < capacity() for insert and
+//      attach.
+//    Post: As for sequence. Readers see the change whole, or not at all.
+//
+//   void assign(const sequence& source)
+//    Pre:  is_writer() returns true, and source.size() <= capacity().
+//    Post: The items are a copy of source's, made in one change, and
+//      there is no current item.
+//
+// CONSTANT MEMBER FUNCTIONS for the shared_sequence class:
+//   bool good() const
+//    Pre:  none
+//    Post: The return value is true if the shared memory is mapped. The
+//      other functions (but is_writer) may only be used if it is.
+//
+//   bool is_writer() const
+//    Pre:  none
+//    Post: The return value is true if this object made the shared
+//      memory.
+//
+//   size_type size() const
+//   size_type capacity() const
+//    Pre:  none
+//    Post: The return value is the number of items, or the number there
+//      is room for.
+//
+//   bool is_item() const
+//   value_type current() const
+//    Pre:  is_writer() returns true, and is_item() for current.
+//    Post: As for sequence.
+//
+//   bool get(size_type position, value_type& result) const
+//    Pre:  none
+//    Post: If position < size(), result is the item at position and the
+//      return value is true. Otherwise, or if the writer stopped in the
+//      middle of a change, the return value is false, and result is
+//      unchanged.
+//
+//   unsigned long snapshot(sequence& dest) const
+//    Pre:  none
+//    Post: dest holds a copy of the items as they were at one moment,
+//      with its first item (if any) the current item. The return value
+//      is the version they were copied at (see version). If the writer
+//      stopped in the middle of a change, dest is empty instead, and the
+//      return value is odd.
+//
+//   unsigned long version() const
+//    Pre:  none
+//    Post: The return value is a number that changes each time the
+//      writer changes the sequence, so a reader can tell whether a
+//      snapshot it holds is out of date. It is odd only if the writer
+//      stopped in the middle of a change.
+//
+// VALUE SEMANTICS for the shared_sequence class:
+//   shared_sequence objects may not be copied or assigned (there is only
+//   one writer). Use snapshot to copy the items into a sequence.
+
+#ifndef SEQUENCE_SHARED_H
+#define SEQUENCE_SHARED_H
+#include <string>
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class shared_sequence
+   {
+   public:
+      // TYPEDEFS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      // CONSTRUCTORS and DESTRUCTOR
+      shared_sequence(const char* name, size_type capacity);
+      shared_sequence(const char* name);
+      ~shared_sequence();
+      // MODIFICATION MEMBER FUNCTIONS
+      void start();
+      void advance();
+      void insert(const value_type& entry);
+      void attach(const value_type& entry);
+      void remove_current();
+      void assign(const sequence& source);
+      // CONSTANT MEMBER FUNCTIONS
+      bool good() const;
+      bool is_writer() const;
+      size_type size() const;
+      size_type capacity() const;
+      bool is_item() const;
+      value_type current() const;
+      bool get(size_type position, value_type& result) const;
+      unsigned long snapshot(sequence& dest) const;
+      unsigned long version() const;
+   private:
+      struct shared_header;
+      std::string shared_name;
+      shared_header* header;  // the start of the mapping, or NULL
+      value_type* data;       // the items, just after the header
+      size_type mapped_bytes;
+      size_type current_index;
+      bool writer;
+      // HELPER MEMBER FUNCTIONS
+      void begin_change();
+      void end_change();
+      bool begin_read(unsigned long& started) const;
+      bool end_read(unsigned long started) const;
+      // Not copyable: see VALUE SEMANTICS above.
+      shared_sequence(const shared_sequence& source);
+      shared_sequence& operator=(const shared_sequence& source);
+   };
+}
+
+#endif
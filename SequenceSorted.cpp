@@ -0,0 +1,305 @@
+// FILE: SequenceSorted.cpp
+// FUNCTIONS IMPLEMENTED: operations on sorted sequences
+//   (see SequenceSorted.h for documentation)
+//
+// The k-way merge uses a loser tree: a complete binary tree with the k
+// inputs as its leaves, where leaf i is numbered k + i and internal node
+// n has children 2n and 2n+1. Every internal node remembers the input
+// that LOST the comparison played there, and node 0 remembers the
+// overall winner, whose next item is the smallest one left. After that
+// item is taken, only the games on the path from the winner's leaf to
+// the root have to be replayed, one comparison per level.
+//
+// The set operations walk a and b side by side like a merge. Whenever
+// one side's next item is smaller than the other's, the whole run of
+// such items is found with gallop() and then skipped or copied at once.
+
+#include <cassert>
+#include "SequenceSorted.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      // The read positions of the inputs of a merge.
+      struct merge_input
+      {
+         const sequence::value_type* items;
+         sequence::size_type next;
+         sequence::size_type count;
+      };
+
+      // True if input a's next item should be written before input b's.
+      // An exhausted input loses to every other one, and ties go to the
+      // lower-numbered input so the merge is stable.
+      bool beats(const merge_input* inputs, sequence::size_type a,
+                 sequence::size_type b)
+      {
+          if(inputs[a].next == inputs[a].count){return false;}
+          if(inputs[b].next == inputs[b].count){return true;}
+          sequence::value_type item_a = inputs[a].items[inputs[a].next];
+          sequence::value_type item_b = inputs[b].items[inputs[b].next];
+          if(item_a < item_b){return true;}
+          if(item_b < item_a){return false;}
+          return a < b;
+      }
+
+      // Return the index of the first item in items[first..count-1] that
+      // is not less than target (count if there isn't one). The steps
+      // double (1, 2, 4, ...) until they pass target, and a binary search
+      // finishes in the last step, so skipping d items takes O(log d).
+      sequence::size_type gallop(const sequence::value_type* items,
+                                 sequence::size_type first,
+                                 sequence::size_type count,
+                                 sequence::value_type target)
+      {
+          sequence::size_type low = first;    // items before low are < target
+          sequence::size_type step = 1;
+          sequence::size_type high = first;
+          while (high < count && items[high] < target) {
+              low = high + 1;
+              high = (count - high > step) ? high + step : count;
+              step *= 2;
+          }
+
+          // Now items[low-1] < target, and high is count or items[high]
+          // is not less than target.
+          while (low < high) {
+              sequence::size_type middle = low + (high - low) / 2;
+              if(items[middle] < target){low = middle + 1;}
+              else {high = middle;}
+          }
+          return low;
+      }
+
+      // Copy items[first..last-1] to target starting at target[out], and
+      // return the index just past the copied items.
+      sequence::size_type copy_run(const sequence::value_type* items,
+                                   sequence::size_type first,
+                                   sequence::size_type last,
+                                   sequence::value_type* target,
+                                   sequence::size_type out)
+      {
+          for (sequence::size_type index = first; index < last; ++index) {
+              target[out] = items[index];
+              ++out;
+          }
+          return out;
+      }
+   }
+
+   // MERGING
+   void merge_sorted(const sequence* const inputs[],
+                     sequence::size_type input_count, sequence& dest)
+   {
+       // dest's array is written while the inputs are still being read,
+       // so if dest is one of them, merge into a temporary.
+       sequence::size_type total = 0;
+       for (sequence::size_type index = 0; index < input_count; ++index) {
+           if(inputs[index] == &dest) {
+               sequence temp;
+               merge_sorted(inputs, input_count, temp);
+               dest.copy_items(temp);
+               return;
+           }
+           inputs[index]->pack();
+           total += inputs[index]->used;
+       }
+
+       sequence::value_type* target = dest.begin_bulk_write(total);
+       if(input_count == 0) {
+           dest.end_bulk_write(0);
+           return;
+       }
+
+       merge_input* state = new merge_input[input_count];
+       for (sequence::size_type index = 0; index < input_count; ++index) {
+           state[index].items = inputs[index]->data;
+           state[index].next = 0;
+           state[index].count = inputs[index]->used;
+       }
+
+       // Build the tree bottom up: winner[n] is the winner of the games
+       // below node n, and tree[n] the loser of the game at node n.
+       sequence::size_type k = input_count;
+       sequence::size_type* tree = new sequence::size_type[k];
+       sequence::size_type* winner = new sequence::size_type[k];
+       tree[0] = 0;
+       for (sequence::size_type node = k - 1; node >= 1; --node) {
+           sequence::size_type left = 2 * node;
+           sequence::size_type right = 2 * node + 1;
+           sequence::size_type a = (left >= k) ? left - k : winner[left];
+           sequence::size_type b = (right >= k) ? right - k : winner[right];
+           if(beats(state, a, b)) {
+               winner[node] = a;
+               tree[node] = b;
+           } else {
+               winner[node] = b;
+               tree[node] = a;
+           }
+       }
+       if(k > 1){tree[0] = winner[1];}
+       delete [] winner;
+
+       for (sequence::size_type out = 0; out < total; ++out) {
+           // Take the winner's next item, then replay its path to the root.
+           // At every node the stored loser plays the current champion;
+           // whoever loses stays at the node.
+           sequence::size_type champion = tree[0];
+           merge_input& source = state[champion];
+           target[out] = source.items[source.next];
+           ++source.next;
+
+           for (sequence::size_type node = (champion + k) / 2; node >= 1;
+                node /= 2) {
+               if(beats(state, tree[node], champion)) {
+                   sequence::size_type loser = champion;
+                   champion = tree[node];
+                   tree[node] = loser;
+               }
+           }
+           tree[0] = champion;
+       }
+
+       delete [] tree;
+       delete [] state;
+       dest.end_bulk_write(total);
+   }
+
+   // SET OPERATIONS
+   void sorted_union(const sequence& a, const sequence& b, sequence& dest)
+   {
+       // dest's array is written while a and b are still being read.
+       if(&dest == &a || &dest == &b) {
+           sequence temp;
+           sorted_union(a, b, temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       a.pack();
+       b.pack();
+       const sequence::value_type* as = a.data;
+       const sequence::value_type* bs = b.data;
+       sequence::size_type i = 0, j = 0, out = 0;
+       sequence::value_type* target = dest.begin_bulk_write(a.used + b.used);
+       while (i < a.used && j < b.used) {
+           if(as[i] < bs[j]) {
+               sequence::size_type run_end = gallop(as, i, a.used, bs[j]);
+               out = copy_run(as, i, run_end, target, out);
+               i = run_end;
+           } else if(bs[j] < as[i]) {
+               sequence::size_type run_end = gallop(bs, j, b.used, as[i]);
+               out = copy_run(bs, j, run_end, target, out);
+               j = run_end;
+           } else {
+               target[out++] = as[i];
+               ++i;
+               ++j;
+           }
+       }
+       out = copy_run(as, i, a.used, target, out);
+       out = copy_run(bs, j, b.used, target, out);
+       dest.end_bulk_write(out);
+   }
+
+   void sorted_intersection(const sequence& a, const sequence& b,
+                            sequence& dest)
+   {
+       if(&dest == &a || &dest == &b) {
+           sequence temp;
+           sorted_intersection(a, b, temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       a.pack();
+       b.pack();
+       const sequence::value_type* as = a.data;
+       const sequence::value_type* bs = b.data;
+       sequence::size_type i = 0, j = 0, out = 0;
+       sequence::value_type* target = dest.begin_bulk_write(
+               (a.used < b.used) ? a.used : b.used);
+       while (i < a.used && j < b.used) {
+           if(as[i] < bs[j]) {
+               i = gallop(as, i, a.used, bs[j]);
+           } else if(bs[j] < as[i]) {
+               j = gallop(bs, j, b.used, as[i]);
+           } else {
+               target[out++] = as[i];
+               ++i;
+               ++j;
+           }
+       }
+       dest.end_bulk_write(out);
+   }
+
+   void sorted_difference(const sequence& a, const sequence& b,
+                          sequence& dest)
+   {
+       if(&dest == &a || &dest == &b) {
+           sequence temp;
+           sorted_difference(a, b, temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       a.pack();
+       b.pack();
+       const sequence::value_type* as = a.data;
+       const sequence::value_type* bs = b.data;
+       sequence::size_type i = 0, j = 0, out = 0;
+       sequence::value_type* target = dest.begin_bulk_write(a.used);
+       while (i < a.used && j < b.used) {
+           if(as[i] < bs[j]) {
+               sequence::size_type run_end = gallop(as, i, a.used, bs[j]);
+               out = copy_run(as, i, run_end, target, out);
+               i = run_end;
+           } else if(bs[j] < as[i]) {
+               j = gallop(bs, j, b.used, as[i]);
+           } else {
+               ++i;
+               ++j;
+           }
+       }
+       out = copy_run(as, i, a.used, target, out);
+       dest.end_bulk_write(out);
+   }
+
+   void sorted_symmetric_difference(const sequence& a, const sequence& b,
+                                    sequence& dest)
+   {
+       if(&dest == &a || &dest == &b) {
+           sequence temp;
+           sorted_symmetric_difference(a, b, temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       a.pack();
+       b.pack();
+       const sequence::value_type* as = a.data;
+       const sequence::value_type* bs = b.data;
+       sequence::size_type i = 0, j = 0, out = 0;
+       sequence::value_type* target = dest.begin_bulk_write(a.used + b.used);
+       while (i < a.used && j < b.used) {
+           if(as[i] < bs[j]) {
+               sequence::size_type run_end = gallop(as, i, a.used, bs[j]);
+               out = copy_run(as, i, run_end, target, out);
+               i = run_end;
+           } else if(bs[j] < as[i]) {
+               sequence::size_type run_end = gallop(bs, j, b.used, as[i]);
+               out = copy_run(bs, j, run_end, target, out);
+               j = run_end;
+           } else {
+               ++i;
+               ++j;
+           }
+       }
+       out = copy_run(as, i, a.used, target, out);
+       out = copy_run(bs, j, b.used, target, out);
+       dest.end_bulk_write(out);
+   }
+}
@@ -0,0 +1,67 @@
+// FILE: SequenceSorted.h
+// FUNCTIONS PROVIDED: operations on sorted sequences
+//   (part of the namespace CS3358_FA2017)
+//
+// A sequence is sorted when its items are in increasing order from the
+// first item to the last (equal items may be next to each other). The
+// functions below take sorted sequences and make use of the order, so
+// they never need to sort anything themselves. Each of them writes its
+// result into a destination sequence whose array is allocated (at most)
+// once, for the largest result possible, and filled in one pass.
+//
+// MERGING:
+//   void merge_sorted(const sequence* const inputs[],
+//                     sequence::size_type input_count, sequence& dest)
+//    Pre:  inputs[0] through inputs[input_count-1] point to sorted
+//      sequences.
+//    Post: dest holds every item of every input, sorted. Equal items keep
+//      the order of their inputs (those from inputs[0] first, and so on).
+//      dest's first item (if any) is the current item. dest may be one of
+//      the inputs.
+//    Note: The inputs are merged all at once with a loser tree, so each
+//      item written costs O(log input_count) comparisons, however many
+//      inputs there are.
+//
+// SET OPERATIONS:
+//   void sorted_union(const sequence& a, const sequence& b, sequence& dest)
+//   void sorted_intersection(const sequence& a, const sequence& b,
+//                            sequence& dest)
+//   void sorted_difference(const sequence& a, const sequence& b,
+//                          sequence& dest)
+//   void sorted_symmetric_difference(const sequence& a, const sequence& b,
+//                                    sequence& dest)
+//    Pre:  a and b are sorted.
+//    Post: dest holds, sorted, the items that are in a or b (union), in
+//      both a and b (intersection), in a but not in b (difference), or in
+//      exactly one of a and b (symmetric difference). An item that occurs
+//      m times in a and n times in b occurs max(m, n), min(m, n),
+//      max(m - n, 0) or |m - n| times in dest respectively, just as with
+//      the set algorithms of the standard library. dest's first item (if
+//      any) is the current item. dest may be a or b.
+//    Note: Runs of items that are all smaller than the other sequence's
+//      next item are found with a galloping (exponential) search and then
+//      skipped or copied as a block. So when one sequence is much smaller
+//      than the other, an intersection (or a difference where b is the
+//      larger one) costs about the size of the smaller one times the log
+//      of the larger one, rather than their total size.
+
+#ifndef SEQUENCE_SORTED_H
+#define SEQUENCE_SORTED_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   // MERGING
+   void merge_sorted(const sequence* const inputs[],
+                     sequence::size_type input_count, sequence& dest);
+   // SET OPERATIONS
+   void sorted_union(const sequence& a, const sequence& b, sequence& dest);
+   void sorted_intersection(const sequence& a, const sequence& b,
+                            sequence& dest);
+   void sorted_difference(const sequence& a, const sequence& b,
+                          sequence& dest);
+   void sorted_symmetric_difference(const sequence& a, const sequence& b,
+                                    sequence& dest);
+}
+
+#endif
@@ -0,0 +1,307 @@
+// FILE: SequenceSparse.cpp
+// CLASS IMPLEMENTED: sparse_sequence (see SequenceSparse.h for
+//   documentation)
+// INVARIANT for the sparse_sequence class:
+//   1. The sparse_sequence has used items. The ones that aren't zero are
+//      stored in positions[0] through positions[entries-1] (where each
+//      is) and values[0] through values[entries-1] (what it is), in
+//      increasing order of position. Every other item is zero.
+//   2. Both arrays have room for capacity entries, and capacity >=
+//      entries.
+//   3. current_index is the position of the current item, or used if
+//      there is no current item. current_entry is the first entry whose
+//      position is current_index or more (entries if there isn't one).
+
+#include <cassert>
+#include "SequenceSparse.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   // CONSTRUCTORS and DESTRUCTOR
+   sparse_sequence::sparse_sequence() : entries(0),
+           capacity(DEFAULT_CAPACITY), used(0), current_index(0),
+           current_entry(0)
+   {
+       positions = new size_type[capacity];
+       values = new value_type[capacity];
+   }
+
+   sparse_sequence::sparse_sequence(const sequence& source) : entries(0),
+           capacity(DEFAULT_CAPACITY), used(0), current_index(0),
+           current_entry(0)
+   {
+       positions = new size_type[capacity];
+       values = new value_type[capacity];
+       sparsify(source);
+   }
+
+   sparse_sequence::sparse_sequence(const sparse_sequence& source) :
+           entries(source.entries), capacity(source.capacity),
+           used(source.used), current_index(source.current_index),
+           current_entry(source.current_entry)
+   {
+       positions = new size_type[capacity];
+       values = new value_type[capacity];
+       for (size_type entry = 0; entry < entries; ++entry) {
+           positions[entry] = source.positions[entry];
+           values[entry] = source.values[entry];
+       }
+   }
+
+   sparse_sequence::~sparse_sequence()
+   {
+       delete [] positions;
+       positions = NULL;
+       delete [] values;
+       values = NULL;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void sparse_sequence::start()
+   {
+       current_index = 0;
+       current_entry = 0;
+   }
+
+   void sparse_sequence::advance()
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       if(at_entry()){++current_entry;}
+       ++current_index;
+   }
+
+   void sparse_sequence::insert(const value_type& entry)
+   {
+       // With no current item, entry goes in front of the first item.
+       if(!is_item()){start();}
+       insert_here(entry);
+   }
+
+   void sparse_sequence::attach(const value_type& entry)
+   {
+       // entry goes after the current item, or at the end if there is
+       // none: either way, just where advance() would take the cursor.
+       if(is_item()){advance();}
+       insert_here(entry);
+   }
+
+   void sparse_sequence::remove_current()
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       // Drop the current item's entry, if it has one. The items after
+       // it move down one place, and the next one becomes current
+       // without moving the cursor.
+       if(at_entry()) {
+           for (size_type entry = current_entry; entry + 1 < entries;
+                ++entry) {
+               positions[entry] = positions[entry + 1];
+               values[entry] = values[entry + 1];
+           }
+           --entries;
+       }
+       for (size_type entry = current_entry; entry < entries; ++entry) {
+           --positions[entry];
+       }
+       --used;
+   }
+
+   void sparse_sequence::sparsify(const sequence& source)
+   {
+       // Count the nonzero items first so the arrays are allocated (at
+       // most) once.
+       source.pack();
+       const value_type* items = source.data;
+       size_type nonzero = 0;
+       for (size_type index = 0; index < source.used; ++index) {
+           if(items[index] != 0){++nonzero;}
+       }
+       entries = 0;
+       if(nonzero > capacity){resize(nonzero);}
+
+       for (size_type index = 0; index < source.used; ++index) {
+           if(items[index] != 0) {
+               positions[entries] = index;
+               values[entries] = items[index];
+               ++entries;
+           }
+       }
+       used = source.used;
+       current_index = used;
+       current_entry = entries;
+   }
+
+   sparse_sequence& sparse_sequence::operator=(
+           const sparse_sequence& source)
+   {
+       // Self-assignment fail safe.
+       if (this == &source)
+           return *this;
+
+       size_type* temp_positions = new size_type[source.capacity];
+       value_type* temp_values = new value_type[source.capacity];
+       for (size_type entry = 0; entry < source.entries; ++entry) {
+           temp_positions[entry] = source.positions[entry];
+           temp_values[entry] = source.values[entry];
+       }
+       delete [] positions;
+       delete [] values;
+
+       positions = temp_positions;
+       values = temp_values;
+       entries = source.entries;
+       capacity = source.capacity;
+       used = source.used;
+       current_index = source.current_index;
+       current_entry = source.current_entry;
+
+       return *this;
+   }
+
+   // CONSTANT MEMBER FUNCTIONS
+   sparse_sequence::size_type sparse_sequence::size() const
+   {
+       return used;
+   }
+
+   bool sparse_sequence::is_item() const
+   {
+       return (current_index != used);
+   }
+
+   sparse_sequence::value_type sparse_sequence::current() const
+   {
+       // Protect pre-condition.
+       assert(is_item());
+
+       return at_entry() ? values[current_entry] : 0;
+   }
+
+   sparse_sequence::size_type sparse_sequence::nonzero_count() const
+   {
+       return entries;
+   }
+
+   sparse_sequence::value_type sparse_sequence::sum() const
+   {
+       value_type sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+       size_type entry = 0;
+       for ( ; entry + 4 <= entries; entry += 4) {
+           sum0 += values[entry];
+           sum1 += values[entry+1];
+           sum2 += values[entry+2];
+           sum3 += values[entry+3];
+       }
+       for ( ; entry < entries; ++entry) {
+           sum0 += values[entry];
+       }
+       return (sum0 + sum1) + (sum2 + sum3);
+   }
+
+   sparse_sequence::value_type sparse_sequence::dot(
+           const sequence& other) const
+   {
+       other.pack();
+
+       // Protect pre-condition.
+       assert(other.used == used);
+
+       // Gather the items of other at the nonzero positions.
+       const value_type* items = other.data;
+       value_type sum0 = 0, sum1 = 0;
+       size_type entry = 0;
+       for ( ; entry + 2 <= entries; entry += 2) {
+           sum0 += values[entry] * items[positions[entry]];
+           sum1 += values[entry+1] * items[positions[entry+1]];
+       }
+       if(entry < entries) {
+           sum0 += values[entry] * items[positions[entry]];
+       }
+       return sum0 + sum1;
+   }
+
+   sparse_sequence::value_type sparse_sequence::dot(
+           const sparse_sequence& other) const
+   {
+       // Protect pre-condition.
+       assert(other.used == used);
+
+       // Walk both entry lists like a merge; only positions both have
+       // contribute.
+       value_type total = 0;
+       size_type i = 0, j = 0;
+       while (i < entries && j < other.entries) {
+           if(positions[i] < other.positions[j]){++i;}
+           else if(other.positions[j] < positions[i]){++j;}
+           else {
+               total += values[i] * other.values[j];
+               ++i;
+               ++j;
+           }
+       }
+       return total;
+   }
+
+   void sparse_sequence::densify(sequence& dest) const
+   {
+       sequence::value_type* target = dest.begin_bulk_write(used);
+       for (size_type index = 0; index < used; ++index) {
+           target[index] = 0;
+       }
+       for (size_type entry = 0; entry < entries; ++entry) {
+           target[positions[entry]] = values[entry];
+       }
+       dest.end_bulk_write(used);
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   bool sparse_sequence::at_entry() const
+   {
+       // True if the current item is a nonzero one (see invariant #3).
+       return current_entry < entries &&
+              positions[current_entry] == current_index;
+   }
+
+   void sparse_sequence::insert_here(const value_type& entry)
+   {
+       // Insert entry at position current_index (used for the end),
+       // moving the items from there on up one place, and make it the
+       // current item.
+       for (size_type index = current_entry; index < entries; ++index) {
+           ++positions[index];
+       }
+       if(entry != 0) {
+           if(entries == capacity) {
+               resize(size_type(1.25 * capacity) + 1);
+           }
+           for (size_type index = entries; index > current_entry; --index) {
+               positions[index] = positions[index - 1];
+               values[index] = values[index - 1];
+           }
+           positions[current_entry] = current_index;
+           values[current_entry] = entry;
+           ++entries;
+       }
+       ++used;
+   }
+
+   void sparse_sequence::resize(size_type new_capacity)
+   {
+       capacity = new_capacity;
+       size_type* temp_positions = new size_type[capacity];
+       value_type* temp_values = new value_type[capacity];
+       for (size_type entry = 0; entry < entries; ++entry) {
+           temp_positions[entry] = positions[entry];
+           temp_values[entry] = values[entry];
+       }
+       delete [] positions;
+       delete [] values;
+       positions = temp_positions;
+       values = temp_values;
+   }
+}
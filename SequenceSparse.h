@@ -0,0 +1,126 @@
+// FILE: SequenceSparse.h
+// CLASS PROVIDED: sparse_sequence (part of the namespace CS3358_FA2017)
+//
+// A sparse_sequence holds the same kind of items as a sequence, and has
+// the same cursor functions, but only stores the items that aren't zero:
+// each one with its position, in increasing order of position. For data
+// that is mostly zeros this takes a fraction of the memory, and sums and
+// dot products only visit the nonzero items. (-0.0 equals 0, so it's
+// stored as zero too, and reads back as 0.0.)
+//
+// Inserting or removing an item shifts the positions of the nonzero
+// items after it, so it costs time in proportion to the number of those,
+// not the number of items.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the sparse_sequence class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+//   static const size_type DEFAULT_CAPACITY = _____
+//    The number of nonzero items a sparse_sequence made by the default
+//    constructor has room for.
+//
+// CONSTRUCTORS for the sparse_sequence class:
+//   sparse_sequence()
+//    Post: The sparse_sequence is empty.
+//
+//   sparse_sequence(const sequence& source)
+//    Post: The sparse_sequence holds the items of source, as if by
+//      sparsify(source).
+//
+// MODIFICATION MEMBER FUNCTIONS for the sparse_sequence class:
+//   void start()
+//   void advance()
+//   void insert(const value_type& entry)
+//   void attach(const value_type& entry)
+//   void remove_current()
+//    Pre:  is_item returns true for advance and remove_current.
+//    Post: As for the sequence class.
+//
+//   void sparsify(const sequence& source)
+//    Pre:  none
+//    Post: The sparse_sequence holds the items of source, in place of
+//      whatever it held before, and there is no current item. source is
+//      not changed.
+//
+// CONSTANT MEMBER FUNCTIONS for the sparse_sequence class:
+//   size_type size() const
+//   bool is_item() const
+//   value_type current() const
+//    Pre:  is_item() returns true for current.
+//    Post: As for the sequence class.
+//
+//   size_type nonzero_count() const
+//    Post: The return value is the number of items that aren't zero.
+//
+//   value_type sum() const
+//    Post: The return value is the sum of the items.
+//
+//   value_type dot(const sequence& other) const
+//   value_type dot(const sparse_sequence& other) const
+//    Pre:  other.size() == size()
+//    Post: The return value is the dot product of the items with those of
+//      other. Only positions where this (and, for a sparse_sequence,
+//      other) has a nonzero item are visited.
+//
+//   void densify(sequence& dest) const
+//    Pre:  none
+//    Post: dest holds the items, zeros included, and its first item (if
+//      any) is the current item.
+//
+// VALUE SEMANTICS for the sparse_sequence class:
+//   Assignments and the copy constructor may be used with sparse_sequence
+//   objects.
+
+#ifndef SEQUENCE_SPARSE_H
+#define SEQUENCE_SPARSE_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class sparse_sequence
+   {
+   public:
+      // TYPEDEFS and MEMBER CONSTANTS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      static const size_type DEFAULT_CAPACITY = 30;
+      // CONSTRUCTORS and DESTRUCTOR
+      sparse_sequence();
+      sparse_sequence(const sequence& source);
+      sparse_sequence(const sparse_sequence& source);
+      ~sparse_sequence();
+      // MODIFICATION MEMBER FUNCTIONS
+      void start();
+      void advance();
+      void insert(const value_type& entry);
+      void attach(const value_type& entry);
+      void remove_current();
+      void sparsify(const sequence& source);
+      sparse_sequence& operator=(const sparse_sequence& source);
+      // CONSTANT MEMBER FUNCTIONS
+      size_type size() const;
+      bool is_item() const;
+      value_type current() const;
+      size_type nonzero_count() const;
+      value_type sum() const;
+      value_type dot(const sequence& other) const;
+      value_type dot(const sparse_sequence& other) const;
+      void densify(sequence& dest) const;
+   private:
+      size_type* positions;   // position of each nonzero item
+      value_type* values;     // and its value
+      size_type entries;      // nonzero items stored
+      size_type capacity;     // nonzero items the arrays have room for
+      size_type used;         // items, zeros included
+      size_type current_index;
+      size_type current_entry;
+      // HELPER MEMBER FUNCTIONS
+      bool at_entry() const;
+      void insert_here(const value_type& entry);
+      void resize(size_type new_capacity);
+   };
+}
+
+#endif
@@ -0,0 +1,543 @@
+// FILE: SequenceStats.cpp
+// CLASSES IMPLEMENTED: histogram, tdigest (see SequenceStats.h for
+//   documentation)
+// FUNCTIONS IMPLEMENTED: exact_quantile, top_k, bottom_k, nth
+//
+// INVARIANT for the histogram class:
+//   1. The buckets split [low, high) into buckets equal parts. Their
+//      counts are in the dynamic array counts[0] through
+//      counts[buckets-1], and scale is buckets / (high - low), so the
+//      bucket of an item x in range is (x - low) * scale.
+//   2. below and above count the items less than low and not less than
+//      high, and total is the number of items counted altogether.
+//
+// INVARIANT for the tdigest class:
+//   1. items is a dynamic array of capacity centroids. items[0] through
+//      items[merged-1] are the merged centroids, sorted by mean, each
+//      within the size limit set by the compression delta.
+//      items[merged] through items[merged+buffered-1] are items (or
+//      centroids of another digest) that have been added but not yet
+//      merged. They're merged by compress() when the array fills up, or
+//      before a quantile is computed.
+//   2. total is the number of items added, and smallest and largest are
+//      the smallest and largest of them (meaningless while total is 0).
+//
+// The size limit on centroids uses the scale function
+//      k(q) = delta / Z * log(q / (1 - q)),   Z = 4 log(n / delta) + 24
+// (k2 of Dunning's t-digest paper, for n items in all): a run of
+// neighbouring items may only be merged into one centroid if it spans at
+// most 1 unit of k. k changes fastest near q = 0 and q = 1, which keeps
+// the centroids in the tails small (the outermost ones are single
+// items). Between q = 1/n and q = 1 - 1/n, k runs over about delta/2
+// units, and each pair of neighbouring centroids covers at least one
+// unit, so there are about delta merged centroids at most.
+
+#include <cassert>
+#include <cmath>       // provides log, exp, floor and HUGE_VAL
+#include <algorithm>   // provides sort, nth_element and the heap functions
+#include <functional>  // provides less and greater
+#include "SequenceStats.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      // Order for sorting centroids by mean.
+      bool mean_less(const tdigest::centroid& lhs,
+                     const tdigest::centroid& rhs)
+      {
+          return lhs.mean < rhs.mean;
+      }
+
+      // The scale function and its inverse. normalizer depends on the
+      // total weight n being compressed: 4 log(n / delta) + 24.
+      double scale_k(double q, double delta, double normalizer)
+      {
+          if(q <= 0){return -HUGE_VAL;}
+          if(q >= 1){return HUGE_VAL;}
+          return delta / normalizer * log(q / (1 - q));
+      }
+
+      double scale_q(double k, double delta, double normalizer)
+      {
+          return 1 / (1 + exp(-k * normalizer / delta));
+      }
+
+      // Write the k items of items[0..count-1] that come first in the
+      // order before (the largest for greater, the smallest for less) to
+      // target[0..k-1], sorted by before. Pre: k <= count.
+      template <class Compare>
+      void select_best(const sequence::value_type* items,
+                       sequence::size_type count, sequence::size_type k,
+                       sequence::value_type* target, Compare before)
+      {
+          if(k == 0){return;}
+
+          if(k < count / 8) {
+              // Few items wanted: keep the best k seen so far in a heap
+              // whose top is the worst of them, and replace it whenever a
+              // better item comes along.
+              for (sequence::size_type index = 0; index < k; ++index) {
+                  target[index] = items[index];
+              }
+              make_heap(target, target + k, before);
+              for (sequence::size_type index = k; index < count; ++index) {
+                  if(before(items[index], target[0])) {
+                      pop_heap(target, target + k, before);
+                      target[k-1] = items[index];
+                      push_heap(target, target + k, before);
+                  }
+              }
+              sort_heap(target, target + k, before);
+              return;
+          }
+
+          // Many items wanted: partition a copy so the best k come first,
+          // then sort just those.
+          sequence::value_type* copy = new sequence::value_type[count];
+          for (sequence::size_type index = 0; index < count; ++index) {
+              copy[index] = items[index];
+          }
+          nth_element(copy, copy + (k - 1), copy + count, before);
+          sort(copy, copy + k, before);
+          for (sequence::size_type index = 0; index < k; ++index) {
+              target[index] = copy[index];
+          }
+          delete [] copy;
+      }
+   }
+
+   // HISTOGRAM: CONSTRUCTORS and DESTRUCTOR
+   histogram::histogram(value_type low_value, value_type high_value,
+                        size_type bucket_count) :
+           low(low_value), high(high_value), buckets(bucket_count),
+           below(0), above(0), total(0)
+   {
+       // Protect pre-condition.
+       assert(low < high);
+       assert(buckets > 0);
+
+       scale = buckets / (high - low);
+       counts = new size_type[buckets];
+       for (size_type index = 0; index < buckets; ++index) {
+           counts[index] = 0;
+       }
+   }
+
+   histogram::histogram(const histogram& source) :
+           low(source.low), high(source.high), scale(source.scale),
+           buckets(source.buckets), below(source.below),
+           above(source.above), total(source.total)
+   {
+       counts = new size_type[buckets];
+       for (size_type index = 0; index < buckets; ++index) {
+           counts[index] = source.counts[index];
+       }
+   }
+
+   histogram::~histogram()
+   {
+       delete [] counts;
+       counts = NULL;
+   }
+
+   // HISTOGRAM: MODIFICATION MEMBER FUNCTIONS
+   void histogram::add(const value_type& entry)
+   {
+       // The comparisons below are all false for NaN, so check it first.
+       if(entry != entry){return;}
+
+       ++total;
+       if(entry < low){++below; return;}
+       if(entry >= high){++above; return;}
+
+       // Rounding in the multiplication can land an item just below high
+       // at index buckets, so clamp it into the last bucket.
+       size_type index = size_type((entry - low) * scale);
+       if(index >= buckets){index = buckets - 1;}
+       ++counts[index];
+   }
+
+   void histogram::add(const sequence& source)
+   {
+       source.pack();
+       const value_type* entries = source.data;
+       for (size_type index = 0; index < source.used; ++index) {
+           add(entries[index]);
+       }
+   }
+
+   void histogram::merge(const histogram& other)
+   {
+       // Protect pre-condition.
+       assert(low == other.low && high == other.high);
+       assert(buckets == other.buckets);
+
+       for (size_type index = 0; index < buckets; ++index) {
+           counts[index] += other.counts[index];
+       }
+       below += other.below;
+       above += other.above;
+       total += other.total;
+   }
+
+   histogram& histogram::operator=(const histogram& source)
+   {
+       if (this == &source)
+           return *this;
+
+       size_type* temp_counts = new size_type[source.buckets];
+       for (size_type index = 0; index < source.buckets; ++index) {
+           temp_counts[index] = source.counts[index];
+       }
+       delete [] counts;
+
+       counts = temp_counts;
+       low = source.low;
+       high = source.high;
+       scale = source.scale;
+       buckets = source.buckets;
+       below = source.below;
+       above = source.above;
+       total = source.total;
+       return *this;
+   }
+
+   // HISTOGRAM: CONSTANT MEMBER FUNCTIONS
+   histogram::size_type histogram::count() const
+   {
+       return total;
+   }
+
+   histogram::size_type histogram::bucket_count() const
+   {
+       return buckets;
+   }
+
+   histogram::size_type histogram::bucket(size_type index) const
+   {
+       // Protect pre-condition.
+       assert(index < buckets);
+
+       return counts[index];
+   }
+
+   histogram::size_type histogram::underflow() const
+   {
+       return below;
+   }
+
+   histogram::size_type histogram::overflow() const
+   {
+       return above;
+   }
+
+   histogram::value_type histogram::quantile(double q) const
+   {
+       // Protect pre-condition.
+       assert(q >= 0 && q <= 1);
+       assert(total > 0);
+
+       // rank is how many items lie below the answer. It's only low if
+       // some item really was below the range (otherwise q = 0 is the
+       // start of the first bucket that has any items).
+       double rank = q * total;
+       if(below > 0 && rank <= below){return low;}
+
+       double seen = below;
+       value_type width = (high - low) / buckets;
+       for (size_type index = 0; index < buckets; ++index) {
+           if(counts[index] > 0 && seen + counts[index] >= rank) {
+               // Assume the bucket's items are spread evenly across it.
+               double fraction = (rank - seen) / counts[index];
+               return low + (index + fraction) * width;
+           }
+           seen += counts[index];
+       }
+       return high;
+   }
+
+   // TDIGEST: MEMBER CONSTANTS
+   const double tdigest::DEFAULT_COMPRESSION = 100;
+
+   // TDIGEST: CONSTRUCTORS and DESTRUCTOR
+   tdigest::tdigest(double compression) :
+           delta(compression), merged(0), buffered(0), total(0),
+           smallest(0), largest(0)
+   {
+       if(delta < 10){delta = 10;}
+
+       // Room for the most merged centroids there can be (see above) plus
+       // a buffer several times as large, so compress() runs rarely.
+       capacity = size_type(delta) + 1 + 5 * size_type(delta);
+       items = new centroid[capacity];
+   }
+
+   tdigest::tdigest(const tdigest& source) :
+           delta(source.delta), capacity(source.capacity),
+           merged(source.merged), buffered(source.buffered),
+           total(source.total), smallest(source.smallest),
+           largest(source.largest)
+   {
+       items = new centroid[capacity];
+       for (size_type index = 0; index < merged + buffered; ++index) {
+           items[index] = source.items[index];
+       }
+   }
+
+   tdigest::~tdigest()
+   {
+       delete [] items;
+       items = NULL;
+   }
+
+   // TDIGEST: MODIFICATION MEMBER FUNCTIONS
+   void tdigest::add(const value_type& entry)
+   {
+       if(entry != entry){return;}   // ignore NaN
+
+       if(total == 0 || entry < smallest){smallest = entry;}
+       if(total == 0 || entry > largest){largest = entry;}
+       ++total;
+       add_weighted(entry, 1);
+   }
+
+   void tdigest::add(const sequence& source)
+   {
+       source.pack();
+       const value_type* entries = source.data;
+       for (size_type index = 0; index < source.used; ++index) {
+           add(entries[index]);
+       }
+   }
+
+   void tdigest::merge(const tdigest& other)
+   {
+       if(other.total == 0){return;}
+
+       if(total == 0 || other.smallest < smallest){smallest = other.smallest;}
+       if(total == 0 || other.largest > largest){largest = other.largest;}
+       total += other.total;
+
+       // Other's merged centroids and buffered items are all just
+       // weighted points to this digest.
+       for (size_type index = 0; index < other.merged + other.buffered;
+            ++index) {
+           add_weighted(other.items[index].mean, other.items[index].weight);
+       }
+   }
+
+   tdigest& tdigest::operator=(const tdigest& source)
+   {
+       if (this == &source)
+           return *this;
+
+       centroid* temp_items = new centroid[source.capacity];
+       for (size_type index = 0; index < source.merged + source.buffered;
+            ++index) {
+           temp_items[index] = source.items[index];
+       }
+       delete [] items;
+
+       items = temp_items;
+       delta = source.delta;
+       capacity = source.capacity;
+       merged = source.merged;
+       buffered = source.buffered;
+       total = source.total;
+       smallest = source.smallest;
+       largest = source.largest;
+       return *this;
+   }
+
+   // TDIGEST: CONSTANT MEMBER FUNCTIONS
+   tdigest::size_type tdigest::count() const
+   {
+       return total;
+   }
+
+   tdigest::size_type tdigest::centroid_count() const
+   {
+       compress();
+       return merged;
+   }
+
+   tdigest::value_type tdigest::quantile(double q) const
+   {
+       // Protect pre-condition.
+       assert(q >= 0 && q <= 1);
+       assert(total > 0);
+
+       compress();
+
+       // Each centroid's mean is taken to sit at the middle of its
+       // weight; rank is interpolated between neighbouring middles, and
+       // between the outermost middles and the smallest/largest items
+       // (so a single centroid still spans them).
+       double rank = q * total;
+       double first_half = items[0].weight / 2;
+       if(rank < first_half) {
+           return smallest + (items[0].mean - smallest) * (rank / first_half);
+       }
+
+       double middle = first_half;
+       for (size_type index = 0; index + 1 < merged; ++index) {
+           double gap = (items[index].weight + items[index+1].weight) / 2;
+           if(rank < middle + gap) {
+               double fraction = (rank - middle) / gap;
+               return items[index].mean +
+                      fraction * (items[index+1].mean - items[index].mean);
+           }
+           middle += gap;
+       }
+
+       double last_half = items[merged-1].weight / 2;
+       double fraction = (rank - middle) / last_half;
+       if(fraction > 1){fraction = 1;}
+       return items[merged-1].mean +
+              fraction * (largest - items[merged-1].mean);
+   }
+
+   // TDIGEST: HELPER MEMBER FUNCTIONS
+   void tdigest::add_weighted(value_type mean, value_type weight)
+   {
+       if(merged + buffered == capacity){compress();}
+       assert(merged < capacity);
+
+       items[merged + buffered].mean = mean;
+       items[merged + buffered].weight = weight;
+       ++buffered;
+   }
+
+   void tdigest::compress() const
+   {
+       if(buffered == 0){return;}
+
+       // Sort the merged centroids and buffered items together, then sweep
+       // them front to back, folding each one into the centroid being
+       // built as long as that stays within the size limit (invariant
+       // #1). The output index never passes the input index, so this is
+       // done in place.
+       size_type count = merged + buffered;
+       sort(items, items + count, mean_less);
+
+       double weight_total = 0;
+       for (size_type index = 0; index < count; ++index) {
+           weight_total += items[index].weight;
+       }
+
+       size_type out = 0;
+       double weight_before = 0;   // weight of the finished centroids
+       double normalizer = 4 * log(weight_total / delta) + 24;
+       if(normalizer < 24){normalizer = 24;}
+       double limit = 0;   // the first centroid is always a single item
+       for (size_type index = 1; index < count; ++index) {
+           double joined = items[out].weight + items[index].weight;
+           if(weight_before + joined <= limit) {
+               items[out].mean += (items[index].mean - items[out].mean) *
+                                  items[index].weight / joined;
+               items[out].weight = joined;
+           } else {
+               weight_before += items[out].weight;
+               limit = weight_total * scale_q(
+                       scale_k(weight_before / weight_total, delta,
+                               normalizer) + 1, delta, normalizer);
+               ++out;
+               items[out] = items[index];
+           }
+       }
+
+       merged = out + 1;
+       buffered = 0;
+   }
+
+   // FUNCTIONS
+   sequence::value_type exact_quantile(const sequence& source, double q)
+   {
+       source.pack();
+
+       // Protect pre-condition.
+       assert(q >= 0 && q <= 1);
+       assert(source.used > 0);
+
+       // Work on a copy so source keeps its order.
+       sequence::size_type count = source.used;
+       sequence::value_type* copy = new sequence::value_type[count];
+       for (sequence::size_type index = 0; index < count; ++index) {
+           copy[index] = source.data[index];
+       }
+
+       double position = q * (count - 1);
+       sequence::size_type lower = sequence::size_type(floor(position));
+       double fraction = position - lower;
+
+       // nth_element puts x[lower] in place with every larger item after
+       // it, so x[lower+1] is the smallest of those.
+       nth_element(copy, copy + lower, copy + count);
+       sequence::value_type answer = copy[lower];
+       if(fraction > 0 && lower + 1 < count) {
+           sequence::value_type next = *min_element(copy + lower + 1,
+                                                    copy + count);
+           answer += fraction * (next - answer);
+       }
+
+       delete [] copy;
+       return answer;
+   }
+
+   void top_k(const sequence& source, sequence::size_type k, sequence& dest)
+   {
+       source.pack();
+       if(k > source.used){k = source.used;}
+
+       // dest's array is written while source's is still being read.
+       if(&source == &dest) {
+           sequence temp(k);
+           top_k(source, k, temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       sequence::value_type* target = dest.begin_bulk_write(k);
+       select_best(source.data, source.used, k, target,
+                   greater<sequence::value_type>());
+       dest.end_bulk_write(k);
+   }
+
+   void bottom_k(const sequence& source, sequence::size_type k,
+                 sequence& dest)
+   {
+       source.pack();
+       if(k > source.used){k = source.used;}
+       if(&source == &dest) {
+           sequence temp(k);
+           bottom_k(source, k, temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       sequence::value_type* target = dest.begin_bulk_write(k);
+       select_best(source.data, source.used, k, target,
+                   less<sequence::value_type>());
+       dest.end_bulk_write(k);
+   }
+
+   sequence::value_type nth(const sequence& source, sequence::size_type k)
+   {
+       source.pack();
+
+       // Protect pre-condition.
+       assert(k < source.used);
+
+       sequence::value_type* copy = new sequence::value_type[source.used];
+       for (sequence::size_type index = 0; index < source.used; ++index) {
+           copy[index] = source.data[index];
+       }
+       nth_element(copy, copy + k, copy + source.used);
+       sequence::value_type answer = copy[k];
+       delete [] copy;
+       return answer;
+   }
+}
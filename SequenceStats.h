@@ -0,0 +1,223 @@
+// FILE: SequenceStats.h
+// CLASSES PROVIDED: histogram, tdigest (part of the namespace CS3358_FA2017)
+// FUNCTIONS PROVIDED: exact_quantile, top_k, bottom_k, nth
+//
+// Summaries of the items of a sequence that answer questions like "what
+// is the median" or "what is the 99th percentile" without sorting the
+// sequence. Both classes take in a whole sequence in a single pass over
+// its dynamic array, and two summaries of separate chunks of data can be
+// merged into one summary of all of it, so chunks can be summarized
+// independently and combined afterwards.
+//
+// CLASS histogram: counts of items falling into equal-width buckets.
+//   histogram(value_type low, value_type high, size_type bucket_count)
+//    Pre:  low < high and bucket_count > 0
+//    Post: The histogram is empty, with bucket_count buckets of equal
+//      width splitting the range [low, high).
+//
+//   void add(const value_type& entry)
+//    Pre:  none
+//    Post: entry has been counted in its bucket. Items below low are
+//      counted by underflow() and items at or above high by overflow().
+//      NaN items are ignored.
+//
+//   void add(const sequence& source)
+//    Pre:  none
+//    Post: Every item of source has been added as above.
+//
+//   void merge(const histogram& other)
+//    Pre:  other has the same low, high and bucket_count as this one.
+//    Post: Every count of other has been added to this histogram.
+//
+//   size_type count() const
+//    Post: The return value is the number of items added (not counting
+//      NaN items).
+//
+//   size_type bucket_count() const
+//   size_type bucket(size_type index) const
+//    Pre:  index < bucket_count() for bucket
+//    Post: bucket_count returns the number of buckets. bucket returns how
+//      many items fell into bucket index, which covers the values from
+//      low + index * width up to (but not including) low + (index+1) *
+//      width, where width is (high - low) / bucket_count.
+//
+//   size_type underflow() const
+//   size_type overflow() const
+//    Post: The number of items below low, or at or above high.
+//
+//   value_type quantile(double q) const
+//    Pre:  0 <= q <= 1 and count() > 0
+//    Post: The return value estimates the value below which a fraction
+//      q of the items lie, assuming items are spread evenly within each
+//      bucket. Its error is at most one bucket width when the answer
+//      lies in [low, high). Underflow and overflow items are treated as
+//      if they were equal to low and high.
+//
+// CLASS tdigest: a t-digest, which keeps a small, sorted set of weighted
+//   centroids (each one the mean of a cluster of nearby items). Clusters
+//   near the ends of the distribution are kept small, so the estimate of
+//   an extreme quantile such as 0.99 or 0.001 is far more accurate than
+//   that of the median.
+//   static const double DEFAULT_COMPRESSION = _____
+//    The default compression. Larger values keep more centroids, using
+//    more memory for better accuracy. Memory use is O(compression)
+//    whatever the number of items added.
+//
+//   tdigest(double compression = DEFAULT_COMPRESSION)
+//    Pre:  compression >= 10
+//    Post: The digest is empty.
+//    Note: If Pre is not met, compression will be adjusted to 10.
+//
+//   void add(const value_type& entry)
+//    Pre:  none
+//    Post: entry has been added to the digest (NaN items are ignored).
+//
+//   void add(const sequence& source)
+//    Pre:  none
+//    Post: Every item of source has been added as above.
+//
+//   void merge(const tdigest& other)
+//    Pre:  none
+//    Post: Every item summarized by other has been added to this digest.
+//
+//   size_type count() const
+//    Post: The return value is the number of items added (not counting
+//      NaN items).
+//
+//   size_type centroid_count() const
+//    Post: The return value is the number of centroids the digest keeps
+//      once all added items have been merged into them.
+//
+//   value_type quantile(double q) const
+//    Pre:  0 <= q <= 1 and count() > 0
+//    Post: The return value estimates the value below which a fraction
+//      q of the items lie. quantile(0) and quantile(1) are exactly the
+//      smallest and largest items added.
+//
+// VALUE SEMANTICS for the histogram and tdigest classes:
+//   Assignments and the copy constructor may be used with histogram and
+//   tdigest objects.
+//
+// FUNCTION exact_quantile:
+//   sequence::value_type exact_quantile(const sequence& source, double q)
+//    Pre:  0 <= q <= 1 and source.size() > 0
+//    Post: The return value is the exact q quantile of the items of
+//      source: with n items in sorted order x[0] ... x[n-1], it's
+//      x[k] + f * (x[k+1] - x[k]), where q * (n-1) = k + f. source is
+//      not changed. This takes O(n) time on average but needs a copy of
+//      the items, so it's meant for checking the estimates above.
+//
+// SELECTION FUNCTIONS:
+//   void top_k(const sequence& source, sequence::size_type k,
+//              sequence& dest)
+//   void bottom_k(const sequence& source, sequence::size_type k,
+//                 sequence& dest)
+//    Pre:  none
+//    Post: dest holds the k largest (top_k) or k smallest (bottom_k)
+//      items of source, from most to least extreme, so top_k is in
+//      decreasing and bottom_k in increasing order. If source has fewer
+//      than k items, dest holds all of them. dest's first item (if any)
+//      is the current item. source is not changed, and dest may be
+//      source.
+//    Note: For k much smaller than source.size() the items are run past
+//      a heap of the k best seen so far, O(n log k) with no copy of
+//      source; otherwise source is copied and partitioned in O(n) by
+//      nth_element before the k best are sorted.
+//
+//   sequence::value_type nth(const sequence& source, sequence::size_type k)
+//    Pre:  k < source.size()
+//    Post: The return value is the item that would be item k of source
+//      (counting from 0) if source were sorted in increasing order.
+//      source is not changed. O(n) on average.
+
+#ifndef SEQUENCE_STATS_H
+#define SEQUENCE_STATS_H
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class histogram
+   {
+   public:
+      // TYPEDEFS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      // CONSTRUCTORS and DESTRUCTOR
+      histogram(value_type low, value_type high, size_type bucket_count);
+      histogram(const histogram& source);
+      ~histogram();
+      // MODIFICATION MEMBER FUNCTIONS
+      void add(const value_type& entry);
+      void add(const sequence& source);
+      void merge(const histogram& other);
+      histogram& operator=(const histogram& source);
+      // CONSTANT MEMBER FUNCTIONS
+      size_type count() const;
+      size_type bucket_count() const;
+      size_type bucket(size_type index) const;
+      size_type underflow() const;
+      size_type overflow() const;
+      value_type quantile(double q) const;
+   private:
+      value_type low;
+      value_type high;
+      value_type scale;     // buckets per unit of value
+      size_type* counts;
+      size_type buckets;
+      size_type below;
+      size_type above;
+      size_type total;
+   };
+
+   class tdigest
+   {
+   public:
+      // TYPEDEFS and MEMBER CONSTANTS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      static const double DEFAULT_COMPRESSION;
+      // CONSTRUCTORS and DESTRUCTOR
+      tdigest(double compression = DEFAULT_COMPRESSION);
+      tdigest(const tdigest& source);
+      ~tdigest();
+      // MODIFICATION MEMBER FUNCTIONS
+      void add(const value_type& entry);
+      void add(const sequence& source);
+      void merge(const tdigest& other);
+      tdigest& operator=(const tdigest& source);
+      // CONSTANT MEMBER FUNCTIONS
+      size_type count() const;
+      size_type centroid_count() const;
+      value_type quantile(double q) const;
+      // A weighted cluster of items. Public so the sorting helper in the
+      // implementation file can use it.
+      struct centroid
+      {
+         value_type mean;
+         value_type weight;
+      };
+   private:
+      double delta;
+      centroid* items;
+      size_type capacity;
+      // Merging buffered items into the centroids doesn't change what the
+      // digest summarizes, so const functions may do it: see compress().
+      mutable size_type merged;
+      mutable size_type buffered;
+      size_type total;
+      value_type smallest;
+      value_type largest;
+      // HELPER MEMBER FUNCTIONS
+      void add_weighted(value_type mean, value_type weight);
+      void compress() const;
+   };
+
+   // FUNCTIONS
+   sequence::value_type exact_quantile(const sequence& source, double q);
+   void top_k(const sequence& source, sequence::size_type k, sequence& dest);
+   void bottom_k(const sequence& source, sequence::size_type k,
+                 sequence& dest);
+   sequence::value_type nth(const sequence& source, sequence::size_type k);
+}
+
+#endif
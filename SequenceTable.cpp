@@ -0,0 +1,186 @@
+// FILE: SequenceTable.cpp
+// CLASS IMPLEMENTED: sequence_table (see SequenceTable.h for
+//   documentation)
+// INVARIANT for the sequence_table class:
+//   1. The items of all the rows are stored in items[0] through
+//      items[used-1], row after row; items has room for capacity items.
+//   2. There are rows rows. Row r is items[starts[r]] through
+//      items[starts[r+1]-1], so starts[0] is 0 and starts[rows] is used.
+//      starts has room for row_capacity + 1 entries.
+
+#include <cassert>
+#include "SequenceTable.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   namespace
+   {
+      const sequence_table::size_type INITIAL_CAPACITY = 30;
+   }
+
+   // CONSTRUCTORS and DESTRUCTOR
+   sequence_table::sequence_table() : used(0), capacity(INITIAL_CAPACITY),
+           rows(0), row_capacity(INITIAL_CAPACITY)
+   {
+       items = new value_type[capacity];
+       starts = new size_type[row_capacity + 1];
+       starts[0] = 0;
+   }
+
+   sequence_table::sequence_table(const sequence_table& source) :
+           used(source.used), capacity(source.capacity), rows(source.rows),
+           row_capacity(source.row_capacity)
+   {
+       items = new value_type[capacity];
+       for (size_type index = 0; index < used; ++index) {
+           items[index] = source.items[index];
+       }
+       starts = new size_type[row_capacity + 1];
+       for (size_type row = 0; row <= rows; ++row) {
+           starts[row] = source.starts[row];
+       }
+   }
+
+   sequence_table::~sequence_table()
+   {
+       delete [] items;
+       items = NULL;
+       delete [] starts;
+       starts = NULL;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void sequence_table::reserve(size_type row_total, size_type item_total)
+   {
+       if(row_total > row_capacity){resize_rows(row_total);}
+       if(item_total > capacity){resize_items(item_total);}
+   }
+
+   void sequence_table::append_row()
+   {
+       if(rows == row_capacity) {
+           resize_rows(size_type(1.25 * row_capacity) + 1);
+       }
+       ++rows;
+       starts[rows] = used;
+   }
+
+   void sequence_table::append_row(const sequence& source)
+   {
+       source.pack();
+       append_row();
+       if(used + source.used > capacity) {
+           size_type new_capacity = size_type(1.25 * capacity) + 1;
+           if(new_capacity < used + source.used) {
+               new_capacity = used + source.used;
+           }
+           resize_items(new_capacity);
+       }
+       for (size_type index = 0; index < source.used; ++index) {
+           items[used + index] = source.data[index];
+       }
+       used += source.used;
+       starts[rows] = used;
+   }
+
+   void sequence_table::append(const value_type& entry)
+   {
+       // Protect pre-condition.
+       assert(rows > 0);
+
+       if(used == capacity){resize_items(size_type(1.25 * capacity) + 1);}
+       items[used] = entry;
+       ++used;
+       starts[rows] = used;
+   }
+
+   sequence_table& sequence_table::operator=(const sequence_table& source)
+   {
+       // Self-assignment fail safe.
+       if (this == &source)
+           return *this;
+
+       value_type* temp_items = new value_type[source.capacity];
+       for (size_type index = 0; index < source.used; ++index) {
+           temp_items[index] = source.items[index];
+       }
+       size_type* temp_starts = new size_type[source.row_capacity + 1];
+       for (size_type row = 0; row <= source.rows; ++row) {
+           temp_starts[row] = source.starts[row];
+       }
+       delete [] items;
+       delete [] starts;
+
+       items = temp_items;
+       used = source.used;
+       capacity = source.capacity;
+       starts = temp_starts;
+       rows = source.rows;
+       row_capacity = source.row_capacity;
+
+       return *this;
+   }
+
+   // CONSTANT MEMBER FUNCTIONS
+   sequence_table::size_type sequence_table::row_count() const
+   {
+       return rows;
+   }
+
+   sequence_table::size_type sequence_table::size() const
+   {
+       return used;
+   }
+
+   sequence_table::size_type sequence_table::row_size(size_type row) const
+   {
+       // Protect pre-condition.
+       assert(row < rows);
+
+       return starts[row + 1] - starts[row];
+   }
+
+   sequence_table::value_type sequence_table::item(size_type row,
+                                                   size_type index) const
+   {
+       // Protect pre-condition.
+       assert(row < rows);
+       assert(index < starts[row + 1] - starts[row]);
+
+       return items[starts[row] + index];
+   }
+
+   sequence_view sequence_table::row_view(size_type row) const
+   {
+       // Protect pre-condition.
+       assert(row < rows);
+
+       return sequence_view(items + starts[row],
+                            starts[row + 1] - starts[row]);
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   void sequence_table::resize_items(size_type new_capacity)
+   {
+       capacity = new_capacity;
+       value_type* temp_items = new value_type[capacity];
+       for (size_type index = 0; index < used; ++index) {
+           temp_items[index] = items[index];
+       }
+       delete [] items;
+       items = temp_items;
+   }
+
+   void sequence_table::resize_rows(size_type new_row_capacity)
+   {
+       row_capacity = new_row_capacity;
+       size_type* temp_starts = new size_type[row_capacity + 1];
+       for (size_type row = 0; row <= rows; ++row) {
+           temp_starts[row] = starts[row];
+       }
+       delete [] starts;
+       starts = temp_starts;
+   }
+}
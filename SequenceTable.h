@@ -0,0 +1,111 @@
+// FILE: SequenceTable.h
+// CLASS PROVIDED: sequence_table (part of the namespace CS3358_FA2017)
+//
+// A sequence_table holds many short sequences ("rows") packed into a
+// single dynamic array of items, one row after another, with a second
+// array recording where each row starts (the compressed sparse row, or
+// CSR, layout). A million separate sequence objects would make a million
+// allocations, each with room for DEFAULT_CAPACITY items whatever their
+// size; a table makes two arrays that grow by a quarter when full, and
+// keeps rows next to each other in memory so scanning them in order
+// reads memory front to back.
+//
+// Rows are built at the end of the table: append_row starts a new row
+// and append adds an item to the last row. Rows can't be changed once
+// a later row has been started. Each row can be read through a
+// sequence_view (see SequenceView.h).
+//
+// TYPEDEFS for the sequence_table class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+// CONSTRUCTOR for the sequence_table class:
+//   sequence_table()
+//    Post: The table has no rows.
+//
+// MODIFICATION MEMBER FUNCTIONS for the sequence_table class:
+//   void reserve(size_type row_total, size_type item_total)
+//    Pre:  none
+//    Post: The table has room for at least row_total rows and item_total
+//      items in all, so appending up to that many allocates no memory.
+//
+//   void append_row()
+//    Pre:  none
+//    Post: A new, empty row has been added after the last row.
+//
+//   void append_row(const sequence& source)
+//    Pre:  none
+//    Post: A new row holding the items of source has been added after
+//      the last row. source is not changed.
+//
+//   void append(const value_type& entry)
+//    Pre:  row_count() > 0
+//    Post: entry has been added to the end of the last row.
+//
+// CONSTANT MEMBER FUNCTIONS for the sequence_table class:
+//   size_type row_count() const
+//    Post: The return value is the number of rows.
+//
+//   size_type size() const
+//    Post: The return value is the number of items in all of the rows.
+//
+//   size_type row_size(size_type row) const
+//   value_type item(size_type row, size_type index) const
+//    Pre:  row < row_count(), and index < row_size(row) for item
+//    Post: row_size returns the number of items in the row. item returns
+//      item index (counting from 0) of the row.
+//
+//   sequence_view row_view(size_type row) const
+//    Pre:  row < row_count()
+//    Post: The return value is a view of the items of the row, with no
+//      current item. The view is only valid until the table is next
+//      changed, since appending may move the items.
+//
+// VALUE SEMANTICS for the sequence_table class:
+//   Assignments and the copy constructor may be used with sequence_table
+//   objects.
+
+#ifndef SEQUENCE_TABLE_H
+#define SEQUENCE_TABLE_H
+#include "Sequence.h"
+#include "SequenceView.h"
+
+namespace CS3358_FA2017
+{
+   class sequence_table
+   {
+   public:
+      // TYPEDEFS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      // CONSTRUCTORS and DESTRUCTOR
+      sequence_table();
+      sequence_table(const sequence_table& source);
+      ~sequence_table();
+      // MODIFICATION MEMBER FUNCTIONS
+      void reserve(size_type row_total, size_type item_total);
+      void append_row();
+      void append_row(const sequence& source);
+      void append(const value_type& entry);
+      sequence_table& operator=(const sequence_table& source);
+      // CONSTANT MEMBER FUNCTIONS
+      size_type row_count() const;
+      size_type size() const;
+      size_type row_size(size_type row) const;
+      value_type item(size_type row, size_type index) const;
+      sequence_view row_view(size_type row) const;
+   private:
+      value_type* items;
+      size_type used;
+      size_type capacity;
+      size_type* starts;      // starts[r] is where row r begins
+      size_type rows;
+      size_type row_capacity;
+      // HELPER MEMBER FUNCTIONS
+      void resize_items(size_type new_capacity);
+      void resize_rows(size_type new_row_capacity);
+   };
+}
+
+#endif
@@ -0,0 +1,257 @@
+// FILE: SequenceView.cpp
+// CLASS IMPLEMENTED: sequence_view (see SequenceView.h for documentation)
+// INVARIANT for the sequence_view class:
+//   1. The source items visited by the view are base[0], base[step],
+//      base[2*step], ..., base[(visit_count-1)*step]. step is negative
+//      for a reversed view, in which case base points at the last item
+//      of the source range rather than the first.
+//   2. The filter and map stages are stored in filters[0] through
+//      filters[stage_count-1] and maps[0] through maps[stage_count-1].
+//      Exactly one of filters[i] and maps[i] is non-NULL for each stage,
+//      and the stages are applied to an item in increasing order of i.
+//   3. The cursor is the visit index in the member variable position.
+//      If there is no current item, position equals visit_count (this
+//      mirrors the use of current_index == used in the sequence class).
+//      Otherwise the visited item at position passed every filter
+//      stage, and item holds its value after every map stage.
+
+#include <cassert>
+#include "SequenceView.h"
+
+using namespace std;
+
+namespace CS3358_FA2017
+{
+   // CONSTRUCTORS
+   sequence_view::sequence_view(const sequence& source) :
+           step(1), stage_count(0), item(value_type())
+   {
+       // A view reads the items in place, so any dead slots (see
+       // enable_lazy_remove in Sequence.h) are squeezed out first.
+       source.pack();
+       base = source.data;
+       visit_count = source.used;
+       position = source.used;
+
+       // Clear the stage slots so copies of the view never carry
+       // indeterminate pointers (invariant #2 only covers the used ones).
+       for (size_type index = 0; index < MAX_STAGES; ++index) {
+           filters[index] = NULL;
+           maps[index] = NULL;
+       }
+   }
+
+   sequence_view::sequence_view(const value_type* items, size_type count) :
+           base(items), step(1), visit_count(count), stage_count(0),
+           position(count), item(value_type())
+   {
+       for (size_type index = 0; index < MAX_STAGES; ++index) {
+           filters[index] = NULL;
+           maps[index] = NULL;
+       }
+   }
+
+   // ADAPTER MEMBER FUNCTIONS
+   sequence_view sequence_view::slice(size_type first, size_type last) const
+   {
+       // Protect pre-condition. Slicing is done in visit-index space, which
+       // no longer matches the view's items once a filter has dropped some.
+       assert(first <= last && last <= visit_count);
+       assert(!has_filter());
+
+       // An empty slice keeps base as is, so it never points outside
+       // the source array.
+       sequence_view answer(*this);
+       if(first < last){answer.base = base + ptrdiff_t(first) * step;}
+       answer.visit_count = last - first;
+       answer.position = answer.visit_count;
+       return answer;
+   }
+
+   sequence_view sequence_view::stride(size_type step_size) const
+   {
+       // Protect pre-condition.
+       assert(step_size > 0);
+       assert(!has_filter());
+
+       // Visiting every step_size-th item keeps the first one and rounds
+       // the count up, so a 5-item view with stride 2 visits 0, 2 and 4.
+       sequence_view answer(*this);
+       answer.step = step * ptrdiff_t(step_size);
+       answer.visit_count = (visit_count + step_size - 1) / step_size;
+       answer.position = answer.visit_count;
+       return answer;
+   }
+
+   sequence_view sequence_view::reverse() const
+   {
+       // Protect pre-condition.
+       assert(!has_filter());
+
+       // Point base at the last visited item and walk backwards from it.
+       sequence_view answer(*this);
+       if(visit_count > 0) {
+           answer.base = base + ptrdiff_t(visit_count - 1) * step;
+       }
+       answer.step = -step;
+       answer.position = answer.visit_count;
+       return answer;
+   }
+
+   sequence_view sequence_view::filter(predicate keep) const
+   {
+       // Protect pre-condition.
+       assert(stage_count < MAX_STAGES);
+
+       sequence_view answer(*this);
+       answer.filters[stage_count] = keep;
+       answer.maps[stage_count] = NULL;
+       ++answer.stage_count;
+       answer.position = answer.visit_count;
+       return answer;
+   }
+
+   sequence_view sequence_view::map(transform fn) const
+   {
+       // Protect pre-condition.
+       assert(stage_count < MAX_STAGES);
+
+       sequence_view answer(*this);
+       answer.filters[stage_count] = NULL;
+       answer.maps[stage_count] = fn;
+       ++answer.stage_count;
+       answer.position = answer.visit_count;
+       return answer;
+   }
+
+   // MODIFICATION MEMBER FUNCTIONS
+   void sequence_view::start()
+   {
+       seek_from(0);
+   }
+
+   void sequence_view::advance()
+   {
+       // Protect pre-condition. If false then terminate the program,
+       // otherwise continue execution of sequence_view::advance().
+       assert(is_item());
+
+       seek_from(position + 1);
+   }
+
+   // CONSTANT MEMBER FUNCTIONS
+   sequence_view::size_type sequence_view::span() const
+   {
+       return visit_count;
+   }
+
+   sequence_view::size_type sequence_view::size() const
+   {
+       // Without a filter every visited item is an item of the view.
+       if(!has_filter()){return visit_count;}
+
+       size_type answer = 0;
+       for (size_type index = 0; index < visit_count; ++index) {
+           value_type entry = base[ptrdiff_t(index) * step];
+           if(apply_stages(entry)){++answer;}
+       }
+       return answer;
+   }
+
+   bool sequence_view::is_item() const
+   {
+       // Invariant #3: position == visit_count means no current item.
+       return (position != visit_count);
+   }
+
+   sequence_view::value_type sequence_view::current() const
+   {
+       // Protect pre-condition. If false then terminate the program,
+       // otherwise return the current item of the view.
+       assert(is_item());
+
+       return item;
+   }
+
+   sequence_view::value_type sequence_view::sum() const
+   {
+       value_type answer = value_type();
+
+       // Plain slices and strides need no per-item stage calls, so give
+       // the compiler a simple loop it can unroll.
+       if(stage_count == 0) {
+           for (size_type index = 0; index < visit_count; ++index) {
+               answer += base[ptrdiff_t(index) * step];
+           }
+           return answer;
+       }
+
+       for (size_type index = 0; index < visit_count; ++index) {
+           value_type entry = base[ptrdiff_t(index) * step];
+           if(apply_stages(entry)){answer += entry;}
+       }
+       return answer;
+   }
+
+   void sequence_view::materialize(sequence& dest) const
+   {
+       // Writing a reversed view over its own source would overwrite items
+       // before they're read, so go through a temporary copy instead. A
+       // forward view never reads an item it has already overwritten,
+       // because the write index never passes the read index.
+       if(step < 0 && visit_count > 0 &&
+          base >= dest.data && base < dest.data + dest.capacity) {
+           sequence temp(visit_count);
+           materialize(temp);
+           dest.copy_items(temp);
+           return;
+       }
+
+       // A view never has more items than it visits, so one allocation of
+       // visit_count is always enough.
+       value_type* target = dest.begin_bulk_write(visit_count);
+       size_type written = 0;
+       for (size_type index = 0; index < visit_count; ++index) {
+           value_type entry = base[ptrdiff_t(index) * step];
+           if(apply_stages(entry)) {
+               target[written] = entry;
+               ++written;
+           }
+       }
+       dest.end_bulk_write(written);
+   }
+
+   // HELPER MEMBER FUNCTIONS
+   bool sequence_view::has_filter() const
+   {
+       for (size_type index = 0; index < stage_count; ++index) {
+           if(filters[index] != NULL){return true;}
+       }
+       return false;
+   }
+
+   bool sequence_view::apply_stages(value_type& entry) const
+   {
+       // Run entry through every stage in order (invariant #2). Returns
+       // false as soon as a filter rejects it.
+       for (size_type index = 0; index < stage_count; ++index) {
+           if(filters[index] != NULL) {
+               if(!filters[index](entry)){return false;}
+           } else {
+               entry = maps[index](entry);
+           }
+       }
+       return true;
+   }
+
+   void sequence_view::seek_from(size_type index)
+   {
+       // Move the cursor to the first visited item at or after index that
+       // passes every filter, caching its mapped value per invariant #3.
+       // If there isn't one, position ends up equal to visit_count.
+       for (position = index; position < visit_count; ++position) {
+           item = base[ptrdiff_t(position) * step];
+           if(apply_stages(item)){return;}
+       }
+   }
+}
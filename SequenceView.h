@@ -0,0 +1,167 @@
+// FILE: SequenceView.h
+// CLASS PROVIDED: sequence_view (part of the namespace CS3358_FA2017)
+//
+// A sequence_view is a non-owning, lazily evaluated window onto the
+// items of a sequence. Views never copy or allocate: slice, stride and
+// reverse only change which items of the source are visited, while
+// filter and map are recorded as stages that are applied to each item
+// as the view's cursor reaches it. A view can be turned back into a
+// real sequence with materialize().
+//
+// NOTE: A view refers directly to the source sequence's dynamic array.
+//   Any insert, attach, remove_current, resize or assignment on the
+//   source invalidates every view made from it.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the sequence_view class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//    Same as sequence::value_type and sequence::size_type.
+//
+//   typedef bool (*predicate)(const value_type&)
+//    A function that decides whether an item is kept by filter.
+//
+//   typedef value_type (*transform)(const value_type&)
+//    A function that maps an item to a new value for map.
+//
+//   static const size_type MAX_STAGES = _____
+//    sequence_view::MAX_STAGES is the maximum number of filter and map
+//    stages that may be chained onto one view.
+//
+// CONSTRUCTOR for the sequence_view class:
+//   sequence_view(const sequence& source)
+//    Pre:  none
+//    Post: The view covers every item of source, front to back, with
+//      no filter or map stages. There is no current item until start()
+//      is activated.
+//
+//   A sequence_table (see SequenceTable.h) also makes views of its rows.
+//
+// ADAPTER MEMBER FUNCTIONS for the sequence_view class:
+//   sequence_view slice(size_type first, size_type last) const
+//    Pre:  first <= last <= span(), and no filter stage has been added.
+//    Post: The returned view covers items first through last-1 of this
+//      view (counting the first item as item 0).
+//
+//   sequence_view stride(size_type step_size) const
+//    Pre:  step_size > 0, and no filter stage has been added.
+//    Post: The returned view covers items 0, step_size, 2*step_size,
+//      ... of this view.
+//
+//   sequence_view reverse() const
+//    Pre:  no filter stage has been added.
+//    Post: The returned view covers the items of this view back to front.
+//
+//   sequence_view filter(predicate keep) const
+//    Pre:  fewer than MAX_STAGES stages have been added.
+//    Post: The returned view skips every item for which keep returns
+//      false (after any earlier map stages have been applied).
+//
+//   sequence_view map(transform fn) const
+//    Pre:  fewer than MAX_STAGES stages have been added.
+//    Post: Every item of the returned view is fn applied to the
+//      corresponding item of this view.
+//
+// MODIFICATION MEMBER FUNCTIONS for the sequence_view class:
+//   void start()
+//    Pre:  none
+//    Post: The first item of the view becomes the current item (but if
+//      the view has no items, then there is no current item).
+//
+//   void advance()
+//    Pre:  is_item returns true.
+//    Post: The next item of the view (if there is one) becomes the
+//      current item; otherwise there is no longer any current item.
+//
+// CONSTANT MEMBER FUNCTIONS for the sequence_view class:
+//   size_type span() const
+//    Pre:  none
+//    Post: The return value is the number of source items the view
+//      visits, before any filter stage is applied. O(1).
+//
+//   size_type size() const
+//    Pre:  none
+//    Post: The return value is the number of items in the view. This
+//      is span() when there is no filter stage; otherwise every visited
+//      item has to be run through the stages, O(span()).
+//
+//   bool is_item() const
+//    Pre:  none
+//    Post: A true return value indicates that there is a valid current
+//      item in the view.
+//
+//   value_type current() const
+//    Pre:  is_item() returns true.
+//    Post: The item returned is the current item of the view.
+//
+//   value_type sum() const
+//    Pre:  none
+//    Post: The return value is the sum of all items of the view,
+//      computed in one pass without allocating.
+//
+//   void materialize(sequence& dest) const
+//    Pre:  none
+//    Post: dest holds the items of the view, in view order, and its
+//      first item (if any) is the current item. dest's buffer is grown
+//      at most once, and the items are written in one pass. dest may
+//      be the source of this view (a reversed view is then written
+//      through a temporary copy).
+//
+// VALUE SEMANTICS for the sequence_view class:
+//   Assignments and the copy constructor may be used with sequence_view
+//   objects. Copies refer to the same source sequence.
+
+#ifndef SEQUENCE_VIEW_H
+#define SEQUENCE_VIEW_H
+#include <cstddef>      // provides ptrdiff_t
+#include "Sequence.h"
+
+namespace CS3358_FA2017
+{
+   class sequence_view
+   {
+   public:
+      // TYPEDEFS and MEMBER CONSTANTS
+      typedef sequence::value_type value_type;
+      typedef sequence::size_type size_type;
+      typedef bool (*predicate)(const value_type&);
+      typedef value_type (*transform)(const value_type&);
+      static const size_type MAX_STAGES = 8;
+      // CONSTRUCTOR
+      sequence_view(const sequence& source);
+      // ADAPTER MEMBER FUNCTIONS
+      sequence_view slice(size_type first, size_type last) const;
+      sequence_view stride(size_type step_size) const;
+      sequence_view reverse() const;
+      sequence_view filter(predicate keep) const;
+      sequence_view map(transform fn) const;
+      // MODIFICATION MEMBER FUNCTIONS
+      void start();
+      void advance();
+      // CONSTANT MEMBER FUNCTIONS
+      size_type span() const;
+      size_type size() const;
+      bool is_item() const;
+      value_type current() const;
+      value_type sum() const;
+      void materialize(sequence& dest) const;
+   private:
+      const value_type* base;
+      std::ptrdiff_t step;
+      size_type visit_count;
+      size_type stage_count;
+      predicate filters[MAX_STAGES];
+      transform maps[MAX_STAGES];
+      size_type position;
+      value_type item;
+      // Views of part of another array, for friends that store items
+      // outside a sequence.
+      sequence_view(const value_type* items, size_type count);
+      friend class sequence_table;
+      // HELPER MEMBER FUNCTIONS
+      bool has_filter() const;
+      bool apply_stages(value_type& entry) const;
+      void seek_from(size_type index);
+   };
+}
+
+#endif